@@ -0,0 +1,1066 @@
+/** Iterator Adaptors
+ *  =================
+ *  Lazy, composable views over anything iterable -- containers, bare arrays,
+ *  `nonstd::range`s, and other views. None of them allocate; each element is
+ *  produced as it's reached.
+ *
+ *      using namespace nonstd;
+ *      for (auto x : range(100) | filter(is_prime) | map(square) | take(5)) {
+ *          ...
+ *      }
+ *      for (auto [name, score] : zip(names, scores)) { ... }
+ *      for (auto row : chunk(pixels, width)) { ... }
+ *
+ *  Every adaptor can be called directly (`map(r, fn)`), or without its range
+ *  to produce something that can be piped into (`r | map(fn)`). The
+ *  exceptions are `zip` and `concat`, which take only ranges.
+ *
+ *   - `map(r, fn)`      yields `fn(x)` for each `x`.
+ *   - `filter(r, pred)` yields each `x` for which `pred(x)` holds.
+ *   - `take(r, n)`      yields at most the first `n` elements.
+ *   - `stride(r, n)`    yields every `n`th element, starting with the first.
+ *   - `chunk(r, n)`     yields consecutive subranges of `n` elements (the last
+ *                       may be shorter).
+ *   - `zip(r...)`       yields tuples of references into each range, stopping
+ *                       at the end of the shortest.
+ *   - `enumerate(r...)` is `zip`, with the index of each tuple prepended.
+ *   - `concat(r...)`    yields the elements of each range in turn.
+ *
+ *  Views keep random access wherever it's cheap to; `map`, `take`, `stride`,
+ *  `chunk`, `zip`, `enumerate`, and `concat` over random-access ranges are
+ *  random-access themselves. `filter` is only ever a forward view. Views over
+ *  ranges of known size have a `size()`, s.t. consumers can reserve storage
+ *  once, as `to_vector` does.
+ *
+ *  Ranges given as lvalues are referred to, and must outlive the view; ranges
+ *  given as rvalues are moved into it. Functions are stored in the view, and
+ *  called through `const&`. Iterators refer to their view, and must not
+ *  outlive it.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+
+
+namespace nonstd {
+
+namespace detail::adaptors_ {
+
+template <typename R>
+using iterator_t = decltype(std::begin(std::declval<R &>()));
+
+template <typename It>
+using category_t = typename std::iterator_traits<It>::iterator_category;
+
+template <typename It>
+using reference_t = decltype(*std::declval<It &>());
+
+template <typename It>
+inline constexpr bool is_random_access_v =
+    std::is_base_of_v<std::random_access_iterator_tag, category_t<It>>;
+
+template <typename It>
+inline constexpr bool is_bidirectional_v =
+    std::is_base_of_v<std::bidirectional_iterator_tag, category_t<It>>;
+
+/** The strongest of the standard categories that every `It` satisfies, never
+ *  stronger than `Cap`.
+ */
+template <typename Cap, typename ... Its>
+using common_category_t = std::conditional_t<
+    (std::is_base_of_v<std::random_access_iterator_tag, Cap>
+        && ... && is_random_access_v<Its>),
+    std::random_access_iterator_tag,
+    std::conditional_t<
+        (std::is_base_of_v<std::bidirectional_iterator_tag, Cap>
+            && ... && is_bidirectional_v<Its>),
+        std::bidirectional_iterator_tag,
+        std::conditional_t<
+            (std::is_base_of_v<std::forward_iterator_tag, category_t<Its>>
+                && ...),
+            std::forward_iterator_tag,
+            std::input_iterator_tag>>>;
+
+
+/** Sized Ranges
+ *  ------------
+ *  A range's size is known if it has a `size()` member, is a bare array, or
+ *  has random-access iterators.
+ */
+template <typename R, typename = void>
+struct has_size_member : std::false_type { };
+template <typename R>
+struct has_size_member<
+    R, std::void_t<decltype(std::declval<R const &>().size())>>
+    : std::true_type { };
+
+template <typename R>
+inline constexpr bool is_sized_v = has_size_member<R>::value
+                                || std::is_array_v<R>
+                                || is_random_access_v<iterator_t<R const>>;
+
+template <typename R>
+constexpr u64 size_of(R const & r) {
+    if constexpr (has_size_member<R>::value) {
+        return static_cast<u64>(r.size());
+    } else if constexpr (std::is_array_v<R>) {
+        return std::extent_v<R>;
+    } else {
+        return static_cast<u64>(std::end(r) - std::begin(r));
+    }
+}
+
+
+/** Iterator Facade
+ *  ---------------
+ *  Builds the full iterator interface out of a few primitives on `Derived`;
+ *  `dereference`, `increment`, and `equal`, and for bidirectional and
+ *  random-access iterators, `decrement`, `advance(n)`, and `distance_to(o)`.
+ *  Operators that need primitives `Derived` lacks are only an error if used.
+ */
+template <typename Derived, typename Category, typename Reference>
+class iterator_facade {
+public:
+    using iterator_category = Category;
+    using reference         = Reference;
+    using value_type        = std::remove_cv_t<
+                                  std::remove_reference_t<Reference>>;
+    using difference_type   = ptrdiff;
+    using pointer           = void;
+
+    constexpr reference operator* () const { return self().dereference(); }
+
+    constexpr Derived & operator++ () {
+        self().increment();
+        return self();
+    }
+    constexpr Derived operator++ (int) {
+        Derived previous = self();
+        self().increment();
+        return previous;
+    }
+    constexpr Derived & operator-- () {
+        self().decrement();
+        return self();
+    }
+    constexpr Derived operator-- (int) {
+        Derived previous = self();
+        self().decrement();
+        return previous;
+    }
+
+    constexpr Derived & operator+= (difference_type n) {
+        self().advance(n);
+        return self();
+    }
+    constexpr Derived & operator-= (difference_type n) {
+        self().advance(-n);
+        return self();
+    }
+    constexpr reference operator[] (difference_type n) const {
+        Derived it = self();
+        it.advance(n);
+        return it.dereference();
+    }
+
+    friend constexpr Derived operator+ (Derived it, difference_type n) {
+        it.advance(n);
+        return it;
+    }
+    friend constexpr Derived operator+ (difference_type n, Derived it) {
+        it.advance(n);
+        return it;
+    }
+    friend constexpr Derived operator- (Derived it, difference_type n) {
+        it.advance(-n);
+        return it;
+    }
+    friend constexpr difference_type operator- (Derived const & lhs,
+                                                Derived const & rhs) {
+        return rhs.distance_to(lhs);
+    }
+
+    friend constexpr bool operator== (Derived const & lhs,
+                                      Derived const & rhs) {
+        return lhs.equal(rhs);
+    }
+    friend constexpr bool operator!= (Derived const & lhs,
+                                      Derived const & rhs) {
+        return !lhs.equal(rhs);
+    }
+    friend constexpr bool operator< (Derived const & lhs,
+                                     Derived const & rhs) {
+        return lhs.distance_to(rhs) > 0;
+    }
+    friend constexpr bool operator> (Derived const & lhs,
+                                     Derived const & rhs) {
+        return rhs < lhs;
+    }
+    friend constexpr bool operator<= (Derived const & lhs,
+                                      Derived const & rhs) {
+        return !(rhs < lhs);
+    }
+    friend constexpr bool operator>= (Derived const & lhs,
+                                      Derived const & rhs) {
+        return !(lhs < rhs);
+    }
+
+private:
+    constexpr Derived & self() { return static_cast<Derived &>(*this); }
+    constexpr Derived const & self() const {
+        return static_cast<Derived const &>(*this);
+    }
+};
+
+
+/** Range Storage
+ *  -------------
+ *  Views hold lvalue ranges through a `ref_view`, and rvalue ranges by value.
+ */
+template <typename R>
+class ref_view {
+private:
+    R * m_range;
+
+public:
+    constexpr ref_view(R & range) noexcept : m_range ( &range ) { }
+
+    constexpr auto begin() const { return std::begin(*m_range); }
+    constexpr auto end()   const { return std::end(*m_range); }
+
+    template < typename S = R
+             , typename = std::enable_if_t<is_sized_v<S>> >
+    constexpr u64 size() const { return size_of(*m_range); }
+};
+
+template <typename R>
+using all_t = std::conditional_t<std::is_lvalue_reference_v<R>,
+                                 ref_view<std::remove_reference_t<R>>,
+                                 std::decay_t<R>>;
+
+template <typename R>
+constexpr all_t<R> all(R && range) {
+    if constexpr (std::is_lvalue_reference_v<R>) {
+        return ref_view<std::remove_reference_t<R>> { range };
+    } else {
+        return std::forward<R>(range);
+    }
+}
+
+
+/** A pair of iterators, iterable. What `chunk` yields. */
+template <typename It>
+class subrange {
+private:
+    It m_begin;
+    It m_end;
+
+public:
+    constexpr subrange(It begin, It end) : m_begin ( begin ), m_end ( end ) { }
+
+    constexpr It begin() const { return m_begin; }
+    constexpr It end()   const { return m_end; }
+    constexpr bool empty() const { return m_begin == m_end; }
+
+    template < typename I = It
+             , typename = std::enable_if_t<is_random_access_v<I>> >
+    constexpr u64 size() const { return static_cast<u64>(m_end - m_begin); }
+};
+
+
+/** Pipe Syntax
+ *  -----------
+ *  `r | adaptor` calls the adaptor with `r`.
+ */
+template <typename Fn>
+struct closure {
+    Fn fn;
+};
+
+template <typename Fn>
+constexpr closure<Fn> make_closure(Fn fn) { return { std::move(fn) }; }
+
+template <typename R, typename Fn>
+constexpr auto operator| (R && range, closure<Fn> const & adaptor) {
+    return adaptor.fn(std::forward<R>(range));
+}
+
+} /* namespace detail::adaptors_ */
+
+
+/** Map
+ *  ---
+ */
+template <typename V, typename Fn>
+class map_view {
+private:
+    using base_iterator = detail::adaptors_::iterator_t<V const>;
+    using result = std::invoke_result_t<
+        Fn const &, detail::adaptors_::reference_t<base_iterator>>;
+
+    V  m_base;
+    Fn m_fn;
+
+public:
+    class iterator : public detail::adaptors_::iterator_facade<
+        iterator,
+        detail::adaptors_::common_category_t<std::random_access_iterator_tag,
+                                             base_iterator>,
+        result>
+    {
+    private:
+        base_iterator m_it;
+        Fn const *    m_fn;
+
+    public:
+        constexpr iterator(base_iterator it, Fn const * fn)
+            : m_it ( it )
+            , m_fn ( fn )
+        { }
+
+        constexpr result dereference() const {
+            return std::invoke(*m_fn, *m_it);
+        }
+        constexpr void increment() { ++m_it; }
+        constexpr void decrement() { --m_it; }
+        constexpr void advance(ptrdiff n) { m_it += n; }
+        constexpr ptrdiff distance_to(iterator const & o) const {
+            return o.m_it - m_it;
+        }
+        constexpr bool equal(iterator const & o) const {
+            return m_it == o.m_it;
+        }
+    };
+
+    constexpr map_view(V base, Fn fn)
+        : m_base ( std::move(base) )
+        , m_fn   ( std::move(fn) )
+    { }
+
+    constexpr iterator begin() const { return { std::begin(m_base), &m_fn }; }
+    constexpr iterator end()   const { return { std::end(m_base), &m_fn }; }
+
+    template < typename B = V
+             , typename = std::enable_if_t<detail::adaptors_::is_sized_v<B>> >
+    constexpr u64 size() const { return detail::adaptors_::size_of(m_base); }
+};
+
+template <typename R, typename Fn>
+constexpr auto map(R && range, Fn fn) {
+    using view = map_view<detail::adaptors_::all_t<R>, Fn>;
+    return view { detail::adaptors_::all(std::forward<R>(range)),
+                  std::move(fn) };
+}
+
+template <typename Fn>
+constexpr auto map(Fn fn) {
+    return detail::adaptors_::make_closure([fn = std::move(fn)](auto && r) {
+        return map(std::forward<decltype(r)>(r), fn);
+    });
+}
+
+
+/** Filter
+ *  ------
+ */
+template <typename V, typename Pred>
+class filter_view {
+private:
+    using base_iterator = detail::adaptors_::iterator_t<V const>;
+
+    V    m_base;
+    Pred m_pred;
+
+public:
+    class iterator : public detail::adaptors_::iterator_facade<
+        iterator,
+        detail::adaptors_::common_category_t<std::forward_iterator_tag,
+                                             base_iterator>,
+        detail::adaptors_::reference_t<base_iterator>>
+    {
+    private:
+        base_iterator m_it;
+        base_iterator m_end;
+        Pred const *  m_pred;
+
+        constexpr void satisfy() {
+            while (m_it != m_end && !std::invoke(*m_pred, *m_it)) { ++m_it; }
+        }
+
+    public:
+        constexpr iterator(base_iterator it, base_iterator end,
+                           Pred const * pred)
+            : m_it   ( it )
+            , m_end  ( end )
+            , m_pred ( pred )
+        {
+            satisfy();
+        }
+
+        constexpr decltype(auto) dereference() const { return *m_it; }
+        constexpr void increment() {
+            ++m_it;
+            satisfy();
+        }
+        constexpr bool equal(iterator const & o) const {
+            return m_it == o.m_it;
+        }
+    };
+
+    constexpr filter_view(V base, Pred pred)
+        : m_base ( std::move(base) )
+        , m_pred ( std::move(pred) )
+    { }
+
+    constexpr iterator begin() const {
+        return { std::begin(m_base), std::end(m_base), &m_pred };
+    }
+    constexpr iterator end() const {
+        return { std::end(m_base), std::end(m_base), &m_pred };
+    }
+};
+
+template <typename R, typename Pred>
+constexpr auto filter(R && range, Pred pred) {
+    using view = filter_view<detail::adaptors_::all_t<R>, Pred>;
+    return view { detail::adaptors_::all(std::forward<R>(range)),
+                  std::move(pred) };
+}
+
+template <typename Pred>
+constexpr auto filter(Pred pred) {
+    return detail::adaptors_::make_closure([pred = std::move(pred)](auto && r) {
+        return filter(std::forward<decltype(r)>(r), pred);
+    });
+}
+
+
+/** Take
+ *  ----
+ *  Over random-access ranges, yields the underlying iterators directly.
+ */
+template <typename V>
+class take_view {
+private:
+    using base_iterator = detail::adaptors_::iterator_t<V const>;
+    static constexpr bool random_access =
+        detail::adaptors_::is_random_access_v<base_iterator>;
+
+    V   m_base;
+    u64 m_count;
+
+public:
+    class counted_iterator : public detail::adaptors_::iterator_facade<
+        counted_iterator,
+        detail::adaptors_::common_category_t<std::forward_iterator_tag,
+                                             base_iterator>,
+        detail::adaptors_::reference_t<base_iterator>>
+    {
+    private:
+        base_iterator m_it;
+        base_iterator m_end;
+        u64           m_remaining;
+
+        constexpr bool done() const {
+            return m_remaining == 0 || m_it == m_end;
+        }
+
+    public:
+        constexpr counted_iterator(base_iterator it, base_iterator end,
+                                   u64 remaining)
+            : m_it        ( it )
+            , m_end       ( end )
+            , m_remaining ( remaining )
+        { }
+
+        constexpr decltype(auto) dereference() const { return *m_it; }
+        constexpr void increment() {
+            ++m_it;
+            --m_remaining;
+        }
+        constexpr bool equal(counted_iterator const & o) const {
+            return (done() && o.done()) || m_it == o.m_it;
+        }
+    };
+
+    using iterator = std::conditional_t<random_access, base_iterator,
+                                        counted_iterator>;
+
+    constexpr take_view(V base, u64 count)
+        : m_base  ( std::move(base) )
+        , m_count ( count )
+    { }
+
+    constexpr iterator begin() const {
+        if constexpr (random_access) {
+            return std::begin(m_base);
+        } else {
+            return { std::begin(m_base), std::end(m_base), m_count };
+        }
+    }
+    constexpr iterator end() const {
+        if constexpr (random_access) {
+            return std::begin(m_base) + static_cast<ptrdiff>(size());
+        } else {
+            return { std::end(m_base), std::end(m_base), 0 };
+        }
+    }
+
+    template < typename B = V
+             , typename = std::enable_if_t<detail::adaptors_::is_sized_v<B>> >
+    constexpr u64 size() const {
+        return n2min(m_count, detail::adaptors_::size_of(m_base));
+    }
+};
+
+template <typename R>
+constexpr auto take(R && range, u64 count) {
+    using view = take_view<detail::adaptors_::all_t<R>>;
+    return view { detail::adaptors_::all(std::forward<R>(range)), count };
+}
+
+inline constexpr auto take(u64 count) {
+    return detail::adaptors_::make_closure([count](auto && r) {
+        return take(std::forward<decltype(r)>(r), count);
+    });
+}
+
+
+/** Stride
+ *  ------
+ */
+template <typename V>
+class stride_view {
+private:
+    using base_iterator = detail::adaptors_::iterator_t<V const>;
+    using reference     = detail::adaptors_::reference_t<base_iterator>;
+    static constexpr bool random_access =
+        detail::adaptors_::is_random_access_v<base_iterator>;
+
+    V   m_base;
+    u64 m_step;
+
+public:
+    /** Over random-access ranges; the `m_index`th element of the view. */
+    class indexed_iterator : public detail::adaptors_::iterator_facade<
+        indexed_iterator, std::random_access_iterator_tag, reference>
+    {
+    private:
+        base_iterator m_first;
+        u64           m_size;
+        u64           m_step;
+        ptrdiff       m_index;
+
+    public:
+        constexpr indexed_iterator(base_iterator first, u64 size, u64 step,
+                                   ptrdiff index)
+            : m_first ( first )
+            , m_size  ( size )
+            , m_step  ( step )
+            , m_index ( index )
+        { }
+
+        constexpr reference dereference() const {
+            return m_first[m_index * static_cast<ptrdiff>(m_step)];
+        }
+        constexpr void increment() { ++m_index; }
+        constexpr void decrement() { --m_index; }
+        constexpr void advance(ptrdiff n) { m_index += n; }
+        constexpr ptrdiff distance_to(indexed_iterator const & o) const {
+            return o.m_index - m_index;
+        }
+        constexpr bool equal(indexed_iterator const & o) const {
+            return m_index == o.m_index;
+        }
+    };
+
+    class stepping_iterator : public detail::adaptors_::iterator_facade<
+        stepping_iterator,
+        detail::adaptors_::common_category_t<std::forward_iterator_tag,
+                                             base_iterator>,
+        reference>
+    {
+    private:
+        base_iterator m_it;
+        base_iterator m_end;
+        u64           m_step;
+
+    public:
+        constexpr stepping_iterator(base_iterator it, base_iterator end,
+                                    u64 step)
+            : m_it   ( it )
+            , m_end  ( end )
+            , m_step ( step )
+        { }
+
+        constexpr reference dereference() const { return *m_it; }
+        constexpr void increment() {
+            for (u64 i = 0; i < m_step && m_it != m_end; ++i) { ++m_it; }
+        }
+        constexpr bool equal(stepping_iterator const & o) const {
+            return m_it == o.m_it;
+        }
+    };
+
+    using iterator = std::conditional_t<random_access, indexed_iterator,
+                                        stepping_iterator>;
+
+    constexpr stride_view(V base, u64 step)
+        : m_base ( std::move(base) )
+        , m_step ( n2max(step, u64{1}) )
+    { }
+
+    constexpr iterator begin() const {
+        if constexpr (random_access) {
+            return { std::begin(m_base), base_size(), m_step, 0 };
+        } else {
+            return { std::begin(m_base), std::end(m_base), m_step };
+        }
+    }
+    constexpr iterator end() const {
+        if constexpr (random_access) {
+            return { std::begin(m_base), base_size(), m_step,
+                     static_cast<ptrdiff>(size()) };
+        } else {
+            return { std::end(m_base), std::end(m_base), m_step };
+        }
+    }
+
+    template < typename B = V
+             , typename = std::enable_if_t<detail::adaptors_::is_sized_v<B>> >
+    constexpr u64 size() const { return (base_size() + m_step - 1) / m_step; }
+
+private:
+    constexpr u64 base_size() const {
+        return detail::adaptors_::size_of(m_base);
+    }
+};
+
+template <typename R>
+constexpr auto stride(R && range, u64 step) {
+    using view = stride_view<detail::adaptors_::all_t<R>>;
+    return view { detail::adaptors_::all(std::forward<R>(range)), step };
+}
+
+inline constexpr auto stride(u64 step) {
+    return detail::adaptors_::make_closure([step](auto && r) {
+        return stride(std::forward<decltype(r)>(r), step);
+    });
+}
+
+
+/** Chunk
+ *  -----
+ */
+template <typename V>
+class chunk_view {
+private:
+    using base_iterator = detail::adaptors_::iterator_t<V const>;
+    using chunk_type    = detail::adaptors_::subrange<base_iterator>;
+    static constexpr bool random_access =
+        detail::adaptors_::is_random_access_v<base_iterator>;
+
+    V   m_base;
+    u64 m_size;
+
+public:
+    /** Over random-access ranges; the `m_index`th chunk. */
+    class indexed_iterator : public detail::adaptors_::iterator_facade<
+        indexed_iterator, std::random_access_iterator_tag, chunk_type>
+    {
+    private:
+        base_iterator m_first;
+        u64           m_total;
+        u64           m_size;
+        ptrdiff       m_index;
+
+    public:
+        constexpr indexed_iterator(base_iterator first, u64 total, u64 size,
+                                   ptrdiff index)
+            : m_first ( first )
+            , m_total ( total )
+            , m_size  ( size )
+            , m_index ( index )
+        { }
+
+        constexpr chunk_type dereference() const {
+            u64 const lo = static_cast<u64>(m_index) * m_size;
+            u64 const hi = n2min(lo + m_size, m_total);
+            return { m_first + static_cast<ptrdiff>(lo),
+                     m_first + static_cast<ptrdiff>(hi) };
+        }
+        constexpr void increment() { ++m_index; }
+        constexpr void decrement() { --m_index; }
+        constexpr void advance(ptrdiff n) { m_index += n; }
+        constexpr ptrdiff distance_to(indexed_iterator const & o) const {
+            return o.m_index - m_index;
+        }
+        constexpr bool equal(indexed_iterator const & o) const {
+            return m_index == o.m_index;
+        }
+    };
+
+    class stepping_iterator : public detail::adaptors_::iterator_facade<
+        stepping_iterator, std::forward_iterator_tag, chunk_type>
+    {
+    private:
+        base_iterator m_it;
+        base_iterator m_next;
+        base_iterator m_end;
+        u64           m_size;
+
+        constexpr void find_next() {
+            m_next = m_it;
+            for (u64 i = 0; i < m_size && m_next != m_end; ++i) { ++m_next; }
+        }
+
+    public:
+        constexpr stepping_iterator(base_iterator it, base_iterator end,
+                                    u64 size)
+            : m_it   ( it )
+            , m_next ( it )
+            , m_end  ( end )
+            , m_size ( size )
+        {
+            find_next();
+        }
+
+        constexpr chunk_type dereference() const { return { m_it, m_next }; }
+        constexpr void increment() {
+            m_it = m_next;
+            find_next();
+        }
+        constexpr bool equal(stepping_iterator const & o) const {
+            return m_it == o.m_it;
+        }
+    };
+
+    using iterator = std::conditional_t<random_access, indexed_iterator,
+                                        stepping_iterator>;
+
+    constexpr chunk_view(V base, u64 size)
+        : m_base ( std::move(base) )
+        , m_size ( n2max(size, u64{1}) )
+    { }
+
+    constexpr iterator begin() const {
+        if constexpr (random_access) {
+            return { std::begin(m_base), base_size(), m_size, 0 };
+        } else {
+            return { std::begin(m_base), std::end(m_base), m_size };
+        }
+    }
+    constexpr iterator end() const {
+        if constexpr (random_access) {
+            return { std::begin(m_base), base_size(), m_size,
+                     static_cast<ptrdiff>(size()) };
+        } else {
+            return { std::end(m_base), std::end(m_base), m_size };
+        }
+    }
+
+    template < typename B = V
+             , typename = std::enable_if_t<detail::adaptors_::is_sized_v<B>> >
+    constexpr u64 size() const { return (base_size() + m_size - 1) / m_size; }
+
+private:
+    constexpr u64 base_size() const {
+        return detail::adaptors_::size_of(m_base);
+    }
+};
+
+template <typename R>
+constexpr auto chunk(R && range, u64 size) {
+    using view = chunk_view<detail::adaptors_::all_t<R>>;
+    return view { detail::adaptors_::all(std::forward<R>(range)), size };
+}
+
+inline constexpr auto chunk(u64 size) {
+    return detail::adaptors_::make_closure([size](auto && r) {
+        return chunk(std::forward<decltype(r)>(r), size);
+    });
+}
+
+
+/** Zip
+ *  ---
+ *  Stops at the end of the shortest range. Over random-access ranges, the end
+ *  of every range is moved up to match.
+ */
+template <typename ... Vs>
+class zip_view {
+    static_assert(sizeof...(Vs) > 0, "zip requires at least one range.");
+
+private:
+    using iterators = std::tuple<detail::adaptors_::iterator_t<Vs const>...>;
+    using reference = std::tuple<
+        detail::adaptors_::reference_t<detail::adaptors_::iterator_t<Vs const>>
+        ...>;
+    static constexpr bool random_access =
+        (detail::adaptors_::is_random_access_v<
+            detail::adaptors_::iterator_t<Vs const>> && ...);
+
+    std::tuple<Vs...> m_bases;
+
+public:
+    class iterator : public detail::adaptors_::iterator_facade<
+        iterator,
+        detail::adaptors_::common_category_t<
+            std::random_access_iterator_tag,
+            detail::adaptors_::iterator_t<Vs const>...>,
+        reference>
+    {
+    private:
+        iterators m_its;
+
+    public:
+        constexpr explicit iterator(iterators its) : m_its ( its ) { }
+
+        constexpr reference dereference() const {
+            return std::apply([](auto const & ... its) {
+                return reference { *its... };
+            }, m_its);
+        }
+        constexpr void increment() {
+            std::apply([](auto & ... its) { (++its, ...); }, m_its);
+        }
+        constexpr void decrement() {
+            std::apply([](auto & ... its) { (--its, ...); }, m_its);
+        }
+        constexpr void advance(ptrdiff n) {
+            std::apply([n](auto & ... its) { ((its += n), ...); }, m_its);
+        }
+        constexpr ptrdiff distance_to(iterator const & o) const {
+            return std::get<0>(o.m_its) - std::get<0>(m_its);
+        }
+        /** Equal if any of the underlying iterators are. */
+        constexpr bool equal(iterator const & o) const {
+            return any_equal(o, std::index_sequence_for<Vs...>{});
+        }
+
+    private:
+        template <std::size_t ... Is>
+        constexpr bool any_equal(iterator const & o,
+                                 std::index_sequence<Is...>) const {
+            return ((std::get<Is>(m_its) == std::get<Is>(o.m_its)) || ...);
+        }
+    };
+
+    constexpr explicit zip_view(Vs ... bases)
+        : m_bases ( std::move(bases)... )
+    { }
+
+    constexpr iterator begin() const {
+        return iterator { std::apply([](auto const & ... bases) {
+            return iterators { std::begin(bases)... };
+        }, m_bases) };
+    }
+    constexpr iterator end() const {
+        if constexpr (random_access) {
+            return begin() + static_cast<ptrdiff>(size());
+        } else {
+            return iterator { std::apply([](auto const & ... bases) {
+                return iterators { std::end(bases)... };
+            }, m_bases) };
+        }
+    }
+
+    template < bool Sized = (detail::adaptors_::is_sized_v<Vs> && ...)
+             , typename = std::enable_if_t<Sized> >
+    constexpr u64 size() const {
+        return std::apply([](auto const & ... bases) {
+            return std::min({ detail::adaptors_::size_of(bases)... });
+        }, m_bases);
+    }
+};
+
+template <typename ... Rs>
+constexpr auto zip(Rs && ... ranges) {
+    using view = zip_view<detail::adaptors_::all_t<Rs>...>;
+    return view { detail::adaptors_::all(std::forward<Rs>(ranges))... };
+}
+
+
+/** Enumerate
+ *  ---------
+ *  Zip with a count. Over a single range this is `nonstd::enumerate` (see
+ *  core/enumerate.h), yielding `(i, x)` items; over several it yields flat
+ *  `(i, x, y, ...)` tuples of the index and a reference into each range.
+ */
+template <typename R1, typename R2, typename ... Rs>
+constexpr auto enumerate(R1 && r1, R2 && r2, Rs && ... rs) {
+    return zip(range(std::numeric_limits<std::size_t>::max()),
+               std::forward<R1>(r1), std::forward<R2>(r2),
+               std::forward<Rs>(rs)...);
+}
+
+
+/** Concat
+ *  ------
+ *  Concatenates two ranges; more are concatenated pairwise. Both ranges'
+ *  references must have a common type; if they're the same type, references
+ *  are passed through.
+ */
+template <typename A, typename B>
+class concat_view {
+private:
+    using a_iterator = detail::adaptors_::iterator_t<A const>;
+    using b_iterator = detail::adaptors_::iterator_t<B const>;
+    using a_reference = detail::adaptors_::reference_t<a_iterator>;
+    using b_reference = detail::adaptors_::reference_t<b_iterator>;
+    using reference = std::conditional_t<
+        std::is_same_v<a_reference, b_reference>,
+        a_reference,
+        std::common_type_t<a_reference, b_reference>>;
+    static constexpr bool random_access =
+        detail::adaptors_::is_random_access_v<a_iterator>
+     && detail::adaptors_::is_random_access_v<b_iterator>;
+
+    A m_a;
+    B m_b;
+
+public:
+    /** Over random-access ranges; the `m_index`th element overall. */
+    class indexed_iterator : public detail::adaptors_::iterator_facade<
+        indexed_iterator, std::random_access_iterator_tag, reference>
+    {
+    private:
+        a_iterator m_a;
+        b_iterator m_b;
+        ptrdiff    m_a_size;
+        ptrdiff    m_index;
+
+    public:
+        constexpr indexed_iterator(a_iterator a, b_iterator b, ptrdiff a_size,
+                                   ptrdiff index)
+            : m_a      ( a )
+            , m_b      ( b )
+            , m_a_size ( a_size )
+            , m_index  ( index )
+        { }
+
+        constexpr reference dereference() const {
+            if (m_index < m_a_size) { return m_a[m_index]; }
+            return m_b[m_index - m_a_size];
+        }
+        constexpr void increment() { ++m_index; }
+        constexpr void decrement() { --m_index; }
+        constexpr void advance(ptrdiff n) { m_index += n; }
+        constexpr ptrdiff distance_to(indexed_iterator const & o) const {
+            return o.m_index - m_index;
+        }
+        constexpr bool equal(indexed_iterator const & o) const {
+            return m_index == o.m_index;
+        }
+    };
+
+    class stepping_iterator : public detail::adaptors_::iterator_facade<
+        stepping_iterator, std::forward_iterator_tag, reference>
+    {
+    private:
+        a_iterator m_a;
+        a_iterator m_a_end;
+        b_iterator m_b;
+
+    public:
+        constexpr stepping_iterator(a_iterator a, a_iterator a_end,
+                                    b_iterator b)
+            : m_a     ( a )
+            , m_a_end ( a_end )
+            , m_b     ( b )
+        { }
+
+        constexpr reference dereference() const {
+            if (m_a != m_a_end) { return *m_a; }
+            return *m_b;
+        }
+        constexpr void increment() {
+            if (m_a != m_a_end) { ++m_a; }
+            else                { ++m_b; }
+        }
+        constexpr bool equal(stepping_iterator const & o) const {
+            return m_a == o.m_a && m_b == o.m_b;
+        }
+    };
+
+    using iterator = std::conditional_t<random_access, indexed_iterator,
+                                        stepping_iterator>;
+
+    constexpr concat_view(A a, B b)
+        : m_a ( std::move(a) )
+        , m_b ( std::move(b) )
+    { }
+
+    constexpr iterator begin() const {
+        if constexpr (random_access) {
+            return { std::begin(m_a), std::begin(m_b), a_size(), 0 };
+        } else {
+            return { std::begin(m_a), std::end(m_a), std::begin(m_b) };
+        }
+    }
+    constexpr iterator end() const {
+        if constexpr (random_access) {
+            return { std::begin(m_a), std::begin(m_b), a_size(),
+                     static_cast<ptrdiff>(size()) };
+        } else {
+            return { std::end(m_a), std::end(m_a), std::end(m_b) };
+        }
+    }
+
+    template < bool Sized = detail::adaptors_::is_sized_v<A>
+                         && detail::adaptors_::is_sized_v<B>
+             , typename = std::enable_if_t<Sized> >
+    constexpr u64 size() const {
+        return detail::adaptors_::size_of(m_a)
+             + detail::adaptors_::size_of(m_b);
+    }
+
+private:
+    constexpr ptrdiff a_size() const {
+        return static_cast<ptrdiff>(detail::adaptors_::size_of(m_a));
+    }
+};
+
+template <typename R>
+constexpr decltype(auto) concat(R && range) {
+    return detail::adaptors_::all(std::forward<R>(range));
+}
+
+template <typename R1, typename R2, typename ... Rs>
+constexpr auto concat(R1 && first, R2 && second, Rs && ... rest) {
+    using view = concat_view<detail::adaptors_::all_t<R1>,
+                             detail::adaptors_::all_t<R2>>;
+    return concat(view { detail::adaptors_::all(std::forward<R1>(first)),
+                         detail::adaptors_::all(std::forward<R2>(second)) },
+                  std::forward<Rs>(rest)...);
+}
+
+
+/** Collection
+ *  ----------
+ *  Copy a range into a vector, reserving once if the range's size is known.
+ */
+template <typename R>
+inline auto to_vector(R && range) {
+    using iterator = detail::adaptors_::iterator_t<std::remove_reference_t<R>>;
+    using value_type = std::remove_cv_t<std::remove_reference_t<
+        detail::adaptors_::reference_t<iterator>>>;
+    std::vector<value_type> result;
+    if constexpr (detail::adaptors_::is_sized_v<std::remove_reference_t<R>>) {
+        result.reserve(detail::adaptors_::size_of(range));
+    }
+    for (auto && element : range) { result.push_back(element); }
+    return result;
+}
+
+} /* namespace nonstd */
@@ -0,0 +1,180 @@
+/** Iterator Adaptor Tests
+ *  ======================
+ *  GOAL: Validate that each adaptor yields the right elements -- alone and
+ *  composed -- that they keep random access and report sizes where they
+ *  should, and that they refer to (rather than copy) lvalue ranges.
+ */
+
+#include <nonstd/adaptors.h>
+#include <platform/testrunner/testrunner.h>
+
+#include <iterator>
+#include <list>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+
+
+namespace nonstd_test::adaptors {
+
+using nonstd::chunk;
+using nonstd::concat;
+using nonstd::enumerate;
+using nonstd::filter;
+using nonstd::map;
+using nonstd::stride;
+using nonstd::take;
+using nonstd::to_vector;
+using nonstd::zip;
+
+template <typename R>
+constexpr bool is_random_access = std::is_same_v<
+    typename std::iterator_traits<decltype(std::begin(
+        std::declval<R &>()))>::iterator_category,
+    std::random_access_iterator_tag>;
+
+
+TEST_CASE("Iterator Adaptors", "[nonstd][adaptors]") {
+    std::vector<i32> const numbers { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    std::list<i32> const linked { numbers.begin(), numbers.end() };
+
+    SECTION("map") {
+        auto squares = map(numbers, [](i32 x) { return x * x; });
+        REQUIRE(to_vector(squares)
+                == std::vector<i32> { 0, 1, 4, 9, 16, 25, 36, 49, 64, 81 });
+        REQUIRE(squares.size() == 10);
+        REQUIRE(squares.begin()[3] == 9);
+        REQUIRE(squares.end() - squares.begin() == 10);
+        static_assert(is_random_access<decltype(squares)>);
+    }
+
+    SECTION("filter") {
+        auto odd = numbers | filter([](i32 x) { return x % 2 == 1; });
+        REQUIRE(to_vector(odd) == std::vector<i32> { 1, 3, 5, 7, 9 });
+
+        auto none = filter(linked, [](i32) { return false; });
+        REQUIRE(none.begin() == none.end());
+    }
+
+    SECTION("take") {
+        REQUIRE(to_vector(take(numbers, 3)) == std::vector<i32> { 0, 1, 2 });
+        REQUIRE(take(numbers, 30).size() == 10);
+        REQUIRE(to_vector(linked | take(4)) == std::vector<i32> { 0, 1, 2, 3 });
+        // Random-access takes hand out the underlying iterators.
+        REQUIRE(&*take(numbers, 3).begin() == numbers.data());
+    }
+
+    SECTION("stride") {
+        auto every_third = stride(numbers, 3);
+        REQUIRE(to_vector(every_third) == std::vector<i32> { 0, 3, 6, 9 });
+        REQUIRE(every_third.size() == 4);
+        REQUIRE(every_third.begin()[2] == 6);
+        REQUIRE(to_vector(linked | stride(4)) == std::vector<i32> { 0, 4, 8 });
+    }
+
+    SECTION("chunk") {
+        auto rows = chunk(numbers, 4);
+        REQUIRE(rows.size() == 3);
+        std::vector<i32> sums;
+        for (auto row : rows) {
+            i32 sum = 0;
+            for (auto x : row) { sum += x; }
+            sums.push_back(sum);
+        }
+        REQUIRE(sums == std::vector<i32> { 6, 22, 17 });
+        REQUIRE((*(rows.end() - 1)).size() == 2);
+
+        u32 chunks = 0;
+        for (auto row : linked | chunk(3)) {
+            chunks += 1;
+            REQUIRE(*row.begin() == i32(3 * (chunks - 1)));
+        }
+        REQUIRE(chunks == 4);
+    }
+
+    SECTION("zip") {
+        std::vector<std::string> names { "a", "b", "c" };
+        std::vector<f32> scores { 1.f, 2.f, 3.f, 4.f };
+        auto pairs = zip(names, scores);
+        REQUIRE(pairs.size() == 3);
+        static_assert(is_random_access<decltype(pairs)>);
+
+        for (auto [name, score] : pairs) { score *= 10.f; name += "!"; }
+        REQUIRE(names[2] == "c!");
+        REQUIRE(scores == std::vector<f32> { 10.f, 20.f, 30.f, 4.f });
+
+        u32 count = 0;
+        for (auto [x, y] : zip(linked, numbers | take(4))) {
+            REQUIRE(x == y);
+            count += 1;
+        }
+        REQUIRE(count == 4);
+    }
+
+    SECTION("zip and enumerate parallel arrays") {
+        std::vector<f32> xs { 1.f, 2.f, 3.f, 4.f };
+        std::vector<f32> ys { 5.f, 6.f, 7.f, 8.f };
+        std::vector<f32> zs { 0.f, 0.f, 0.f, 0.f };
+        std::vector<u8>  alive { 1, 0, 1, 1 };
+
+        auto lanes = zip(xs, ys, zs, alive);
+        static_assert(is_random_access<decltype(lanes)>);
+        for (auto [x, y, z, a] : lanes) { z = a ? x * y : -1.f; }
+        REQUIRE(zs == std::vector<f32> { 5.f, -1.f, 21.f, 32.f });
+
+        auto indexed = enumerate(xs, ys, zs);
+        static_assert(is_random_access<decltype(indexed)>);
+        REQUIRE(indexed.size() == 4);
+        for (auto [i, x, y, z] : indexed) {
+            REQUIRE(&x == &xs[i]);
+            z = f32(i);
+        }
+        REQUIRE(zs == std::vector<f32> { 0.f, 1.f, 2.f, 3.f });
+
+        // Random access lets chunks of the walk run independently.
+        auto const [i, x, y, z] = indexed.begin()[2];
+        REQUIRE(i == 2);
+        REQUIRE(&y == &ys[2]);
+
+        auto wrapped = nonstd::enumerate(zip(xs, ys));
+        auto const second = *(wrapped.begin() + 1);
+        REQUIRE(second.i == 1);
+        REQUIRE(&std::get<1>(second.value) == &ys[1]);
+        REQUIRE(wrapped.end() - wrapped.begin() == 4);
+    }
+
+    SECTION("concat") {
+        std::vector<i32> tail { 10, 11 };
+        auto joined = concat(numbers | take(2), tail, numbers | stride(5));
+        REQUIRE(to_vector(joined) == std::vector<i32> { 0, 1, 10, 11, 0, 5 });
+        REQUIRE(joined.size() == 6);
+        static_assert(is_random_access<decltype(joined)>);
+
+        REQUIRE(to_vector(concat(linked | take(1), tail))
+                == std::vector<i32> { 0, 10, 11 });
+    }
+
+    SECTION("compose, and read through to the original") {
+        std::vector<i32> values { 5, 6, 7, 8 };
+        auto view = values | take(3) | map([](i32 & x) -> i32 & { return x; });
+        for (auto & x : view) { x = -x; }
+        REQUIRE(values == std::vector<i32> { -5, -6, -7, 8 });
+
+        auto over_range = nonstd::range(20)
+                        | filter([](i32 x) { return x % 3 == 0; })
+                        | map([](i32 x) { return x / 3; });
+        REQUIRE(to_vector(over_range)
+                == std::vector<i32> { 0, 1, 2, 3, 4, 5, 6 });
+    }
+
+    SECTION("own rvalue ranges") {
+        auto owned = map(std::vector<i32> { 1, 2, 3 },
+                         [](i32 x) { return x + 1; });
+        REQUIRE(to_vector(owned) == std::vector<i32> { 2, 3, 4 });
+    }
+}
+
+} /* namespace nonstd_test::adaptors */
@@ -0,0 +1,63 @@
+/** Angle Benchmarks
+ *  ================
+ *  Checks angle.h's claim that the non-cx normalizations "will run at least
+ *  10x more quickly" than their constexpr-capable `_cx` counterparts.
+ *
+ *  Inputs cycle through a spread of angles -- small and large, positive and
+ *  negative -- s.t. neither version is measured on one lucky value.
+ */
+
+#include <nonstd/angle.h>
+#include <nonstd/benchmark.h>
+
+#include <array>
+
+#include <nonstd/nonstd.h>
+
+
+namespace nonstd_bench::angle {
+
+using nonstd::angle;
+
+std::array<angle, 64> const & inputs() {
+    static auto const values = [] {
+        std::array<angle, 64> result { };
+        f32 degrees = -7200.f;
+        for (auto & value : result) {
+            value = angle::in_degrees(degrees);
+            degrees = degrees * -0.83f + 97.3f;
+        }
+        return result;
+    }();
+    return values;
+}
+
+template <typename Fn>
+auto each_input(Fn && fn) {
+    return [fn, i = u32 { 0 }]() mutable {
+        angle a = inputs()[i++ % inputs().size()];
+        nonstd::do_not_optimize(a);
+        nonstd::do_not_optimize(fn(a));
+    };
+}
+
+
+NONSTD_BENCHMARK("angle normalization") {
+    auto const & radians = bench.run("normalized_radians",
+        each_input([](angle a) { return a.normalized_radians(); }));
+    auto const & radians_cx = bench.run("normalized_radians_cx",
+        each_input([](angle a) { return a.normalized_radians_cx(); }));
+    bench.expect_speedup(radians_cx, radians, 10.0,
+        "angle.h: normalized_radians runs at least 10x more quickly than "
+        "normalized_radians_cx");
+
+    auto const & degrees = bench.run("normalized_degrees",
+        each_input([](angle a) { return a.normalized_degrees(); }));
+    auto const & degrees_cx = bench.run("normalized_degrees_cx",
+        each_input([](angle a) { return a.normalized_degrees_cx(); }));
+    bench.expect_speedup(degrees_cx, degrees, 10.0,
+        "angle.h: normalized_degrees runs at least 10x more quickly than "
+        "normalized_degrees_cx");
+}
+
+} /* namespace nonstd_bench::angle */
@@ -0,0 +1,60 @@
+# Micro-benchmark targets
+# =======================
+# `n2_platform_benchmark` builds a `<header>.bench.cc` into an executable with
+# nonstd/benchmark.h's `main()`, much as `n2_platform_test` builds a
+# `<header>.test.cc`;
+#
+#     n2_platform_benchmark(
+#         NAME angle.bench
+#         SOURCES angle.bench.cc
+#         DEPENDS
+#             nonstd::angle
+#     )
+#
+# Benchmarks are only built on request -- `nonstd.benchmarks` builds them all,
+# and `nonstd.<NAME>.run` builds and runs one, writing its results to
+# `<NAME>.json` in the build directory -- unless NONSTD_BENCHMARKS is on, which
+# builds them by default and registers each with CTest (label `benchmark`),
+# run with `--quick` s.t. any performance claim it checks fails the build.
+
+include_guard(GLOBAL)
+
+option(NONSTD_BENCHMARKS
+       "Build nonstd's micro-benchmarks, and check their claims under CTest."
+       OFF)
+
+if(NOT TARGET nonstd.benchmarks)
+    add_custom_target(nonstd.benchmarks)
+endif()
+
+function(n2_platform_benchmark)
+    cmake_parse_arguments(ARG "" "NAME" "SOURCES;DEPENDS" ${ARGN})
+    if(NOT ARG_NAME OR NOT ARG_SOURCES)
+        message(FATAL_ERROR
+                "n2_platform_benchmark requires a NAME and SOURCES.")
+    endif()
+
+    set(target nonstd.${ARG_NAME})
+    if(NONSTD_BENCHMARKS)
+        add_executable(${target} ${ARG_SOURCES})
+    else()
+        add_executable(${target} EXCLUDE_FROM_ALL ${ARG_SOURCES})
+    endif()
+    target_link_libraries(${target} PRIVATE ${ARG_DEPENDS} nonstd::benchmark)
+    target_compile_definitions(${target} PRIVATE NONSTD_BENCHMARK_MAIN)
+    add_dependencies(nonstd.benchmarks ${target})
+
+    add_custom_target(${target}.run
+        COMMAND ${target} --json ${CMAKE_CURRENT_BINARY_DIR}/${ARG_NAME}.json
+        DEPENDS ${target}
+        USES_TERMINAL
+    )
+
+    if(NONSTD_BENCHMARKS)
+        add_test(NAME ${target} COMMAND ${target} --quick)
+        set_tests_properties(${target} PROPERTIES
+            LABELS benchmark
+            RUN_SERIAL TRUE
+        )
+    endif()
+endfunction()
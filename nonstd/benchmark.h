@@ -0,0 +1,549 @@
+/** Micro-Benchmarks
+ *  ================
+ *  A small harness for checking performance claims, s.t. "the non-cx version
+ *  will run at least 10x more quickly" is something a build can confirm rather
+ *  than something a comment asserts. Each header that makes such claims may
+ *  ship a `<header>.bench.cc` next to its `<header>.test.cc`;
+ *
+ *      #include <nonstd/angle.h>
+ *      #include <nonstd/benchmark.h>
+ *
+ *      NONSTD_BENCHMARK("angle normalization") {
+ *          auto a = nonstd::angle::in_degrees(725.f);
+ *          auto const & fast = bench.run("fmod", [&] {
+ *              nonstd::do_not_optimize(a);
+ *              nonstd::do_not_optimize(a.normalized_radians());
+ *          });
+ *          ...
+ *          bench.expect_speedup(slow, fast, 10.0, "non-cx is 10x faster");
+ *      }
+ *
+ *  and is built by `n2_platform_benchmark()` (see benchmark.cmake), which links
+ *  this harness's `main()`.
+ *
+ *  `bench.run(name, fn)` measures one call of `fn`;
+ *   1. Warmup; `fn` runs in doubling batches until `config::warmup` has
+ *      passed, which settles caches, branch predictors, and clock speeds, and
+ *      calibrates the iteration count s.t. one sample takes about
+ *      `config::sample_time` -- long enough that the clock's own cost and
+ *      resolution don't matter.
+ *   2. `config::samples` samples are timed, each of that many iterations,
+ *      with `wallclock::now_fast()` (the TSC, where it's usable).
+ *   3. Samples outside Tukey's fences -- more than `config::outlier_fence`
+ *      inter-quartile ranges beyond the quartiles, typically preemptions or
+ *      interrupts -- are rejected, and the rest summarized; median, mean,
+ *      standard deviation, and a 95% confidence interval of the mean (from
+ *      Student's t-distribution).
+ *
+ *  Where one call of `fn` does many operations -- scans an array, pushes a
+ *  batch through a channel -- `bench.run(name, fn, operations)` reports the
+ *  time per operation instead. Where only part of the work should be timed,
+ *  `bench.run_manual(name, fn, operations)` calls `fn(iterations)`, which runs
+ *  that many iterations and returns how long the part of interest took; s.t.
+ *  it can leave out starting threads, draining buffers, or any other setup.
+ *  For contention benchmarks, `time_threads(threads, fn)` does the former;
+ *  it starts the threads, releases them together once all are waiting, and
+ *  times each `fn(t)` from the release until the last of them returns.
+ *
+ *  The compiler is free to delete work whose results go unused, or to hoist
+ *  it out of the loop if its inputs never change. `do_not_optimize(value)`
+ *  forces `value` to be materialized (and, if it's an lvalue, assumed
+ *  modified), and `clobber_memory()` forces all pending writes to memory;
+ *  passing the inputs through `do_not_optimize` each iteration, as above,
+ *  stops them being treated as constants.
+ *
+ *  A benchmark binary accepts;
+ *    * any number of substrings; only benchmarks whose names contain one run
+ *    * `--quick`; fewer, shorter samples, for smoke-testing claims under CI
+ *    * `--json <path>`; also write every result as JSON (`-` for stdout)
+ *  and exits non-zero if any `expect_speedup` claim failed.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/chrono.h>
+#include <nonstd/json_string.h>
+#include <nonstd/tsc_clock.h>
+#include <nonstd/wallclock.h>
+
+#if defined(NONSTD_COMPILER_MSVC)
+#  include <intrin.h>
+#endif
+
+
+/** Register a benchmark. The body receives a `nonstd::benchmark::suite &`
+ *  named `bench`.
+ */
+#define NONSTD_BENCHMARK(NAME)                                                 \
+    static void CONCAT_SYMBOL(_nonstd_benchmark_, __LINE__)(                   \
+        ::nonstd::benchmark::suite & bench);                                   \
+    static ::nonstd::benchmark::registrar                                      \
+        CONCAT_SYMBOL(_nonstd_benchmark_registrar_, __LINE__) {               \
+            NAME, &CONCAT_SYMBOL(_nonstd_benchmark_, __LINE__) };              \
+    static void CONCAT_SYMBOL(_nonstd_benchmark_, __LINE__)(                   \
+        [[maybe_unused]] ::nonstd::benchmark::suite & bench)
+
+
+namespace nonstd {
+
+/** Optimization Barriers
+ *  ---------------------
+ */
+#if defined(NONSTD_COMPILER_MSVC)
+namespace detail::benchmark_ {
+NOINLINE inline void escape(void const volatile *) { }
+} /* namespace detail::benchmark_ */
+
+template <typename T>
+FORCEINLINE void do_not_optimize(T const & value) {
+    detail::benchmark_::escape(&reinterpret_cast<char const volatile &>(value));
+    _ReadWriteBarrier();
+}
+FORCEINLINE void clobber_memory() { _ReadWriteBarrier(); }
+#else
+/** Make the compiler materialize `value`, as if something read it. */
+template <typename T>
+FORCEINLINE void do_not_optimize(T const & value) {
+    __asm__ __volatile__ ("" : : "r,m" (value) : "memory");
+}
+/** ... and, for lvalues, as if something might then have changed it. */
+template <typename T>
+FORCEINLINE void do_not_optimize(T & value) {
+#  if defined(NONSTD_COMPILER_CLANG)
+    __asm__ __volatile__ ("" : "+r,m" (value) : : "memory");
+#  else
+    __asm__ __volatile__ ("" : "+m,r" (value) : : "memory");
+#  endif
+}
+/** Make the compiler complete all pending writes to memory. */
+FORCEINLINE void clobber_memory() {
+    __asm__ __volatile__ ("" : : : "memory");
+}
+#endif
+
+
+namespace benchmark {
+
+struct config {
+    /** How long to run before measuring. */
+    chrono::nanoseconds warmup        = chrono::milliseconds { 100 };
+    /** The least time each sample should take. */
+    chrono::nanoseconds sample_time   = chrono::milliseconds { 2 };
+    u32                 samples       = 50;
+    /** Reject samples this many inter-quartile ranges beyond the quartiles;
+     *  zero keeps every sample.
+     */
+    f64                 outlier_fence = 1.5;
+
+    /** Settings for smoke-testing; `--quick`. */
+    static config quick() {
+        config result;
+        result.warmup      = chrono::milliseconds { 10 };
+        result.sample_time = chrono::microseconds { 500 };
+        result.samples     = 15;
+        return result;
+    }
+};
+
+/** A summary of per-iteration times, in nanoseconds. */
+struct statistics {
+    u64 samples;
+    u64 outliers;
+    f64 median;
+    f64 mean;
+    f64 stddev;
+    f64 min;
+    f64 max;
+    /** The 95% confidence interval of the mean. */
+    f64 ci_low;
+    f64 ci_high;
+
+    /** The relative standard deviation. */
+    f64 rsd() const noexcept { return mean > 0.0 ? stddev / mean : 0.0; }
+};
+
+struct result {
+    std::string name;
+    /** Calls per sample. */
+    u64         iterations;
+    /** Operations per call; `stats` are per operation. */
+    u64         operations;
+    statistics  stats;
+};
+
+struct expectation {
+    std::string claim;
+    std::string baseline;
+    std::string candidate;
+    f64         factor;
+    f64         measured;
+    bool        passed;
+};
+
+
+namespace detail {
+
+/** The 97.5th percentile of Student's t-distribution with `df` degrees of
+ *  freedom; a table where it changes quickly, then a Cornish-Fisher expansion
+ *  (within 0.1% from 10 on).
+ */
+inline f64 t_975(u64 df) noexcept {
+    constexpr f64 table[] = { 0.0,
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    };
+    if (df == 0) { return 0.0; }
+    if (df <= 10) { return table[df]; }
+    f64 const z = 1.959964;
+    f64 const n = f64(df);
+    return z + (z * z * z + z) / (4.0 * n)
+             + (5.0 * std::pow(z, 5) + 16.0 * z * z * z + 3.0 * z)
+               / (96.0 * n * n);
+}
+
+/** The `q`th quantile of sorted `values`, interpolating between ranks. */
+inline f64 quantile(std::vector<f64> const & sorted, f64 q) noexcept {
+    if (sorted.empty()) { return 0.0; }
+    f64 const rank  = q * f64(sorted.size() - 1);
+    u64 const below = u64(rank);
+    u64 const above = n2min(below + 1, u64(sorted.size() - 1));
+    return sorted[below] + (sorted[above] - sorted[below])
+                         * (rank - f64(below));
+}
+
+/** Reject outliers beyond `fence` IQRs of the quartiles, and summarize the
+ *  rest.
+ */
+inline statistics summarize(std::vector<f64> values, f64 fence) {
+    statistics result { };
+    if (values.empty()) { return result; }
+    std::sort(values.begin(), values.end());
+
+    if (fence > 0.0 && values.size() >= 4) {
+        f64 const q1  = quantile(values, 0.25);
+        f64 const q3  = quantile(values, 0.75);
+        f64 const iqr = q3 - q1;
+        auto const first = std::lower_bound(values.begin(), values.end(),
+                                            q1 - fence * iqr);
+        auto const last  = std::upper_bound(first, values.end(),
+                                            q3 + fence * iqr);
+        result.outliers = u64(values.size())
+                        - u64(std::distance(first, last));
+        values = std::vector<f64> { first, last };
+    }
+
+    u64 const n = values.size();
+    f64 sum = 0.0;
+    for (f64 value : values) { sum += value; }
+    f64 const mean = sum / f64(n);
+    f64 squares = 0.0;
+    for (f64 value : values) { squares += (value - mean) * (value - mean); }
+
+    result.samples = n;
+    result.median  = quantile(values, 0.5);
+    result.mean    = mean;
+    result.stddev  = n > 1 ? std::sqrt(squares / f64(n - 1)) : 0.0;
+    result.min     = values.front();
+    result.max     = values.back();
+    f64 const half = t_975(n - 1) * result.stddev / std::sqrt(f64(n));
+    result.ci_low  = mean - half;
+    result.ci_high = mean + half;
+    return result;
+}
+
+} /* namespace detail */
+
+
+/** Run `fn(t)` on threads `t` in `[0, threads)` at once, and return how long
+ *  they took; from their release -- once every thread has started and is
+ *  waiting -- until the last `fn` returned. Starting and joining the threads
+ *  isn't counted.
+ */
+template <typename Fn>
+chrono::nanoseconds time_threads(u32 threads, Fn && fn) {
+    std::atomic<u32>  waiting { 0 };
+    std::atomic<bool> go { false };
+    std::vector<chrono::nanoseconds> finished (threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (u32 t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            waiting.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            fn(t);
+            finished[t] = wallclock::now_fast();
+        });
+    }
+    while (waiting.load() < threads) { std::this_thread::yield(); }
+    auto const start = wallclock::now_fast();
+    go.store(true, std::memory_order_release);
+    for (auto & worker : workers) { worker.join(); }
+    return *std::max_element(finished.begin(), finished.end()) - start;
+}
+
+
+/** Measure `batch(iterations) -> nanoseconds`, which runs `iterations`
+ *  calls of `operations` operations each and times them itself, per
+ *  operation.
+ */
+template <typename Batch>
+result measure_manual(std::string name, Batch && batch,
+                      config const & settings = { }, u64 operations = 1) {
+    // Warm up in doubling batches, until both the warmup has passed and a
+    // batch is long enough to scale to a sample from. (Manually timed batches
+    // might report no time at all; stop doubling somewhere.)
+    constexpr u64 most_iterations = u64 { 1 } << 32;
+    u64 iterations = 1;
+    chrono::nanoseconds elapsed = batch(iterations);
+    auto const warm_at = wallclock::now_fast() + settings.warmup;
+    auto const short_batch = [&] {
+        return elapsed < settings.sample_time / 8
+            && iterations < most_iterations;
+    };
+    while (wallclock::now_fast() < warm_at || short_batch()) {
+        if (short_batch()) { iterations *= 2; }
+        elapsed = batch(iterations);
+    }
+    f64 const per_iteration = f64(n2max(elapsed.count(), i64 { 1 }))
+                            / f64(iterations);
+    iterations = n2min(n2max(u64(std::ceil(f64(settings.sample_time.count())
+                                           / per_iteration)), u64 { 1 }),
+                       most_iterations);
+
+    f64 const per_sample = f64(iterations) * f64(n2max(operations, u64 { 1 }));
+    std::vector<f64> samples;
+    samples.reserve(settings.samples);
+    for (u32 s = 0; s < settings.samples; ++s) {
+        samples.push_back(f64(batch(iterations).count()) / per_sample);
+    }
+    return result {
+        std::move(name), iterations, operations,
+        detail::summarize(std::move(samples), settings.outlier_fence)
+    };
+}
+
+/** Measure `fn`, called with no arguments, per operation. */
+template <typename Fn>
+result measure(std::string name, Fn && fn, config const & settings = { },
+               u64 operations = 1) {
+    return measure_manual(std::move(name), [&](u64 iterations) {
+        auto const start = wallclock::now_fast();
+        for (u64 i = 0; i < iterations; ++i) { fn(); }
+        return wallclock::now_fast() - start;
+    }, settings, operations);
+}
+
+
+/** The results of one registered benchmark; each `run` is measured and
+ *  reported as it's called, and the `result`s it returns stay valid for the
+ *  suite's lifetime.
+ */
+class suite {
+public:
+    explicit suite(std::string name, config settings = { })
+        : m_name     ( std::move(name) )
+        , m_settings ( settings )
+    { }
+
+    /** Measure `fn()`, which does `operations` operations. */
+    template <typename Fn>
+    result const & run(std::string const & name, Fn && fn,
+                       u64 operations = 1) {
+        m_results.push_back(measure(m_name + "/" + name, std::forward<Fn>(fn),
+                                    m_settings, operations));
+        _print(m_results.back());
+        return m_results.back();
+    }
+
+    /** Measure `fn(iterations) -> nanoseconds`, which times itself. */
+    template <typename Fn>
+    result const & run_manual(std::string const & name, Fn && fn,
+                              u64 operations = 1) {
+        m_results.push_back(measure_manual(m_name + "/" + name,
+                                           std::forward<Fn>(fn), m_settings,
+                                           operations));
+        _print(m_results.back());
+        return m_results.back();
+    }
+
+    /** Check that `candidate` runs at least `factor` times as fast as
+     *  `baseline`, by their medians.
+     */
+    bool expect_speedup(result const & baseline, result const & candidate,
+                        f64 factor, std::string claim) {
+        f64 const measured = candidate.stats.median > 0.0
+                           ? baseline.stats.median / candidate.stats.median
+                           : 0.0;
+        bool const passed = measured >= factor;
+        fmt::print("  {} {:.2f}x (expected >= {:.2f}x); {}\n",
+                   passed ? "PASS" : "FAIL", measured, factor, claim);
+        m_expectations.push_back({ std::move(claim), baseline.name,
+                                   candidate.name, factor, measured, passed });
+        return passed;
+    }
+
+    std::string const & name() const noexcept { return m_name; }
+    config const & settings() const noexcept { return m_settings; }
+    std::deque<result> const & results() const noexcept {
+        return m_results;
+    }
+    std::vector<expectation> const & expectations() const noexcept {
+        return m_expectations;
+    }
+
+private:
+    static void _print(result const & r) {
+        auto const & s = r.stats;
+        fmt::print("{:<48} {:>10.3f} ns  (mean {:.3f} +/- {:.3f}, rsd "
+                   "{:.1f}%, {} x {}, {} outliers)\n",
+                   r.name, s.median, s.mean, (s.ci_high - s.ci_low) / 2.0,
+                   100.0 * s.rsd(), s.samples, r.iterations, s.outliers);
+    }
+
+    std::string              m_name;
+    config                   m_settings;
+    std::deque<result>       m_results;
+    std::vector<expectation> m_expectations;
+};
+
+
+/** Registration
+ *  ------------
+ */
+using benchmark_fn = void (*)(suite &);
+
+struct registration {
+    c_cstr       name;
+    benchmark_fn fn;
+};
+
+inline std::vector<registration> & registry() {
+    static std::vector<registration> registered;
+    return registered;
+}
+
+struct registrar {
+    registrar(c_cstr name, benchmark_fn fn) {
+        registry().push_back({ name, fn });
+    }
+};
+
+
+/** Running
+ *  -------
+ */
+inline void write_json(std::string & text,
+                       std::vector<suite> const & suites) {
+    bool const tsc = tsc_clock::usable();
+    text.append(fmt::format(R"({{"clock":"{}","benchmarks":[)",
+                            tsc ? "tsc" : "steady_clock"));
+    bool first = true;
+    for (auto const & s : suites) {
+        for (auto const & r : s.results()) {
+            text.append(first ? "\n" : ",\n");
+            first = false;
+            text.append(R"({"name":)");
+            append_json_string(text, r.name);
+            auto const & st = r.stats;
+            text.append(fmt::format(
+                R"(,"iterations":{},"operations":{},"samples":{},)"
+                R"("outliers":{},)"
+                R"("median_ns":{},"mean_ns":{},"stddev_ns":{},"min_ns":{},)"
+                R"("max_ns":{},"ci95_low_ns":{},"ci95_high_ns":{}}})",
+                r.iterations, r.operations, st.samples, st.outliers,
+                st.median, st.mean, st.stddev, st.min, st.max, st.ci_low,
+                st.ci_high));
+        }
+    }
+    text.append("\n],\"expectations\":[");
+    first = true;
+    for (auto const & s : suites) {
+        for (auto const & e : s.expectations()) {
+            text.append(first ? "\n" : ",\n");
+            first = false;
+            text.append(R"({"claim":)");
+            append_json_string(text, e.claim);
+            text.append(R"(,"baseline":)");
+            append_json_string(text, e.baseline);
+            text.append(R"(,"candidate":)");
+            append_json_string(text, e.candidate);
+            text.append(fmt::format(
+                R"(,"factor":{},"measured":{},"passed":{}}})",
+                e.factor, e.measured, e.passed ? "true" : "false"));
+        }
+    }
+    text.append("\n]}\n");
+}
+
+/** Run the registered benchmarks, as selected by `argv`; see above. */
+inline int main(int argc, char ** argv) {
+    config settings;
+    c_cstr json_path = nullptr;
+    std::vector<std::string_view> filters;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view const arg = argv[i];
+        if (arg == "--quick") { settings = config::quick(); }
+        else if (arg == "--json" && i + 1 < argc) { json_path = argv[++i]; }
+        else { filters.push_back(arg); }
+    }
+
+    std::vector<suite> suites;
+    for (auto const & [name, fn] : registry()) {
+        std::string_view const view = name;
+        bool const selected = filters.empty()
+            || std::any_of(filters.begin(), filters.end(), [&](auto f) {
+                   return view.find(f) != std::string_view::npos;
+               });
+        if (!selected) { continue; }
+        suites.emplace_back(name, settings);
+        fn(suites.back());
+    }
+
+    bool failed = false;
+    for (auto const & s : suites) {
+        for (auto const & e : s.expectations()) { failed |= !e.passed; }
+    }
+
+    if (json_path) {
+        std::string text;
+        write_json(text, suites);
+        if (std::strcmp(json_path, "-") == 0) {
+            std::cout.write(text.data(), std::streamsize(text.size()));
+        } else {
+            std::ofstream file { json_path };
+            file.write(text.data(), std::streamsize(text.size()));
+            if (!file) {
+                fmt::print(stderr, "Couldn't write {}\n", json_path);
+                failed = true;
+            }
+        }
+    }
+    return failed ? 1 : 0;
+}
+
+} /* namespace benchmark */
+} /* namespace nonstd */
+
+
+#if defined(NONSTD_BENCHMARK_MAIN)
+int main(int argc, char ** argv) {
+    return ::nonstd::benchmark::main(argc, argv);
+}
+#endif
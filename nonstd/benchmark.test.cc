@@ -0,0 +1,158 @@
+/** Micro-Benchmark Harness Tests
+ *  =============================
+ *  GOAL: Validate that the harness's statistics are right -- quartiles,
+ *  outlier rejection, and the confidence interval of the mean -- that its JSON
+ *  is well-formed however benchmarks are named, and that measurements scale
+ *  with the work measured, per call or per operation.
+ */
+
+#include <nonstd/benchmark.h>
+#include <platform/testrunner/testrunner.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/chrono.h>
+
+
+namespace nonstd_test::benchmark {
+
+namespace bench = nonstd::benchmark;
+using namespace nonstd::literals::chrono_literals;
+
+
+TEST_CASE("Benchmark Statistics", "[nonstd][benchmark]") {
+    SECTION("summarize samples") {
+        auto const s = bench::detail::summarize({ 4, 2, 3, 1, 5 }, 0.0);
+        REQUIRE(s.samples == 5);
+        REQUIRE(s.outliers == 0);
+        REQUIRE(s.median == Approx(3.0));
+        REQUIRE(s.mean == Approx(3.0));
+        REQUIRE(s.stddev == Approx(1.5811388));
+        REQUIRE(s.min == 1.0);
+        REQUIRE(s.max == 5.0);
+        // t(0.975, 4) * 1.5811 / sqrt(5)
+        REQUIRE(s.ci_low == Approx(3.0 - 1.9629).epsilon(1e-4));
+        REQUIRE(s.ci_high == Approx(3.0 + 1.9629).epsilon(1e-4));
+
+        auto const one = bench::detail::summarize({ 7 }, 1.5);
+        REQUIRE(one.samples == 1);
+        REQUIRE(one.stddev == 0.0);
+        REQUIRE(one.ci_low == 7.0);
+        REQUIRE(bench::detail::summarize({ }, 1.5).samples == 0);
+    }
+
+    SECTION("reject outliers beyond Tukey's fences") {
+        std::vector<f64> samples { 10, 11, 10, 12, 11, 10, 11, 250, 10, 1 };
+        auto const kept = bench::detail::summarize(samples, 1.5);
+        REQUIRE(kept.outliers == 2);
+        REQUIRE(kept.samples == 8);
+        REQUIRE(kept.min == 10.0);
+        REQUIRE(kept.max == 12.0);
+
+        auto const all = bench::detail::summarize(samples, 0.0);
+        REQUIRE(all.outliers == 0);
+        REQUIRE(all.max == 250.0);
+    }
+
+    SECTION("approximate Student's t") {
+        REQUIRE(bench::detail::t_975(1) == Approx(12.706));
+        REQUIRE(bench::detail::t_975(10) == Approx(2.228));
+        REQUIRE(bench::detail::t_975(11) == Approx(2.201).epsilon(1e-3));
+        REQUIRE(bench::detail::t_975(30) == Approx(2.042).epsilon(1e-3));
+        REQUIRE(bench::detail::t_975(1000) == Approx(1.962).epsilon(1e-3));
+    }
+}
+
+
+TEST_CASE("Benchmark Harness", "[nonstd][benchmark]") {
+    bench::config settings;
+    settings.warmup      = 1ms;
+    settings.sample_time = 200us;
+    settings.samples     = 10;
+
+    SECTION("measure per-call time, in proportion to the work") {
+        auto spin = [](u32 n) {
+            return [n] {
+                for (u32 i = 0; i < n; ++i) {
+                    nonstd::do_not_optimize(i);
+                }
+            };
+        };
+        auto const little = bench::measure("little", spin(100), settings);
+        auto const lots   = bench::measure("lots", spin(10'000), settings);
+        REQUIRE(little.stats.samples + little.stats.outliers == 10);
+        REQUIRE(little.iterations > lots.iterations);
+        REQUIRE(little.stats.median > 0.0);
+        REQUIRE(lots.stats.median > 10.0 * little.stats.median);
+        REQUIRE(lots.stats.ci_low <= lots.stats.mean);
+        REQUIRE(lots.stats.ci_high >= lots.stats.mean);
+    }
+
+    SECTION("report per operation, and time manually timed batches") {
+        auto spin = [] {
+            for (u32 i = 0; i < 1'000; ++i) { nonstd::do_not_optimize(i); }
+        };
+        auto const per_call = bench::measure("call", spin, settings);
+        auto const per_op   = bench::measure("op", spin, settings, 1'000);
+        REQUIRE(per_op.operations == 1'000);
+        REQUIRE(per_op.stats.median < per_call.stats.median / 100.0);
+
+        // Only the fixed 100us per call counts, however long setup takes.
+        auto const manual = bench::measure_manual("manual",
+            [&](u64 iterations) {
+                spin();
+                return std::chrono::nanoseconds { 100us } * iterations;
+            }, settings);
+        REQUIRE(manual.stats.median == Approx(100'000.0));
+        REQUIRE(manual.iterations == 2);
+
+        // Batches that report no time at all still finish.
+        auto const nothing = bench::measure_manual("nothing",
+            [](u64) { return std::chrono::nanoseconds { 0 }; }, settings);
+        REQUIRE(nothing.stats.median == 0.0);
+    }
+
+    SECTION("time threads released together") {
+        std::atomic<u32> ran { 0 };
+        auto const elapsed = bench::time_threads(4, [&](u32 t) {
+            ran.fetch_or(1u << t);
+            if (t == 3) { std::this_thread::sleep_for(2ms); }
+        });
+        REQUIRE(ran.load() == 0b1111);
+        REQUIRE(elapsed >= 2ms);
+        REQUIRE(elapsed < 1s);
+    }
+
+    SECTION("check expected speedups, and report them as JSON") {
+        std::vector<bench::suite> suites;
+        suites.emplace_back("quote\"d\n", settings);
+        auto & s = suites.back();
+        auto const slow = s.run("slow", [] {
+            u64 x = 0;
+            for (u32 i = 0; i < 2'000; ++i) { nonstd::do_not_optimize(x += i); }
+        });
+        auto const fast = s.run("fast", [] {
+            u64 x = 0;
+            nonstd::do_not_optimize(x);
+        });
+        REQUIRE(s.expect_speedup(slow, fast, 2.0, "fast is faster"));
+        REQUIRE_FALSE(s.expect_speedup(fast, slow, 2.0, "slow is faster"));
+        REQUIRE(s.expectations().size() == 2);
+        REQUIRE(s.results()[0].name == "quote\"d\n/slow");
+
+        std::string json;
+        bench::write_json(json, suites);
+        REQUIRE(json.find(R"("name":"quote\"d\n/slow")") != std::string::npos);
+        REQUIRE(json.find(R"("claim":"fast is faster")") != std::string::npos);
+        REQUIRE(json.find(R"("passed":true)") != std::string::npos);
+        REQUIRE(json.find(R"("passed":false)") != std::string::npos);
+        REQUIRE(json.back() == '\n');
+    }
+}
+
+} /* namespace nonstd_test::benchmark */
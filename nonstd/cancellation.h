@@ -0,0 +1,365 @@
+/** Cooperative Cancellation
+ *  ========================
+ *  A `cancellation_source` is held by whoever may want work abandoned -- the
+ *  consumer of a result, a request handler, a timeout. It hands out any number
+ *  of `cancellation_token`s to the code doing the work, which polls them or
+ *  registers callbacks on them, and stops early once cancellation has been
+ *  requested.
+ *
+ *      nonstd::cancellation_source source;
+ *      nonstd::cancellation_token token = source.token();
+ *      jobs.run_jobs(decls, count, &counter, &token);
+ *      ...
+ *      source.request_cancellation();  // queued jobs that haven't started
+ *                                      // are skipped
+ *
+ *  Work that's blocked on something other than the token can register a
+ *  `cancellation_callback` to unblock itself. The callback runs exactly once;
+ *  either on the thread that requests cancellation, or immediately -- inside
+ *  the callback's constructor -- if cancellation was already requested.
+ *  Destroying a callback deregisters it, and if it's running on another thread
+ *  at the time, waits for it to finish. Callbacks must not throw.
+ *
+ *      nonstd::cancellation_callback wake { token, [&] { cv.notify_all(); } };
+ *
+ *  A `deadline` is a point on the `wallclock` timeline (or `never`). Deadlines
+ *  don't cancel anything on their own; pair them with a timer that requests
+ *  cancellation when they pass;
+ *
+ *      nonstd::timer_wheel<nonstd::cancellation_source> timeouts { 1000_Hz };
+ *      timeouts.schedule_at(deadline, source);
+ *      ...
+ *      timeouts.poll([](auto source) { source.request_cancellation(); });
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/chrono.h>
+#include <nonstd/wallclock.h>
+
+
+namespace nonstd {
+
+class cancellation_source;
+class cancellation_token;
+template <typename Fn> class cancellation_callback;
+
+
+namespace detail::cancellation_ {
+
+struct callback_node {
+    void (*run)(callback_node * self) noexcept = nullptr;
+    callback_node * prev   = nullptr;
+    callback_node * next   = nullptr;
+    bool            linked = false;
+};
+
+/** Shared Cancellation State
+ *  -------------------------
+ *  The request flag is checked lock-free. Callback (de)registration and the
+ *  request itself are serialized by a mutex, which is dropped while each
+ *  callback runs s.t. callbacks can touch other tokens and sources freely.
+ */
+class state {
+private:
+    std::atomic<bool>            m_requested;
+    std::mutex                   m_mutex;
+    callback_node *              m_head;
+    std::atomic<callback_node *> m_running;
+    std::thread::id              m_requesting_thread;
+
+    void unlink(callback_node * node) noexcept {
+        if (node->prev) { node->prev->next = node->next; }
+        else            { m_head = node->next; }
+        if (node->next) { node->next->prev = node->prev; }
+        node->prev = nullptr;
+        node->next = nullptr;
+        node->linked = false;
+    }
+
+public:
+    state() noexcept
+        : m_requested         ( false )
+        , m_mutex             ( )
+        , m_head              ( nullptr )
+        , m_running           ( nullptr )
+        , m_requesting_thread ( )
+    { }
+
+    bool requested() const noexcept {
+        return m_requested.load(std::memory_order_acquire);
+    }
+
+    /** Set the request flag and run every registered callback. Returns false
+     *  if cancellation had already been requested.
+     */
+    bool request() noexcept {
+        std::unique_lock<std::mutex> lock { m_mutex };
+        if (m_requested.load(std::memory_order_relaxed)) { return false; }
+        m_requesting_thread = std::this_thread::get_id();
+        m_requested.store(true, std::memory_order_release);
+
+        while (m_head) {
+            callback_node * node = m_head;
+            unlink(node);
+            m_running.store(node, std::memory_order_relaxed);
+            lock.unlock();
+            node->run(node);
+            lock.lock();
+            m_running.store(nullptr, std::memory_order_release);
+        }
+        return true;
+    }
+
+    /** Register `node`. Returns false -- and doesn't register -- if
+     *  cancellation has already been requested.
+     */
+    bool add(callback_node * node) noexcept {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        if (m_requested.load(std::memory_order_relaxed)) { return false; }
+        node->prev = nullptr;
+        node->next = m_head;
+        if (m_head) { m_head->prev = node; }
+        m_head = node;
+        node->linked = true;
+        return true;
+    }
+
+    /** Deregister `node`. If it's being run by another thread, wait for it. */
+    void remove(callback_node * node) noexcept {
+        std::unique_lock<std::mutex> lock { m_mutex };
+        if (node->linked) {
+            unlink(node);
+            return;
+        }
+        if (m_running.load(std::memory_order_relaxed) == node
+            && m_requesting_thread != std::this_thread::get_id()) {
+            lock.unlock();
+            while (m_running.load(std::memory_order_acquire) == node) {
+                std::this_thread::yield();
+            }
+        }
+    }
+};
+
+} /* namespace detail::cancellation_ */
+
+
+/** Cancellation Token
+ *  ------------------
+ *  The observing half. Default constructed tokens can never be cancelled.
+ */
+class cancellation_token {
+private:
+    std::shared_ptr<detail::cancellation_::state> m_state;
+
+    friend class cancellation_source;
+    template <typename Fn> friend class cancellation_callback;
+
+    explicit cancellation_token(
+        std::shared_ptr<detail::cancellation_::state> state) noexcept
+        : m_state ( std::move(state) )
+    { }
+
+public:
+    cancellation_token() noexcept = default;
+
+    bool cancellation_requested() const noexcept {
+        return m_state && m_state->requested();
+    }
+
+    bool can_be_cancelled() const noexcept {
+        return m_state != nullptr;
+    }
+
+    /** Throw a `std::system_error` carrying `nonstd::error::cancelled` if
+     *  cancellation has been requested.
+     */
+    void throw_if_cancelled() const {
+        if (cancellation_requested()) {
+            throw std::system_error { nonstd::error::cancelled };
+        }
+    }
+
+    friend bool operator== (cancellation_token const & lhs,
+                            cancellation_token const & rhs) noexcept {
+        return lhs.m_state == rhs.m_state;
+    }
+    friend bool operator!= (cancellation_token const & lhs,
+                            cancellation_token const & rhs) noexcept {
+        return lhs.m_state != rhs.m_state;
+    }
+};
+
+
+/** Cancellation Source
+ *  -------------------
+ *  The requesting half. Copies of a source share their state. Constructing a
+ *  source allocates that state, unless it's constructed with `no_state`.
+ */
+class cancellation_source {
+private:
+    std::shared_ptr<detail::cancellation_::state> m_state;
+
+public:
+    struct no_state_t { };
+    static constexpr no_state_t no_state { };
+
+    cancellation_source()
+        : m_state ( std::make_shared<detail::cancellation_::state>() )
+    { }
+    explicit cancellation_source(no_state_t /*unused*/) noexcept
+        : m_state ( nullptr )
+    { }
+
+    cancellation_token token() const noexcept {
+        return cancellation_token { m_state };
+    }
+
+    /** Request cancellation, running any registered callbacks on the calling
+     *  thread. Returns true if this call made the request.
+     */
+    bool request_cancellation() const noexcept {
+        return m_state && m_state->request();
+    }
+
+    bool cancellation_requested() const noexcept {
+        return m_state && m_state->requested();
+    }
+
+    bool has_state() const noexcept {
+        return m_state != nullptr;
+    }
+};
+
+
+/** Cancellation Callback
+ *  ---------------------
+ *  Runs `fn()` once, when `token` is cancelled. Neither copyable nor movable;
+ *  the callback is registered by address.
+ */
+template <typename Fn>
+class cancellation_callback : private detail::cancellation_::callback_node {
+private:
+    std::shared_ptr<detail::cancellation_::state> m_state;
+    Fn                                            m_fn;
+
+    static void invoke(detail::cancellation_::callback_node * self) noexcept {
+        static_cast<cancellation_callback *>(self)->m_fn();
+    }
+
+public:
+    template <typename F>
+    cancellation_callback(cancellation_token const & token, F && fn)
+        : m_state ( token.m_state )
+        , m_fn    ( std::forward<F>(fn) )
+    {
+        this->run = &cancellation_callback::invoke;
+        if (m_state && !m_state->add(this)) {
+            m_state.reset();
+            m_fn();
+        }
+    }
+
+    cancellation_callback(cancellation_callback const &) = delete;
+    cancellation_callback(cancellation_callback &&) = delete;
+    cancellation_callback& operator= (cancellation_callback const &) = delete;
+    cancellation_callback& operator= (cancellation_callback &&) = delete;
+
+    ~cancellation_callback() {
+        if (m_state) { m_state->remove(this); }
+    }
+};
+
+template <typename Fn>
+cancellation_callback(cancellation_token const &, Fn)
+    -> cancellation_callback<Fn>;
+
+
+/** Deadline
+ *  --------
+ *  A point in `wallclock` time after which work should be abandoned.
+ */
+class deadline {
+private:
+    chrono::nanoseconds m_when;
+
+    constexpr explicit deadline(chrono::nanoseconds when) noexcept
+        : m_when ( when )
+    { }
+
+public:
+    static constexpr deadline never() noexcept {
+        return deadline { chrono::nanoseconds::max() };
+    }
+    static constexpr deadline at(chrono::nanoseconds when) noexcept {
+        return deadline { when };
+    }
+    template <typename Rep, typename Period>
+    static deadline after(chrono::duration<Rep, Period> const & timeout) {
+        auto const now = wallclock::now();
+        auto const ns  = chrono::ceil<chrono::nanoseconds>(timeout);
+        if (ns >= chrono::nanoseconds::max() - now) { return never(); }
+        return deadline { now + ns };
+    }
+
+    /** The `wallclock` time of the deadline. */
+    constexpr chrono::nanoseconds when() const noexcept { return m_when; }
+
+    /** The deadline as a `steady_clock` time point, for use with standard
+     *  library waits.
+     */
+    chrono::steady_clock::time_point time_point() const noexcept {
+        using tp = chrono::steady_clock::time_point;
+        if (is_never()) { return tp::max(); }
+        return tp { chrono::duration_cast<tp::duration>(m_when) };
+    }
+
+    constexpr bool is_never() const noexcept {
+        return m_when == chrono::nanoseconds::max();
+    }
+
+    bool expired() const noexcept {
+        return !is_never() && wallclock::now() >= m_when;
+    }
+
+    /** Time left until the deadline; zero once it's passed. */
+    chrono::nanoseconds remaining() const noexcept {
+        if (is_never()) { return chrono::nanoseconds::max(); }
+        auto const left = m_when - wallclock::now();
+        return n2max(left, chrono::nanoseconds::zero());
+    }
+
+    /** Throw a `std::system_error` carrying `nonstd::error::deadline_exceeded`
+     *  if the deadline has passed.
+     */
+    void throw_if_expired() const {
+        if (expired()) {
+            throw std::system_error { nonstd::error::deadline_exceeded };
+        }
+    }
+
+    friend constexpr deadline earliest(deadline lhs, deadline rhs) noexcept {
+        return lhs.m_when < rhs.m_when ? lhs : rhs;
+    }
+
+    friend constexpr bool operator== (deadline lhs, deadline rhs) noexcept {
+        return lhs.m_when == rhs.m_when;
+    }
+    friend constexpr bool operator!= (deadline lhs, deadline rhs) noexcept {
+        return lhs.m_when != rhs.m_when;
+    }
+    friend constexpr bool operator<  (deadline lhs, deadline rhs) noexcept {
+        return lhs.m_when < rhs.m_when;
+    }
+};
+
+} /* namespace nonstd */
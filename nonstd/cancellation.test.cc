@@ -0,0 +1,194 @@
+/** Cooperative Cancellation Tests
+ *  ==============================
+ *  GOAL: Validate that cancellation requests reach tokens and callbacks exactly
+ *  once, and that promises, the job system, and timer wheels observe them.
+ */
+
+#include <nonstd/cancellation.h>
+#include <platform/testrunner/testrunner.h>
+
+#include <atomic>
+#include <system_error>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/future.h>
+#include <nonstd/job_system.h>
+#include <nonstd/timer_wheel.h>
+
+
+namespace nonstd_test::cancellation {
+
+using nonstd::cancellation_callback;
+using nonstd::cancellation_source;
+using nonstd::cancellation_token;
+using nonstd::deadline;
+using namespace nonstd::literals::chrono_literals;
+
+
+TEST_CASE("Cancellation Sources and Tokens", "[nonstd][cancellation]") {
+    SECTION("default constructed tokens are never cancelled") {
+        cancellation_token token;
+        REQUIRE_FALSE(token.can_be_cancelled());
+        REQUIRE_FALSE(token.cancellation_requested());
+        REQUIRE_NOTHROW(token.throw_if_cancelled());
+    }
+
+    SECTION("tokens observe their source") {
+        cancellation_source source;
+        auto token = source.token();
+        REQUIRE(token.can_be_cancelled());
+        REQUIRE_FALSE(token.cancellation_requested());
+
+        REQUIRE(source.request_cancellation());
+        REQUIRE_FALSE(source.request_cancellation());
+        REQUIRE(token.cancellation_requested());
+
+        try {
+            token.throw_if_cancelled();
+            FAIL("throw_if_cancelled didn't throw");
+        } catch (std::system_error const & e) {
+            REQUIRE(e.code() == nonstd::error::cancelled);
+        }
+    }
+
+    SECTION("run callbacks once, on request") {
+        cancellation_source source;
+        i32 calls = 0;
+        cancellation_callback callback { source.token(), [&] { calls += 1; } };
+        REQUIRE(calls == 0);
+        source.request_cancellation();
+        source.request_cancellation();
+        REQUIRE(calls == 1);
+    }
+
+    SECTION("run callbacks immediately if already cancelled") {
+        cancellation_source source;
+        source.request_cancellation();
+        i32 calls = 0;
+        cancellation_callback callback { source.token(), [&] { calls += 1; } };
+        REQUIRE(calls == 1);
+    }
+
+    SECTION("don't run deregistered callbacks") {
+        cancellation_source source;
+        i32 calls = 0;
+        {
+            cancellation_callback callback { source.token(),
+                                             [&] { calls += 1; } };
+        }
+        source.request_cancellation();
+        REQUIRE(calls == 0);
+    }
+}
+
+
+TEST_CASE("Deadlines", "[nonstd][cancellation]") {
+    SECTION("never expire when they're never") {
+        auto d = deadline::never();
+        REQUIRE(d.is_never());
+        REQUIRE_FALSE(d.expired());
+        REQUIRE(d.remaining() == nonstd::chrono::nanoseconds::max());
+    }
+
+    SECTION("expire after their timeout") {
+        auto d = deadline::after(1ms);
+        REQUIRE_FALSE(d.is_never());
+        nonstd::wallclock::delay(2ms);
+        REQUIRE(d.expired());
+        REQUIRE(d.remaining() == nonstd::chrono::nanoseconds::zero());
+        REQUIRE_THROWS_AS(d.throw_if_expired(), std::system_error);
+    }
+
+    SECTION("order, earliest first") {
+        auto soon  = deadline::after(1s);
+        auto later = deadline::after(1h);
+        REQUIRE(soon < later);
+        REQUIRE(earliest(later, soon) == soon);
+        REQUIRE(earliest(deadline::never(), soon) == soon);
+    }
+}
+
+
+TEST_CASE("Cancellation Observers", "[nonstd][cancellation]") {
+    SECTION("abandoned futures cancel their promise") {
+        nonstd::promise<i32> promise;
+        {
+            auto future = promise.get_future();
+            REQUIRE_FALSE(promise.cancellation_requested());
+        }
+        REQUIRE(promise.cancellation_requested());
+    }
+
+    SECTION("futures assigned over cancel their promise") {
+        nonstd::promise<i32> first;
+        nonstd::promise<i32> second;
+        auto future = first.get_future();
+        future = second.get_future();
+        REQUIRE(first.cancellation_requested());
+        REQUIRE_FALSE(second.cancellation_requested());
+
+        second.set_value(3);
+        future = nonstd::future<i32> { };
+        REQUIRE_FALSE(second.cancellation_requested());
+    }
+
+    SECTION("futures of fulfilled promises don't cancel") {
+        nonstd::promise<i32> promise;
+        {
+            auto future = promise.get_future();
+            promise.set_value(42);
+        }
+        REQUIRE_FALSE(promise.cancellation_requested());
+    }
+
+    SECTION("futures wait on deadlines") {
+        nonstd::promise<i32> promise;
+        auto future = promise.get_future();
+        REQUIRE(future.wait_until(deadline::after(1ms))
+                == nonstd::future_status::timeout);
+        promise.set_value(7);
+        REQUIRE(future.wait_until(deadline::never())
+                == nonstd::future_status::ready);
+    }
+
+    SECTION("job systems skip cancelled jobs") {
+        nonstd::job_system::config cfg;
+        cfg.worker_count = 1;
+        nonstd::job_system jobs { cfg };
+
+        cancellation_source source;
+        auto token = source.token();
+        std::atomic<i32> ran { 0 };
+        auto first = [&] {
+            ran.fetch_add(1);
+            source.request_cancellation();
+        };
+        auto rest = [&] { ran.fetch_add(1); };
+
+        std::vector<nonstd::job_decl> decls (100, nonstd::job_decl::from(rest));
+        decls[0] = nonstd::job_decl::from(first);
+        nonstd::job_counter counter;
+        jobs.run_jobs(decls.data(), decls.size(), &counter, &token);
+        jobs.wait_for_counter(counter);
+
+        // With one worker, the jobs run in order; only the first runs.
+        REQUIRE(counter.value() == 0);
+        REQUIRE(ran.load() == 1);
+    }
+
+    SECTION("timer wheels schedule on deadlines") {
+        nonstd::timer_wheel<cancellation_source> timeouts {
+            1000_Hz, nonstd::chrono::nanoseconds::zero() };
+        cancellation_source source;
+
+        REQUIRE_FALSE(timeouts.schedule_at(deadline::never(), source).valid());
+        timeouts.schedule_at(deadline::at(5ms), source);
+        timeouts.advance_to(5ms, [](cancellation_source s) {
+            s.request_cancellation();
+        });
+        REQUIRE(source.cancellation_requested());
+    }
+}
+
+} /* namespace nonstd_test::cancellation */
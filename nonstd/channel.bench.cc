@@ -0,0 +1,54 @@
+/** Channel Benchmarks
+ *  ==================
+ *  Throughput; values pushed through a small channel by N producers to N
+ *  consumers, for N in { 1, 2, 8, 32 }, reported per message. The threads
+ *  are started before, and joined after, the timed part. Every message is
+ *  checked off by the sum of everything received; a benchmark of a channel
+ *  that loses or duplicates messages is no benchmark at all.
+ */
+
+#include <nonstd/channel.h>
+#include <nonstd/benchmark.h>
+
+#include <atomic>
+
+#include <nonstd/nonstd.h>
+
+
+namespace nonstd_bench::channel {
+
+using nonstd::benchmark::time_threads;
+using nonstd::channel;
+
+
+NONSTD_BENCHMARK("channel throughput") {
+    // Messages per iteration, split between the producers.
+    u64 const total = 1 << 14;
+    for (u32 pairs : { 1u, 2u, 8u, 32u }) {
+        u64 const per_producer = total / pairs;
+        bench.run_manual(fmt::format("channel<u64>, {}P/{}C", pairs, pairs),
+            [&](u64 iterations) {
+                u64 const count = per_producer * iterations;
+                channel<u64> ch { 1024 };
+                std::atomic<u32> producing { pairs };
+                std::atomic<u64> received_sum { 0 };
+                auto const elapsed = time_threads(2 * pairs, [&](u32 t) {
+                    if (t < pairs) {
+                        for (u64 i = 1; i <= count; ++i) { ch.send(i); }
+                        if (producing.fetch_sub(1) == 1) { ch.close(); }
+                    } else {
+                        u64 sum = 0;
+                        while (auto value = ch.recv()) { sum += *value; }
+                        received_sum.fetch_add(sum);
+                    }
+                });
+                BREAK_UNLESS(received_sum.load()
+                             == pairs * (count * (count + 1) / 2),
+                             nonstd::error::error,
+                             "Messages were lost or duplicated.");
+                return elapsed;
+            }, pairs * per_producer);
+    }
+}
+
+} /* namespace nonstd_bench::channel */
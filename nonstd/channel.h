@@ -0,0 +1,263 @@
+/** Channels
+ *  ========
+ *  A bounded, multi-producer multi-consumer pipe for handing values between
+ *  threads; the lock-free `mpmc_queue` with blocking, closing, and
+ *  asynchronous receipt layered on top.
+ *
+ *      nonstd::channel<work_item> work { 1024 };
+ *
+ *      // producers                      // consumers
+ *      work.send(make_item());           while (auto item = work.recv()) {
+ *      ...                                   process(*item);
+ *      work.close();                     }
+ *
+ *  Non-blocking `try_send` and `try_recv` cost exactly what the underlying
+ *  queue costs, plus one fence and a relaxed load to check for sleepers. The
+ *  blocking `send` and `recv` spin briefly, then sleep on a futex word that
+ *  the other side bumps only when it knows somebody is asleep. Uncontended
+ *  traffic never makes a syscall.
+ *
+ *  Closing a channel fails all pending and future sends, and wakes every
+ *  blocked thread. Values already in the channel can still be received; once
+ *  they're drained, `recv` returns `nullopt`. Sends that race with `close` may
+ *  or may not succeed.
+ *
+ *  `recv_async` returns a `nonstd::future` that's fulfilled by whichever send
+ *  next has a value for it (or immediately, if one's waiting). Futures that
+ *  have been abandoned by the time a value is handed out are skipped, and the
+ *  value goes to the next receiver. Abandonment isn't synchronized with the
+ *  hand-off, though; a future destroyed while a send is handing it a value
+ *  may still take that value with it. Receivers that can't afford to lose
+ *  values shouldn't abandon their futures while the channel is open. If the
+ *  channel is closed first, the future holds a `std::system_error` carrying
+ *  `nonstd::error::channel_closed`. Async receivers take a lock; prefer `recv`
+ *  on hot paths.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <utility>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/future.h>
+#include <nonstd/futex.h>
+#include <nonstd/mpmc_queue.h>
+#include <nonstd/optional.h>
+
+
+namespace nonstd {
+
+template <typename T>
+class channel {
+private:
+    /** A futex word, and a count of the threads sleeping on it. */
+    struct ALIGNAS(cache_line_size) sleepers {
+        std::atomic<u32> epoch   { 0 };
+        std::atomic<u32> waiting { 0 };
+    };
+
+    static constexpr u32 spin_limit = 64;
+
+    mpmc_queue<T>          m_queue;
+    sleepers               m_senders;
+    sleepers               m_receivers;
+    std::atomic<bool>      m_closed;
+    std::atomic<u32>       m_async_waiting;
+    std::mutex             m_async_mutex;
+    std::deque<promise<T>> m_async;
+
+public:
+    /** Construct a channel that holds at least `capacity` values. */
+    explicit channel(u64 capacity)
+        : m_queue         ( capacity )
+        , m_senders       ( )
+        , m_receivers     ( )
+        , m_closed        ( false )
+        , m_async_waiting ( 0 )
+        , m_async_mutex   ( )
+        , m_async         ( )
+    { }
+
+    channel(channel const &) = delete;
+    channel(channel &&) = delete;
+    channel& operator= (channel const &) = delete;
+    channel& operator= (channel &&) = delete;
+
+    ~channel() { close(); }
+
+    u64  capacity()    const noexcept { return m_queue.capacity(); }
+    u64  size_approx() const noexcept { return m_queue.size_approx(); }
+    bool is_closed()   const noexcept {
+        return m_closed.load(std::memory_order_acquire);
+    }
+
+
+    /** Send
+     *  ----
+     *  `try_send` fails if the channel is full or closed. `send` blocks while
+     *  the channel is full, and fails if it's closed. Values are only moved
+     *  from if the send succeeds.
+     */
+    bool try_send(T const & value) { return try_send_impl(value); }
+    bool try_send(T && value)      { return try_send_impl(std::move(value)); }
+
+    bool send(T const & value) { return send_impl(value); }
+    bool send(T && value)      { return send_impl(std::move(value)); }
+
+
+    /** Receive
+     *  -------
+     *  `try_recv` returns `nullopt` if the channel is empty. `recv` blocks
+     *  while the channel is empty and open, and returns `nullopt` once it's
+     *  closed and drained.
+     */
+    optional<T> try_recv() {
+        auto value = m_queue.try_pop();
+        if (value) { wake_one(m_senders); }
+        return value;
+    }
+
+    optional<T> recv() {
+        while (true) {
+            if (auto value = try_recv()) { return value; }
+            if (is_closed()) { return try_recv(); }
+            sleep_until(m_receivers, [this] {
+                return m_closed.load(std::memory_order_relaxed)
+                    || m_queue.size_approx() > 0;
+            });
+        }
+    }
+
+    future<T> recv_async() {
+        promise<T> receiver;
+        future<T> result = receiver.get_future();
+        if (auto value = try_recv()) {
+            receiver.set_value(std::move(*value));
+            return result;
+        }
+
+        std::lock_guard<std::mutex> lock { m_async_mutex };
+        if (is_closed()) {
+            if (auto value = try_recv()) {
+                receiver.set_value(std::move(*value));
+            } else {
+                receiver.set_exception(closed_exception());
+            }
+            return result;
+        }
+        m_async.push_back(std::move(receiver));
+        m_async_waiting.fetch_add(1, std::memory_order_seq_cst);
+        // Pairs with the fence in `wake_one`; either the sender sees us
+        // waiting, or we see its value here.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        pump_async();
+        return result;
+    }
+
+
+    /** Close the channel. Returns false if it was already closed. */
+    bool close() {
+        if (m_closed.exchange(true, std::memory_order_acq_rel)) {
+            return false;
+        }
+        wake_all(m_senders);
+        wake_all(m_receivers);
+
+        std::lock_guard<std::mutex> lock { m_async_mutex };
+        pump_async();
+        for (auto & receiver : m_async) {
+            receiver.set_exception(closed_exception());
+        }
+        m_async.clear();
+        m_async_waiting.store(0, std::memory_order_relaxed);
+        return true;
+    }
+
+
+private:
+    template <typename U>
+    bool try_send_impl(U && value) {
+        if (is_closed()) { return false; }
+        if (!m_queue.try_push(std::forward<U>(value))) { return false; }
+        wake_one(m_receivers);
+        if (m_async_waiting.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock { m_async_mutex };
+            pump_async();
+        }
+        return true;
+    }
+
+    template <typename U>
+    bool send_impl(U && value) {
+        while (true) {
+            if (try_send_impl(std::forward<U>(value))) { return true; }
+            if (is_closed()) { return false; }
+            sleep_until(m_senders, [this] {
+                return m_closed.load(std::memory_order_relaxed)
+                    || m_queue.size_approx() < m_queue.capacity();
+            });
+        }
+    }
+
+    /** Spin briefly, then sleep, until `ready()` or a wake-up. May return
+     *  spuriously; callers re-check their condition.
+     */
+    template <typename Ready>
+    static void sleep_until(sleepers & s, Ready && ready) noexcept {
+        for (u32 spin = 0; spin < spin_limit; ++spin) {
+            if (ready()) { return; }
+            cpu_relax();
+        }
+        s.waiting.fetch_add(1, std::memory_order_seq_cst);
+        u32 const epoch = s.epoch.load(std::memory_order_acquire);
+        // Pairs with the fence in `wake_one`; either the other side sees us
+        // waiting, or we see the state change it made.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!ready()) { futex_wait(s.epoch, epoch); }
+        s.waiting.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    static void wake_one(sleepers & s) noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (s.waiting.load(std::memory_order_relaxed) > 0) {
+            s.epoch.fetch_add(1, std::memory_order_release);
+            futex_wake_one(s.epoch);
+        }
+    }
+
+    static void wake_all(sleepers & s) noexcept {
+        s.epoch.fetch_add(1, std::memory_order_release);
+        futex_wake_all(s.epoch);
+    }
+
+    /** Hand queued values to async receivers. Requires `m_async_mutex`.
+     *
+     *  Receivers already abandoned are skipped. One abandoned after the check
+     *  still gets its value, which is then lost with it; see above.
+     */
+    void pump_async() {
+        while (!m_async.empty()) {
+            auto & receiver = m_async.front();
+            if (!receiver.cancellation_requested()) {
+                auto value = m_queue.try_pop();
+                if (!value) { return; }
+                receiver.set_value(std::move(*value));
+                wake_one(m_senders);
+            }
+            m_async.pop_front();
+            m_async_waiting.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    static std::exception_ptr closed_exception() {
+        return std::make_exception_ptr(
+            std::system_error { nonstd::error::channel_closed });
+    }
+};
+
+} /* namespace nonstd */
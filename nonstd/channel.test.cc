@@ -0,0 +1,141 @@
+/** Channel Tests
+ *  =============
+ *  GOAL: Validate that every value sent is received exactly once -- through
+ *  blocking, non-blocking, and async receives -- and that closing a channel
+ *  releases everybody waiting on it.
+ */
+
+#include <nonstd/channel.h>
+#include <platform/testrunner/testrunner.h>
+
+#include <atomic>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/wallclock.h>
+
+
+namespace nonstd_test::channel {
+
+using nonstd::channel;
+using namespace nonstd::literals::chrono_literals;
+
+
+/** Run `pairs` producers and `pairs` consumers over `ch`, each producer
+ *  sending `per_producer` values. Returns the sum of everything received.
+ */
+u64 pump(channel<u64> & ch, u32 pairs, u64 per_producer) {
+    std::atomic<u64> received_sum { 0 };
+    std::vector<std::thread> threads;
+    for (u32 p = 0; p < pairs; ++p) {
+        threads.emplace_back([&ch, per_producer] {
+            for (u64 i = 1; i <= per_producer; ++i) { ch.send(i); }
+        });
+    }
+    for (u32 c = 0; c < pairs; ++c) {
+        threads.emplace_back([&ch, &received_sum] {
+            u64 sum = 0;
+            while (auto value = ch.recv()) { sum += *value; }
+            received_sum.fetch_add(sum);
+        });
+    }
+    for (u32 p = 0; p < pairs; ++p) { threads[p].join(); }
+    ch.close();
+    for (u32 c = pairs; c < threads.size(); ++c) { threads[c].join(); }
+    return received_sum.load();
+}
+
+
+TEST_CASE("Channels", "[nonstd][channel]") {
+    SECTION("send and receive without blocking") {
+        channel<i32> ch { 4 };
+        REQUIRE(ch.capacity() == 4);
+        REQUIRE_FALSE(ch.try_recv());
+
+        for (i32 i = 0; i < 4; ++i) { REQUIRE(ch.try_send(i)); }
+        REQUIRE_FALSE(ch.try_send(4));
+
+        for (i32 i = 0; i < 4; ++i) { REQUIRE(*ch.try_recv() == i); }
+        REQUIRE_FALSE(ch.try_recv());
+    }
+
+    SECTION("drain after closing, then report closed") {
+        channel<i32> ch { 4 };
+        ch.send(1);
+        ch.send(2);
+        REQUIRE(ch.close());
+        REQUIRE_FALSE(ch.close());
+        REQUIRE_FALSE(ch.send(3));
+        REQUIRE(*ch.recv() == 1);
+        REQUIRE(*ch.recv() == 2);
+        REQUIRE_FALSE(ch.recv());
+    }
+
+    SECTION("wake blocked receivers on close") {
+        channel<i32> ch { 4 };
+        std::atomic<bool> got_nothing { false };
+        std::thread receiver { [&] { got_nothing = !ch.recv(); } };
+        nonstd::wallclock::delay(5ms);
+        ch.close();
+        receiver.join();
+        REQUIRE(got_nothing.load());
+    }
+
+    SECTION("block senders while full") {
+        channel<i32> ch { 2 };
+        ch.send(0);
+        ch.send(1);
+        std::atomic<bool> sent { false };
+        std::thread sender { [&] { sent = ch.send(2); } };
+        nonstd::wallclock::delay(5ms);
+        REQUIRE_FALSE(sent.load());
+        REQUIRE(*ch.recv() == 0);
+        sender.join();
+        REQUIRE(sent.load());
+        REQUIRE(*ch.recv() == 1);
+        REQUIRE(*ch.recv() == 2);
+    }
+
+    SECTION("deliver every value exactly once under contention") {
+        channel<u64> ch { 16 };
+        u64 const per_producer = 2000;
+        u64 const expected = 4 * (per_producer * (per_producer + 1) / 2);
+        REQUIRE(pump(ch, 4, per_producer) == expected);
+    }
+
+    SECTION("fulfill async receivers") {
+        channel<i32> ch { 4 };
+        ch.send(1);
+        auto ready = ch.recv_async();
+        REQUIRE(ready.get() == 1);
+
+        auto pending = ch.recv_async();
+        REQUIRE(pending.wait_for(0s) == nonstd::future_status::timeout);
+        ch.send(2);
+        REQUIRE(pending.get() == 2);
+    }
+
+    SECTION("skip abandoned async receivers") {
+        channel<i32> ch { 4 };
+        { auto abandoned = ch.recv_async(); }
+        auto live = ch.recv_async();
+        ch.send(3);
+        REQUIRE(live.get() == 3);
+    }
+
+    SECTION("fail async receivers on close") {
+        channel<i32> ch { 4 };
+        auto pending = ch.recv_async();
+        ch.close();
+        try {
+            pending.get();
+            FAIL("recv_async on a closed channel didn't throw");
+        } catch (std::system_error const & e) {
+            REQUIRE(e.code() == nonstd::error::channel_closed);
+        }
+    }
+}
+
+} /* namespace nonstd_test::channel */
@@ -0,0 +1,46 @@
+/** Coarse Clock Benchmarks
+ *  =======================
+ *  The cost of a read; `coarse_clock` and `os_now()` against `steady_clock`
+ *  and `wallclock::now_ms()`.
+ */
+
+#include <nonstd/coarse_clock.h>
+#include <nonstd/benchmark.h>
+
+#include <chrono>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/wallclock.h>
+
+
+namespace nonstd_bench::coarse_clock {
+
+using nonstd::coarse_clock;
+using nonstd::do_not_optimize;
+
+
+NONSTD_BENCHMARK("coarse_clock reads") {
+    coarse_clock clock;
+    fmt::print("OS coarse clock resolution: {}ns\n",
+               coarse_clock::os_resolution().count());
+
+    auto const & steady = bench.run("steady_clock::now", [] {
+        do_not_optimize(std::chrono::steady_clock::now());
+    });
+    bench.run("wallclock::now_ms", [] {
+        do_not_optimize(nonstd::wallclock::now_ms());
+    });
+    bench.run("coarse_clock::os_now", [] {
+        do_not_optimize(coarse_clock::os_now());
+    });
+    auto const & coarse = bench.run("coarse_clock::now", [&] {
+        do_not_optimize(clock.now());
+    });
+    bench.run("coarse_clock::now_ms", [&] {
+        do_not_optimize(clock.now_ms());
+    });
+    bench.expect_speedup(steady, coarse, 2.0,
+        "coarse_clock.h: a coarse read is cheaper than steady_clock::now()");
+}
+
+} /* namespace nonstd_bench::coarse_clock */
@@ -0,0 +1,159 @@
+/** Coarse Clock
+ *  ============
+ *  A clock for callers that only need to know roughly what time it is --
+ *  timeouts, cache expiry, rate-limited logging -- and would rather not pay
+ *  for `steady_clock::now()` (20-50ns) on every check.
+ *
+ *  A `coarse_clock` owns a background thread that writes `wallclock::now()`
+ *  into a cache-line-isolated atomic at a fixed rate (1kHz by default); reading
+ *  the time is then one relaxed load;
+ *
+ *      nonstd::coarse_clock clock { 1_kHz };
+ *      ...
+ *      if (clock.now() > deadline) { ... }
+ *
+ *  Readings share `wallclock::now()`'s epoch, never run backwards, and lag
+ *  the true time by up to one period, plus however late the ticker thread was
+ *  woken (usually tens of microseconds; more on a busy machine). Choose the
+ *  rate by the resolution needed; each tick costs the ticker a clock read and
+ *  a wake-up, and costs readers on other cores one cache miss.
+ *
+ *  Where there's no thread to spare, `os_now()` asks the OS for its own coarse
+ *  clock -- `CLOCK_MONOTONIC_COARSE` on Linux, which the vDSO serves from the
+ *  kernel's last timer tick without touching the hardware counter, at
+ *  `os_resolution()` (usually 1-4ms). Elsewhere it falls back to
+ *  `wallclock::now()`.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/chrono.h>
+#include <nonstd/wallclock.h>
+
+#if defined(NONSTD_OS_LINUX)
+#  include <time.h>
+#endif
+
+
+namespace nonstd {
+
+class coarse_clock {
+public:
+    /** Start a ticker that refreshes the time at `rate`. */
+    template <typename Rep, typename Period>
+    explicit coarse_clock(chrono::frequency<Rep, Period> rate)
+        : m_period ( chrono::round<chrono::nanoseconds>(
+                         chrono::duration<f64, std::nano> {
+                             f64 { 1.0 } / rate }) )
+    {
+        BREAK_UNLESS(m_period > chrono::nanoseconds::zero(),
+                     nonstd::error::pebcak,
+                     "A coarse_clock's rate must be positive, and below 1GHz.");
+        _tick(wallclock::now());
+        m_thread = std::thread { [this] { _run(); } };
+    }
+    coarse_clock() : coarse_clock ( chrono::hertz { 1000 } ) { }
+
+    coarse_clock(coarse_clock const &) = delete;
+    coarse_clock& operator= (coarse_clock const &) = delete;
+
+    ~coarse_clock() {
+        {
+            std::lock_guard<std::mutex> lock { m_mutex };
+            m_stop = true;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+    }
+
+    /** The time as of the last tick, on `wallclock::now()`'s epoch. */
+    chrono::nanoseconds now() const noexcept {
+        return chrono::nanoseconds {
+            m_time.ns.load(std::memory_order_relaxed)
+        };
+    }
+    /** `now()`, rounded to milliseconds like `wallclock::now_ms()`. */
+    chrono::milliseconds now_ms() const noexcept {
+        return chrono::milliseconds {
+            m_time.ms.load(std::memory_order_relaxed)
+        };
+    }
+
+    /** The time between ticks. */
+    chrono::nanoseconds period() const noexcept { return m_period; }
+
+
+    /** The OS's coarse monotonic clock, where it has one; otherwise
+     *  `wallclock::now()`.
+     */
+    static chrono::nanoseconds os_now() noexcept {
+#if defined(NONSTD_OS_LINUX) && defined(CLOCK_MONOTONIC_COARSE)
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+        return chrono::seconds { ts.tv_sec }
+             + chrono::nanoseconds { ts.tv_nsec };
+#else
+        return wallclock::now();
+#endif
+    }
+
+    /** How often `os_now()` advances. */
+    static chrono::nanoseconds os_resolution() noexcept {
+#if defined(NONSTD_OS_LINUX) && defined(CLOCK_MONOTONIC_COARSE)
+        timespec ts;
+        clock_getres(CLOCK_MONOTONIC_COARSE, &ts);
+        return chrono::seconds { ts.tv_sec }
+             + chrono::nanoseconds { ts.tv_nsec };
+#else
+        return chrono::nanoseconds { 1 };
+#endif
+    }
+
+private:
+    void _tick(chrono::nanoseconds now) noexcept {
+        m_time.ns.store(now.count(), std::memory_order_relaxed);
+        m_time.ms.store(chrono::round<chrono::milliseconds>(now).count(),
+                        std::memory_order_relaxed);
+    }
+
+    /** Tick at fixed multiples of the period, skipping any that a late
+     *  wake-up has already passed.
+     */
+    void _run() {
+        auto next = wallclock::now();
+        std::unique_lock<std::mutex> lock { m_mutex };
+        while (!m_stop) {
+            next += m_period;
+            m_wake.wait_until(lock, chrono::steady_clock::time_point {
+                chrono::duration_cast<chrono::steady_clock::duration>(next)
+            }, [this] { return m_stop; });
+
+            auto const now = wallclock::now();
+            _tick(now);
+            if (now - next >= m_period) { next = now; }
+        }
+    }
+
+    /** The time, alone on its cache line s.t. readers only miss when it
+     *  changes.
+     */
+    struct ALIGNAS(nonstd::cache_line_size) time_cell {
+        std::atomic<i64> ns { 0 };
+        std::atomic<i64> ms { 0 };
+    };
+
+    time_cell                                     m_time;
+    ALIGNAS(nonstd::cache_line_size) std::thread  m_thread;
+    std::mutex                                    m_mutex;
+    std::condition_variable                       m_wake;
+    chrono::nanoseconds                           m_period;
+    bool                                          m_stop = false;
+};
+
+} /* namespace nonstd */
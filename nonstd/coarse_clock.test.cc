@@ -0,0 +1,88 @@
+/** Coarse Clock Tests
+ *  ==================
+ *  GOAL: Validate that a coarse clock's readings advance, never run backwards,
+ *  and stay within a period (plus scheduling slack) of `wallclock::now()`,
+ *  and that its ticker stops promptly however slow its rate.
+ */
+
+#include <nonstd/coarse_clock.h>
+#include <platform/testrunner/testrunner.h>
+
+#include <chrono>
+#include <thread>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/chrono.h>
+#include <nonstd/wallclock.h>
+
+
+namespace nonstd_test::coarse_clock {
+
+using nonstd::coarse_clock;
+using nonstd::wallclock;
+using namespace nonstd::literals::chrono_literals;
+
+/** Generous, for loaded test machines; the ticker may be woken late. */
+constexpr auto slack = 50ms;
+
+
+TEST_CASE("Coarse Clock", "[nonstd][time][coarse_clock]") {
+    SECTION("track wallclock to within a period") {
+        auto const before = wallclock::now();
+        coarse_clock clock { 1_kHz };
+        REQUIRE(clock.period() == 1ms);
+        REQUIRE(clock.now() >= before);
+        REQUIRE(clock.now() <= wallclock::now());
+
+        for (u32 i = 0; i < 20; ++i) {
+            std::this_thread::sleep_for(2ms);
+            auto const coarse = clock.now();
+            auto const exact  = wallclock::now();
+            REQUIRE(coarse <= exact);
+            REQUIRE(exact - coarse < clock.period() + slack);
+        }
+        REQUIRE(clock.now() - before >= 20 * 2ms - clock.period() - slack);
+        auto const ms = clock.now_ms();
+        REQUIRE(ms - std::chrono::duration_cast<std::chrono::milliseconds>(
+                         clock.now()) <= 1ms);
+    }
+
+    SECTION("never run backwards") {
+        coarse_clock clock { 10_kHz };
+        auto last = clock.now();
+        auto last_ms = clock.now_ms();
+        bool monotonic = true;
+        auto const until = wallclock::now() + 20ms;
+        while (wallclock::now() < until) {
+            auto const now    = clock.now();
+            auto const now_ms = clock.now_ms();
+            monotonic &= now >= last && now_ms >= last_ms;
+            last    = now;
+            last_ms = now_ms;
+        }
+        REQUIRE(monotonic);
+    }
+
+    SECTION("stop promptly, even at slow rates") {
+        auto const start = wallclock::now();
+        {
+            coarse_clock clock { 0.1_Hz };
+            REQUIRE(clock.period() == 10s);
+        }
+        REQUIRE(wallclock::now() - start < 1s);
+        REQUIRE_THROWS(coarse_clock { 0_Hz });
+    }
+
+    SECTION("read the OS's coarse clock, on wallclock's epoch") {
+        auto const resolution = coarse_clock::os_resolution();
+        REQUIRE(resolution > 0ns);
+        REQUIRE(resolution < 100ms);
+
+        auto const exact  = wallclock::now();
+        auto const coarse = coarse_clock::os_now();
+        REQUIRE(coarse - exact < resolution + slack);
+        REQUIRE(exact - coarse < resolution + slack);
+    }
+}
+
+} /* namespace nonstd_test::coarse_clock */
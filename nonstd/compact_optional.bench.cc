@@ -0,0 +1,51 @@
+/** Compact Optional Benchmarks
+ *  ===========================
+ *  Sums the present values of large arrays of `optional<u32>` and
+ *  `compact_optional<u32>`, too large for the cache, s.t. the scans are bound
+ *  by the bytes each element takes.
+ */
+
+#include <nonstd/compact_optional.h>
+#include <nonstd/benchmark.h>
+
+#include <vector>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/optional.h>
+
+
+namespace nonstd_bench::compact_optional {
+
+using nonstd::compact_optional;
+
+template <typename Opt>
+NOINLINE u64 sum_present(std::vector<Opt> const & values) {
+    u64 sum = 0;
+    for (auto const & value : values) {
+        if (value) { sum += *value; }
+    }
+    return sum;
+}
+
+template <typename Opt>
+void measure(nonstd::benchmark::suite & bench, c_cstr name) {
+    u64 const count = 10'000'000;
+    std::vector<Opt> values (count);
+    for (u64 i = 0; i < count; ++i) {
+        if (i % 4 != 0) { values[i] = static_cast<u32>(i % 100); }
+    }
+    fmt::print("{}: {} B/element, {} MiB\n", name, sizeof(Opt),
+               sizeof(Opt) * count / (1 << 20));
+    bench.run(name, [&] {
+        nonstd::do_not_optimize(values);
+        nonstd::do_not_optimize(sum_present(values));
+    }, count);
+}
+
+
+NONSTD_BENCHMARK("compact_optional arrays") {
+    measure<nonstd::optional<u32>>(bench, "optional<u32>");
+    measure<compact_optional<u32>>(bench, "compact_optional<u32>");
+}
+
+} /* namespace nonstd_bench::compact_optional */
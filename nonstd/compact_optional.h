@@ -0,0 +1,388 @@
+/** Compact Optional
+ *  ================
+ *  An optional with no room for a flag. `optional<T>` stores a `bool` next to
+ *  its value, so an `optional<u32>` or `optional<f32>` is twice the size of
+ *  the value it wraps, and arrays of them fit half as many values in cache.
+ *  `compact_optional<T, Policy>` is exactly the size of `T`; one value of `T`
+ *  -- chosen by `Policy` -- is set aside to mean "empty".
+ *
+ *      nonstd::compact_optional<f32> weight;              // NaN when empty
+ *      nonstd::compact_optional<u32> id { 7 };            // ~0 when empty
+ *      nonstd::compact_optional<node *> next;             // nullptr when empty
+ *      nonstd::compact_optional<i32, nonstd::value_sentinel<i32, -1>> index;
+ *
+ *  Policies are types with two static members;
+ *
+ *      static constexpr T    empty_value() noexcept;
+ *      static constexpr bool is_empty(T const & value) noexcept;
+ *
+ *  The provided ones are `nan_sentinel` (floating point; any NaN is empty),
+ *  `max_sentinel` (integers; `numeric_limits<T>::max()`, i.e. ~0 for unsigned
+ *  ids), `null_sentinel` (pointers), and `value_sentinel<T, V>`. By default,
+ *  `default_sentinel_t<T>` picks one of the first three by `T`'s type.
+ *
+ *  The interface is that of `nonstd::optional`; the same constructors,
+ *  observers (`value()` throws `bad_optional_access`), and comparisons with
+ *  `nullopt` and with values. The one difference is that the sentinel itself
+ *  can't be stored; storing it (e.g. a NaN, in a `compact_optional<f32>`)
+ *  yields an empty optional. `T` must be trivially copyable, and everything is
+ *  constexpr.
+ */
+
+#pragma once
+
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/optional.h>
+#include <nonstd/utility_ext.h>
+
+
+namespace nonstd {
+
+/** Sentinel Policies
+ *  -----------------
+ */
+template <typename T>
+struct nan_sentinel {
+    static_assert(std::numeric_limits<T>::has_quiet_NaN);
+    static constexpr T empty_value() noexcept {
+        return std::numeric_limits<T>::quiet_NaN();
+    }
+    static constexpr bool is_empty(T const & value) noexcept {
+        return value != value;
+    }
+};
+
+template <typename T>
+struct max_sentinel {
+    static_assert(std::is_integral_v<T> || std::is_enum_v<T>);
+    static constexpr T empty_value() noexcept {
+        if constexpr (std::is_enum_v<T>) {
+            using U = std::underlying_type_t<T>;
+            return static_cast<T>(std::numeric_limits<U>::max());
+        } else {
+            return std::numeric_limits<T>::max();
+        }
+    }
+    static constexpr bool is_empty(T const & value) noexcept {
+        return value == empty_value();
+    }
+};
+
+template <typename T>
+struct null_sentinel {
+    static constexpr T empty_value() noexcept { return nullptr; }
+    static constexpr bool is_empty(T const & value) noexcept {
+        return value == nullptr;
+    }
+};
+
+template <typename T, T Value>
+struct value_sentinel {
+    static constexpr T empty_value() noexcept { return Value; }
+    static constexpr bool is_empty(T const & value) noexcept {
+        return value == Value;
+    }
+};
+
+template <typename T>
+using default_sentinel_t = std::conditional_t<
+    std::is_floating_point_v<T>, nan_sentinel<T>,
+    std::conditional_t<
+        std::is_pointer_v<T> || std::is_null_pointer_v<T>, null_sentinel<T>,
+        max_sentinel<T>>>;
+
+
+template <typename T, typename Policy = default_sentinel_t<T>>
+class compact_optional {
+    static_assert(std::is_trivially_copyable_v<T>,
+        "compact_optional stores its value unconditionally, and so can only "
+        "wrap trivially copyable types.");
+    static_assert(!std::is_reference_v<T>,
+        "Use optional<T&> (or a compact_optional<T*>) to wrap references.");
+
+public:
+    using value_type  = T;
+    using policy_type = Policy;
+
+private:
+    T m_value;
+
+public:
+    /** Construction and Assignment
+     *  ---------------------------
+     */
+    constexpr compact_optional() noexcept
+        : m_value ( Policy::empty_value() )
+    { }
+    constexpr compact_optional(nonstd::nullopt_t /*unused*/) noexcept
+        : m_value ( Policy::empty_value() )
+    { }
+
+    template < typename ... Args
+             , typename = std::enable_if_t<
+                   std::is_constructible_v<T, Args&&...> > >
+    constexpr explicit compact_optional(nonstd::in_place_t /*unused*/,
+                                        Args && ... args)
+        : m_value ( std::forward<Args>(args)... )
+    { }
+
+    template < typename U = T
+             , typename = std::enable_if_t<
+                   std::is_constructible_v<T, U&&>
+                && !std::is_same_v<std::decay_t<U>, nonstd::in_place_t>
+                && !std::is_same_v<std::decay_t<U>, compact_optional>
+                && !std::is_same_v<std::decay_t<U>, nonstd::nullopt_t> > >
+    constexpr compact_optional(U && value)
+        : m_value ( std::forward<U>(value) )
+    { }
+
+    /** Convert from, and to, a flagged `optional`. */
+    constexpr compact_optional(optional<T> const & other) noexcept
+        : m_value ( other.has_value() ? *other : Policy::empty_value() )
+    { }
+    constexpr optional<T> to_optional() const noexcept {
+        return has_value() ? optional<T> { m_value } : optional<T> { };
+    }
+
+    constexpr compact_optional& operator= (nonstd::nullopt_t) noexcept {
+        m_value = Policy::empty_value();
+        return *this;
+    }
+
+    template < typename ... Args >
+    constexpr T& emplace(Args && ... args) {
+        m_value = T ( std::forward<Args>(args)... );
+        return m_value;
+    }
+
+    constexpr void reset() noexcept { m_value = Policy::empty_value(); }
+
+    constexpr void swap(compact_optional & other) noexcept {
+        T const value = m_value;
+        m_value = other.m_value;
+        other.m_value = value;
+    }
+
+
+    /** Observers
+     *  ---------
+     */
+    constexpr bool has_value() const noexcept {
+        return !Policy::is_empty(m_value);
+    }
+    constexpr explicit operator bool () const noexcept { return has_value(); }
+
+    constexpr       T * operator-> ()       noexcept { return &m_value; }
+    constexpr const T * operator-> () const noexcept { return &m_value; }
+    constexpr       T & operator*  ()       noexcept { return m_value; }
+    constexpr const T & operator*  () const noexcept { return m_value; }
+
+    constexpr       T & value()       {
+        _check_value();
+        return m_value;
+    }
+    constexpr const T & value() const {
+        _check_value();
+        return m_value;
+    }
+
+    template < typename U = T >
+    constexpr T value_or(U && value) const {
+        return has_value() ? m_value : static_cast<T>(std::forward<U>(value));
+    }
+
+    /** The stored value, or the sentinel if there is none. */
+    constexpr T const & raw_value() const noexcept { return m_value; }
+
+private:
+    constexpr void _check_value() const {
+        if (!has_value()) {
+            throw nonstd::exception::bad_optional_access { };
+        }
+    }
+};
+
+
+/** Comparisons
+ *  -----------
+ *  As for `optional`; empty optionals are equal to each other and to
+ *  `nullopt`, and less than any value.
+ */
+template <typename T, typename P>
+constexpr bool operator== (compact_optional<T, P> const & lhs,
+                           compact_optional<T, P> const & rhs) {
+    if (lhs.has_value() != rhs.has_value()) { return false; }
+    return !lhs.has_value() || *lhs == *rhs;
+}
+template <typename T, typename P>
+constexpr bool operator!= (compact_optional<T, P> const & lhs,
+                           compact_optional<T, P> const & rhs) {
+    return !(lhs == rhs);
+}
+template <typename T, typename P>
+constexpr bool operator< (compact_optional<T, P> const & lhs,
+                          compact_optional<T, P> const & rhs) {
+    if (!rhs.has_value()) { return false; }
+    return !lhs.has_value() || *lhs < *rhs;
+}
+template <typename T, typename P>
+constexpr bool operator> (compact_optional<T, P> const & lhs,
+                          compact_optional<T, P> const & rhs) {
+    return rhs < lhs;
+}
+template <typename T, typename P>
+constexpr bool operator<= (compact_optional<T, P> const & lhs,
+                           compact_optional<T, P> const & rhs) {
+    return !(rhs < lhs);
+}
+template <typename T, typename P>
+constexpr bool operator>= (compact_optional<T, P> const & lhs,
+                           compact_optional<T, P> const & rhs) {
+    return !(lhs < rhs);
+}
+
+template <typename T, typename P>
+constexpr bool operator== (compact_optional<T, P> const & opt,
+                           nonstd::nullopt_t) noexcept {
+    return !opt.has_value();
+}
+template <typename T, typename P>
+constexpr bool operator== (nonstd::nullopt_t,
+                           compact_optional<T, P> const & opt) noexcept {
+    return !opt.has_value();
+}
+template <typename T, typename P>
+constexpr bool operator!= (compact_optional<T, P> const & opt,
+                           nonstd::nullopt_t) noexcept {
+    return opt.has_value();
+}
+template <typename T, typename P>
+constexpr bool operator!= (nonstd::nullopt_t,
+                           compact_optional<T, P> const & opt) noexcept {
+    return opt.has_value();
+}
+template <typename T, typename P>
+constexpr bool operator< (compact_optional<T, P> const & /*unused*/,
+                          nonstd::nullopt_t) noexcept {
+    return false;
+}
+template <typename T, typename P>
+constexpr bool operator< (nonstd::nullopt_t,
+                          compact_optional<T, P> const & opt) noexcept {
+    return opt.has_value();
+}
+template <typename T, typename P>
+constexpr bool operator<= (compact_optional<T, P> const & opt,
+                           nonstd::nullopt_t) noexcept {
+    return !opt.has_value();
+}
+template <typename T, typename P>
+constexpr bool operator<= (nonstd::nullopt_t,
+                           compact_optional<T, P> const & /*unused*/) noexcept {
+    return true;
+}
+template <typename T, typename P>
+constexpr bool operator> (compact_optional<T, P> const & opt,
+                          nonstd::nullopt_t) noexcept {
+    return opt.has_value();
+}
+template <typename T, typename P>
+constexpr bool operator> (nonstd::nullopt_t,
+                          compact_optional<T, P> const & /*unused*/) noexcept {
+    return false;
+}
+template <typename T, typename P>
+constexpr bool operator>= (compact_optional<T, P> const & /*unused*/,
+                           nonstd::nullopt_t) noexcept {
+    return true;
+}
+template <typename T, typename P>
+constexpr bool operator>= (nonstd::nullopt_t,
+                           compact_optional<T, P> const & opt) noexcept {
+    return !opt.has_value();
+}
+
+template < typename T, typename P, typename Value = T
+         , typename std::enable_if_t<std::is_convertible_v<Value, T>, int> = 0 >
+constexpr bool operator== (compact_optional<T, P> const & opt,
+                           Value const & value) {
+    return opt.has_value() && *opt == value;
+}
+template < typename T, typename P, typename Value = T
+         , typename std::enable_if_t<std::is_convertible_v<Value, T>, int> = 0 >
+constexpr bool operator== (Value const & value,
+                           compact_optional<T, P> const & opt) {
+    return opt.has_value() && value == *opt;
+}
+template < typename T, typename P, typename Value = T
+         , typename std::enable_if_t<std::is_convertible_v<Value, T>, int> = 0 >
+constexpr bool operator!= (compact_optional<T, P> const & opt,
+                           Value const & value) {
+    return !opt.has_value() || *opt != value;
+}
+template < typename T, typename P, typename Value = T
+         , typename std::enable_if_t<std::is_convertible_v<Value, T>, int> = 0 >
+constexpr bool operator!= (Value const & value,
+                           compact_optional<T, P> const & opt) {
+    return !opt.has_value() || value != *opt;
+}
+template < typename T, typename P, typename Value = T
+         , typename std::enable_if_t<std::is_convertible_v<Value, T>, int> = 0 >
+constexpr bool operator< (compact_optional<T, P> const & opt,
+                          Value const & value) {
+    return !opt.has_value() || *opt < value;
+}
+template < typename T, typename P, typename Value = T
+         , typename std::enable_if_t<std::is_convertible_v<Value, T>, int> = 0 >
+constexpr bool operator< (Value const & value,
+                          compact_optional<T, P> const & opt) {
+    return opt.has_value() && value < *opt;
+}
+template < typename T, typename P, typename Value = T
+         , typename std::enable_if_t<std::is_convertible_v<Value, T>, int> = 0 >
+constexpr bool operator<= (compact_optional<T, P> const & opt,
+                           Value const & value) {
+    return !opt.has_value() || *opt <= value;
+}
+template < typename T, typename P, typename Value = T
+         , typename std::enable_if_t<std::is_convertible_v<Value, T>, int> = 0 >
+constexpr bool operator<= (Value const & value,
+                           compact_optional<T, P> const & opt) {
+    return opt.has_value() && value <= *opt;
+}
+template < typename T, typename P, typename Value = T
+         , typename std::enable_if_t<std::is_convertible_v<Value, T>, int> = 0 >
+constexpr bool operator> (compact_optional<T, P> const & opt,
+                          Value const & value) {
+    return opt.has_value() && *opt > value;
+}
+template < typename T, typename P, typename Value = T
+         , typename std::enable_if_t<std::is_convertible_v<Value, T>, int> = 0 >
+constexpr bool operator> (Value const & value,
+                          compact_optional<T, P> const & opt) {
+    return !opt.has_value() || value > *opt;
+}
+template < typename T, typename P, typename Value = T
+         , typename std::enable_if_t<std::is_convertible_v<Value, T>, int> = 0 >
+constexpr bool operator>= (compact_optional<T, P> const & opt,
+                           Value const & value) {
+    return opt.has_value() && *opt >= value;
+}
+template < typename T, typename P, typename Value = T
+         , typename std::enable_if_t<std::is_convertible_v<Value, T>, int> = 0 >
+constexpr bool operator>= (Value const & value,
+                           compact_optional<T, P> const & opt) {
+    return !opt.has_value() || value >= *opt;
+}
+
+template <typename T, typename P>
+constexpr void swap(compact_optional<T, P> & lhs,
+                    compact_optional<T, P> & rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+} /* namespace nonstd */
@@ -0,0 +1,149 @@
+/** Compact Optional Tests
+ *  ======================
+ *  GOAL: Validate that compact optionals are the size of the values they
+ *  wrap, that each sentinel policy round-trips values and emptiness, and that
+ *  they behave like `nonstd::optional` -- at compile time as well as at run
+ *  time.
+ */
+
+#include <nonstd/compact_optional.h>
+#include <platform/testrunner/testrunner.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/optional.h>
+
+
+namespace nonstd_test::compact_optional {
+
+using nonstd::compact_optional;
+using nonstd::nullopt;
+using nonstd::value_sentinel;
+
+enum class handle : u16 { };
+
+static_assert(sizeof(compact_optional<f32>)   == sizeof(f32));
+static_assert(sizeof(compact_optional<f64>)   == sizeof(f64));
+static_assert(sizeof(compact_optional<u32>)   == sizeof(u32));
+static_assert(sizeof(compact_optional<i8 *>)  == sizeof(i8 *));
+static_assert(sizeof(compact_optional<handle>) == sizeof(handle));
+static_assert(std::is_trivially_copyable_v<compact_optional<u64>>);
+
+namespace cx {
+constexpr compact_optional<u32> empty { };
+constexpr compact_optional<u32> seven { 7u };
+static_assert(!empty.has_value());
+static_assert(empty == nullopt);
+static_assert(seven.has_value() && *seven == 7u);
+static_assert(seven == 7u);
+static_assert(empty < seven);
+static_assert(empty.value_or(3u) == 3u);
+static_assert(empty.raw_value() == std::numeric_limits<u32>::max());
+
+constexpr compact_optional<u32> bumped(compact_optional<u32> opt) {
+    if (opt) { *opt += 1; } else { opt.emplace(0u); }
+    opt.swap(opt);
+    return opt;
+}
+static_assert(bumped(seven) == 8u);
+static_assert(bumped(empty) == 0u);
+static_assert(!compact_optional<f32> { }.has_value());
+} /* namespace cx */
+
+
+TEST_CASE("Compact Optional", "[nonstd][optional][compact_optional]") {
+    SECTION("use NaN as the empty floating point value") {
+        compact_optional<f32> weight;
+        REQUIRE_FALSE(weight);
+        REQUIRE(std::isnan(weight.raw_value()));
+        weight = 0.5f;
+        REQUIRE(weight == 0.5f);
+        REQUIRE(weight.value() == 0.5f);
+        weight = std::numeric_limits<f32>::quiet_NaN();
+        REQUIRE(weight == nullopt);
+        REQUIRE(weight.value_or(2.f) == 2.f);
+    }
+
+    SECTION("use ~0 as the empty unsigned value") {
+        compact_optional<u64> id { 0u };
+        REQUIRE(id.has_value());
+        id.reset();
+        REQUIRE_FALSE(id.has_value());
+        REQUIRE(id.raw_value() == ~u64{0});
+        REQUIRE_THROWS_AS(id.value(), nonstd::exception::bad_optional_access);
+    }
+
+    SECTION("use nullptr as the empty pointer") {
+        i32 x = 4;
+        compact_optional<i32 *> ptr;
+        REQUIRE(ptr == nullopt);
+        ptr = &x;
+        REQUIRE(**ptr == 4);
+        ptr = nullopt;
+        REQUIRE_FALSE(ptr);
+    }
+
+    SECTION("use any chosen sentinel") {
+        compact_optional<i32, value_sentinel<i32, -1>> index { 0 };
+        REQUIRE(index == 0);
+        index = -1;
+        REQUIRE_FALSE(index);
+        REQUIRE(index.raw_value() == -1);
+    }
+
+    SECTION("compare like optional") {
+        compact_optional<i32> a { 1 };
+        compact_optional<i32> b { 2 };
+        compact_optional<i32> none;
+        REQUIRE(a < b);
+        REQUIRE(none < a);
+        REQUIRE(none == compact_optional<i32> { nullopt });
+        REQUIRE(a != none);
+        REQUIRE(a != 2);
+        REQUIRE(2 == b);
+        swap(a, none);
+        REQUIRE(none == 1);
+        REQUIRE(a == nullopt);
+    }
+
+    SECTION("compare against values of other types, and nullopt") {
+        compact_optional<u32> seven { 7u };
+        compact_optional<u32> none;
+        REQUIRE(seven == 7);
+        REQUIRE(7 == seven);
+        REQUIRE(seven != 8);
+        REQUIRE(none != 7);
+        REQUIRE(seven < 8);
+        REQUIRE(seven <= 7);
+        REQUIRE(seven > 6);
+        REQUIRE(seven >= 7);
+        REQUIRE(6 < seven);
+        REQUIRE(8 > seven);
+        REQUIRE(none < 0);
+        REQUIRE(none <= 0);
+        REQUIRE_FALSE(none > 0);
+        REQUIRE(0 > none);
+
+        REQUIRE(nullopt < seven);
+        REQUIRE(nullopt <= none);
+        REQUIRE(seven > nullopt);
+        REQUIRE(none >= nullopt);
+        REQUIRE_FALSE(seven < nullopt);
+        REQUIRE_FALSE(none < nullopt);
+        REQUIRE_FALSE(nullopt > none);
+    }
+
+    SECTION("convert to and from flagged optionals") {
+        nonstd::optional<u16> flagged { u16(9) };
+        compact_optional<u16> compact { flagged };
+        REQUIRE(compact == u16(9));
+        REQUIRE(compact_optional<u16> { nonstd::optional<u16> { } } == nullopt);
+        REQUIRE(compact.to_optional() == flagged);
+        REQUIRE_FALSE(compact_optional<u16> { }.to_optional().has_value());
+    }
+}
+
+} /* namespace nonstd_test::compact_optional */
@@ -0,0 +1,59 @@
+/** Thread-Safe Lazy Initialization Benchmarks
+ *  ==========================================
+ *  The read path; dereferencing an initialized `concurrent_lazy` against a
+ *  `lazy` guarded by a `std::mutex`, from 32 threads at once. Reported per
+ *  read; each thread reads in chunks large enough that waking the threads
+ *  is a small part of the time, as many chunks as the harness calibrates.
+ */
+
+#include <nonstd/concurrent_lazy.h>
+#include <nonstd/benchmark.h>
+
+#include <mutex>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/lazy.h>
+
+
+namespace nonstd_bench::concurrent_lazy {
+
+using nonstd::benchmark::time_threads;
+using nonstd::concurrent_lazy;
+
+
+NONSTD_BENCHMARK("concurrent_lazy read path") {
+    u32 const threads = 32;
+    u64 const reads   = 1 << 14;
+
+    concurrent_lazy<u64, u64> atomic_guarded { 1 };
+    *atomic_guarded;
+    nonstd::lazy<u64, u64> mutex_guarded { 1 };
+    std::mutex mutex;
+
+    auto const & atomic_reads = bench.run_manual("concurrent_lazy<u64>",
+        [&](u64 iterations) {
+            return time_threads(threads, [&](u32) {
+                u64 sum = 0;
+                for (u64 i = 0; i < iterations * reads; ++i) {
+                    sum += *atomic_guarded;
+                }
+                nonstd::do_not_optimize(sum);
+            });
+        }, threads * reads);
+    auto const & mutex_reads = bench.run_manual("mutex + lazy<u64>",
+        [&](u64 iterations) {
+            return time_threads(threads, [&](u32) {
+                u64 sum = 0;
+                for (u64 i = 0; i < iterations * reads; ++i) {
+                    std::lock_guard<std::mutex> lock { mutex };
+                    sum += *mutex_guarded;
+                }
+                nonstd::do_not_optimize(sum);
+            });
+        }, threads * reads);
+    bench.expect_speedup(mutex_reads, atomic_reads, 2.0,
+        "concurrent_lazy.h: once initialized, a read is cheaper than taking "
+        "a mutex");
+}
+
+} /* namespace nonstd_bench::concurrent_lazy */
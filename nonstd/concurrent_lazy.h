@@ -0,0 +1,133 @@
+/** Thread-Safe Lazy Initialization
+ *  ===============================
+ *  A `lazy<T, Args...>` that any number of threads may dereference at once.
+ *  Exactly one of them constructs the `T`; the rest wait for it, and then
+ *  everybody sees the same, fully constructed object.
+ *
+ *      nonstd::concurrent_lazy<shader_cache, c_cstr> shaders { "shaders/" };
+ *      // from any thread
+ *      shaders->lookup(id);
+ *
+ *  Once initialized, a dereference is one acquire load and one (predictable)
+ *  branch. Until then, the first thread to arrive claims the object with a
+ *  CAS and constructs it; later arrivals sleep on the state word with
+ *  `futex_wait`, and are only woken if they actually went to sleep.
+ *
+ *  If `T`'s constructor throws, the exception propagates out of that thread's
+ *  dereference, the object goes back to uninitialized, and any sleeping
+ *  threads are woken to make their own attempt -- like `std::call_once`. Each
+ *  attempt constructs from whatever the stored arguments were left holding.
+ *
+ *  The state is a 32-bit word rather than a byte, because that's what futex
+ *  waits operate on.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/futex.h>
+#include <nonstd/optional_storage.h>
+
+
+namespace nonstd {
+
+template <typename T, typename ... Args>
+class concurrent_lazy {
+    static_assert(!std::is_reference_v<T>,
+        "concurrent_lazy objects cannot wrap referential types.");
+    static_assert((std::is_same_v<Args, std::decay_t<Args>> && ...),
+        "concurrent_lazy objects store their arguments by value; use decayed "
+        "types.");
+
+private:
+    enum state : u32 {
+        empty      = 0,
+        busy       = 1, // Somebody is constructing the value.
+        contended  = 2, // ... and somebody else is waiting for them.
+        ready      = 3,
+    };
+
+    std::atomic<u32>            m_state;
+    nonstd::optional_storage<T> m_storage;
+    std::tuple<Args...>         m_args;
+
+    template <std::size_t ... Is>
+    void construct(std::index_sequence<Is...>) {
+        m_storage.construct_value(std::get<Is>(std::move(m_args))...);
+    }
+
+    NOINLINE void initialize() {
+        u32 current = m_state.load(std::memory_order_acquire);
+        while (current != ready) {
+            if (current == empty) {
+                if (!m_state.compare_exchange_weak(current, busy,
+                                                   std::memory_order_acquire)) {
+                    continue;
+                }
+                try {
+                    construct(std::index_sequence_for<Args...>{});
+                } catch (...) {
+                    finish(empty);
+                    throw;
+                }
+                finish(ready);
+                return;
+            }
+            if (current == busy
+             && !m_state.compare_exchange_weak(current, contended,
+                                               std::memory_order_acquire)) {
+                continue;
+            }
+            futex_wait(m_state, contended);
+            current = m_state.load(std::memory_order_acquire);
+        }
+    }
+
+    /** Publish `next` (`ready` or `empty`), and wake anybody waiting. */
+    void finish(state next) noexcept {
+        if (m_state.exchange(next, std::memory_order_release) == contended) {
+            futex_wake_all(m_state);
+        }
+    }
+
+public:
+    template < typename ... Us
+             , typename = std::enable_if_t<
+                   sizeof...(Us) == sizeof...(Args)
+                && std::is_constructible_v<std::tuple<Args...>, Us&&...> > >
+    concurrent_lazy(Us&&... args)
+        : m_state   ( empty )
+        , m_storage ( )
+        , m_args    ( std::forward<Us>(args)... )
+    { }
+    concurrent_lazy(concurrent_lazy const& other)       = delete;
+    concurrent_lazy(concurrent_lazy && other)           = delete;
+    concurrent_lazy& operator= (concurrent_lazy const&) = delete;
+    concurrent_lazy& operator= (concurrent_lazy &&)     = delete;
+
+    inline bool initialized() const {
+        return m_state.load(std::memory_order_acquire) == ready;
+    }
+
+    inline T& operator * () {
+        if (!initialized()) { initialize(); }
+        return m_storage.get_value();
+    }
+
+    inline T* operator -> () { return &**this; }
+};
+
+
+/** Deduces the argument types of a `concurrent_lazy<T, Args...>`. */
+template <typename T, typename ... Args>
+inline concurrent_lazy<T, std::decay_t<Args>...>
+concurrent_lazy_init(Args&&... args) {
+    return { std::forward<Args>(args)... };
+}
+
+} /* namespace nonstd */
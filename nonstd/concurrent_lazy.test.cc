@@ -0,0 +1,105 @@
+/** Thread-Safe Lazy Initialization Tests
+ *  =====================================
+ *  GOAL: Validate that concurrent lazies construct their contained exactly
+ *  once no matter how many threads race to dereference them, and that a
+ *  throwing constructor leaves them ready to try again.
+ */
+
+#include <nonstd/concurrent_lazy.h>
+#include <platform/testrunner/testrunner.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/wallclock.h>
+
+
+namespace nonstd_test::concurrent_lazy {
+
+using nonstd::concurrent_lazy;
+using nonstd::concurrent_lazy_init;
+using namespace nonstd::literals::chrono_literals;
+
+
+/** Run `fn` on `count` threads, released at (roughly) the same moment. */
+template <typename Fn>
+void race(u32 count, Fn && fn) {
+    std::atomic<bool> go { false };
+    std::vector<std::thread> threads;
+    for (u32 i = 0; i < count; ++i) {
+        threads.emplace_back([&go, &fn] {
+            while (!go.load()) { nonstd::cpu_relax(); }
+            fn();
+        });
+    }
+    go.store(true);
+    for (auto & t : threads) { t.join(); }
+}
+
+
+TEST_CASE("Concurrent Lazy Wrappers", "[nonstd][lazy][concurrent_lazy]") {
+    SECTION("should construct on first access") {
+        auto instance = concurrent_lazy_init<std::vector<i32>>(3, 7);
+        REQUIRE(instance.initialized() == false);
+        REQUIRE(instance->size() == 3);
+        REQUIRE(instance.initialized() == true);
+        REQUIRE((*instance)[2] == 7);
+    }
+
+    SECTION("should construct exactly once under contention") {
+        struct slow {
+            slow(std::atomic<u32> * constructions) {
+                constructions->fetch_add(1);
+                nonstd::wallclock::delay(2ms);
+            }
+        };
+        std::atomic<u32> constructions { 0 };
+        std::atomic<u32> mismatches { 0 };
+        concurrent_lazy<slow, std::atomic<u32> *> instance { &constructions };
+        std::atomic<slow *> seen { nullptr };
+        race(16, [&] {
+            slow * mine = &*instance;
+            slow * expected = nullptr;
+            if (!seen.compare_exchange_strong(expected, mine)
+             && expected != mine) {
+                mismatches.fetch_add(1);
+            }
+        });
+
+        REQUIRE(seen.load() == &*instance);
+        REQUIRE(constructions.load() == 1);
+        REQUIRE(mismatches.load() == 0);
+    }
+
+    SECTION("should retry construction after a throwing constructor") {
+        struct fragile {
+            fragile(std::atomic<u32> * attempts) {
+                if (attempts->fetch_add(1) < 3) {
+                    throw std::runtime_error("not yet");
+                }
+            }
+        };
+        std::atomic<u32> attempts { 0 };
+        std::atomic<u32> failures { 0 };
+        concurrent_lazy<fragile, std::atomic<u32> *> instance { &attempts };
+        race(8, [&] {
+            while (true) {
+                try {
+                    *instance;
+                    return;
+                } catch (std::runtime_error const &) {
+                    failures.fetch_add(1);
+                }
+            }
+        });
+
+        REQUIRE(instance.initialized() == true);
+        REQUIRE(attempts.load() == 4);
+        REQUIRE(failures.load() == 3);
+    }
+}
+
+} /* namespace nonstd_test::concurrent_lazy */
@@ -9,8 +9,11 @@
  */
 #pragma once
 
+#include <cstddef>
 #include <functional>
+#include <iterator>
 #include <type_traits>
+#include <utility>
 
 #include <thirdparty/fmt.h>
 
@@ -22,70 +25,155 @@ namespace nonstd {
 namespace detail {
 using std::iterator_traits;
 
-template <typename Container, typename Iterator, typename Value>
+/* Each item carries whatever the underlying iterator's `operator*` returns;
+ * a reference for containers, or a proxy (by value) for views whose elements
+ * are computed. Nothing is copied out of the iterated thing.
+ * Over random-access iterables, the iterator is random-access too, s.t. an
+ * enumeration can be split into chunks (e.g. across threads), and over
+ * bidirectional iterables it's bidirectional. `end()` takes its index from
+ * `std::size` where that's well-formed, and otherwise walks bidirectional
+ * iterables once to count them. */
+template <typename Container>
 struct enumerate_t {
+    using base_iterator  = decltype(std::begin(std::declval<Container&>()));
+    using base_reference = decltype(*std::declval<base_iterator&>());
+    using base_category  =
+        typename iterator_traits<base_iterator>::iterator_category;
+
     template <typename U>
     enumerate_t(U&& u) : container(std::forward<U>(u)) {}
 
-    struct iterator {
-        using value_type = typename iterator_traits<Iterator>::value_type;
-
-        struct item {
-            std::size_t i;
-            Value value;
-        };
+    struct item {
+        std::size_t i;
+        base_reference value;
+    };
 
-        iterator(Iterator iter, std::size_t index) :
+    struct iterator {
+        using difference_type   = std::ptrdiff_t;
+        using value_type        = item;
+        using pointer           = void;
+        using reference         = item;
+        using iterator_category = std::conditional_t<
+            std::is_base_of_v<std::random_access_iterator_tag, base_category>,
+            std::random_access_iterator_tag,
+            std::conditional_t<
+                std::is_base_of_v<std::bidirectional_iterator_tag,
+                                  base_category>,
+                std::bidirectional_iterator_tag,
+                std::forward_iterator_tag>>;
+
+        iterator(base_iterator iter, std::size_t index) :
                 iter(iter), index(index) {}
 
         item operator*() const { return item{index, *iter}; }
+        item operator[](difference_type n) const { return *(*this + n); }
 
+        bool operator==(iterator const& other) const {
+            return iter == other.iter;
+        }
         bool operator!=(iterator const& other) const {
             return iter != other.iter;
         }
+        bool operator<(iterator const& other) const {
+            return index < other.index;
+        }
+        bool operator>(iterator const& other) const {
+            return index > other.index;
+        }
+        bool operator<=(iterator const& other) const {
+            return index <= other.index;
+        }
+        bool operator>=(iterator const& other) const {
+            return index >= other.index;
+        }
 
         iterator& operator++() {
             ++index, ++iter;
 
             return *this;
         }
+        iterator& operator--() {
+            --index, --iter;
+
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+        iterator operator--(int) {
+            iterator previous = *this;
+            --*this;
+            return previous;
+        }
+
+        iterator& operator+=(difference_type n) {
+            index += n, iter += n;
+
+            return *this;
+        }
+        iterator& operator-=(difference_type n) { return *this += -n; }
+        friend iterator operator+(iterator it, difference_type n) {
+            return it += n;
+        }
+        friend iterator operator+(difference_type n, iterator it) {
+            return it += n;
+        }
+        friend iterator operator-(iterator it, difference_type n) {
+            return it -= n;
+        }
+        friend difference_type operator-(iterator const& lhs,
+                                         iterator const& rhs) {
+            return static_cast<difference_type>(lhs.index - rhs.index);
+        }
 
     private:
-        Iterator    iter;
-        std::size_t index;
+        base_iterator iter;
+        std::size_t   index;
     };
 
     iterator begin() { return iterator(std::begin(container), 0); }
-    iterator end() { return iterator(std::end(container), std::size(container)); }
+    iterator end() {
+        // The index matters to anything that steps back from the end. Sized
+        // iterables report it, and forward iterators can't step back, so only
+        // unsized bidirectional iterables are walked to count them.
+        std::size_t count = 0;
+        if constexpr (has_size<Container>::value) {
+            count = static_cast<std::size_t>(std::size(container));
+        } else if constexpr (!std::is_same_v<
+                typename iterator::iterator_category,
+                std::forward_iterator_tag>) {
+            count = static_cast<std::size_t>(
+                std::distance(std::begin(container), std::end(container)));
+        }
+        return iterator(std::end(container), count);
+    }
 
 private:
+    template <typename C, typename = void>
+    struct has_size : std::false_type { };
+    template <typename C>
+    struct has_size<C, std::void_t<decltype(std::size(std::declval<C&>()))>>
+        : std::true_type { };
+
     Container container;
 };
 }
 
+/* Lvalues (and `std::reference_wrapper`s) are referred to, and must outlive
+ * the enumeration; rvalues are moved into it. */
 template <typename R>
 auto enumerate(R&& r) {
     using namespace detail;
     if constexpr (is_reference_wrapper<std::decay_t<R>>::value) {
-        using type = decltype(r.get());
-        using iterator = decltype(std::begin(r.get()));
-        using value_type = decltype(*std::begin(r.get()));
-
-        return enumerate_t<type, iterator, value_type&>(r);
+        return enumerate_t<decltype(r.get())>(r.get());
     }
-    else if constexpr (std::is_rvalue_reference_v<R>) {
-        using type = std::remove_reference_t<R>;
-        using iterator = decltype(std::begin(r));
-        using value_type = std::remove_reference_t<decltype(*std::begin(r))>;
-
-        return enumerate_t<type, iterator, value_type>(std::move(r));
+    else if constexpr (!std::is_lvalue_reference_v<R>) {
+        return enumerate_t<std::remove_reference_t<R>>(std::move(r));
     }
     else {
-        using type = R;
-        using iterator = decltype(std::begin(r));
-        using value_type = std::remove_reference_t<decltype(*std::begin(r))>;
-
-        return enumerate_t<type, iterator, value_type&>(r);
+        return enumerate_t<R>(r);
     }
 }
 
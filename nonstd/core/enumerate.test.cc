@@ -7,6 +7,13 @@
 #include <platform/testrunner/testrunner.h>
 
 #include <array>
+#include <iterator>
+#include <list>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <nonstd/core/range.h>
 
 
 namespace nonstd_test {
@@ -58,6 +65,96 @@ TEST_CASE("Enumerate API Demo", "[nonstd][api][range]") {
             REQUIRE(value == i);
         }
     }
+
+    SECTION("passes proxies and computed values through") {
+        std::vector<bool> flags (8, false);
+        // Bind proxies by value; assigning through a const proxy won't work.
+        for (auto [i, flag] : nonstd::enumerate(flags)) {
+            flag = (i % 3 == 0);
+        }
+        REQUIRE(flags == std::vector<bool> {
+            true, false, false, true, false, false, true, false });
+
+        std::size_t total = 0;
+        for (auto const& [i, value] : nonstd::enumerate(nonstd::range(5, 10))) {
+            REQUIRE(value == i32(i) + 5);
+            total += 1;
+        }
+        REQUIRE(total == 5);
+    }
+
+    SECTION("refers into moved-in rvalues rather than copying elements") {
+        std::vector<i32> values { 1, 2, 3 };
+        auto const * data = values.data();
+        auto enumeration = nonstd::enumerate(std::move(values));
+        for (auto const& [i, value] : enumeration) {
+            REQUIRE(&value == data + i);
+        }
+    }
+
+    SECTION("is random-access over random-access iterables") {
+        std::vector<i16> arr (10, 0);
+        auto enumeration = nonstd::enumerate(arr);
+        using iterator = decltype(enumeration.begin());
+        static_assert(std::is_same_v<
+            typename std::iterator_traits<iterator>::iterator_category,
+            std::random_access_iterator_tag>);
+
+        REQUIRE(enumeration.end() - enumeration.begin() == 10);
+        auto const [i, value] = enumeration.begin()[7];
+        REQUIRE(i == 7);
+        REQUIRE(&value == &arr[7]);
+        REQUIRE((*(enumeration.end() - 3)).i == 7);
+    }
+
+    SECTION("works over iterables without random access") {
+        std::list<i16> list { 4, 5, 6 };
+        std::size_t count = 0;
+        for (auto const& [i, value] : nonstd::enumerate(list)) {
+            REQUIRE(value == i16(i + 4));
+            count += 1;
+        }
+        REQUIRE(count == 3);
+    }
+
+    SECTION("steps back from the end over bidirectional iterables") {
+        std::list<i16> list { 10, 20, 30 };
+        auto e = nonstd::enumerate(list);
+        auto const last = *std::prev(e.end());
+        REQUIRE(last.i == 2);
+        REQUIRE(last.value == 30);
+
+        std::size_t expected = 3;
+        for (auto it = std::make_reverse_iterator(e.end());
+             it != std::make_reverse_iterator(e.begin()); ++it) {
+            expected -= 1;
+            REQUIRE((*it).i == expected);
+            REQUIRE((*it).value == i16(10 * (expected + 1)));
+        }
+        REQUIRE(expected == 0);
+    }
+
+    SECTION("takes the end index from the iterable's size, when it has one") {
+        struct sized {
+            std::list<i16> list;
+            std::size_t mutable sizes = 0;
+            auto begin() { return list.begin(); }
+            auto end() { return list.end(); }
+            std::size_t size() const { sizes += 1; return list.size(); }
+        };
+        sized s { { 1, 2, 3, 4 } };
+        auto e = nonstd::enumerate(s);
+        REQUIRE((*std::prev(e.end())).i == 3);
+        REQUIRE(s.sizes == 1);
+
+        struct unsized {
+            std::list<i16> list;
+            auto begin() { return list.begin(); }
+            auto end() { return list.end(); }
+        };
+        unsized u { { 1, 2, 3 } };
+        REQUIRE((*std::prev(nonstd::enumerate(u).end())).i == 2);
+    }
 }
 
 } /* namespace enumerate */
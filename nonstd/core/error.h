@@ -59,6 +59,9 @@ enum class error : int {
     uncategorized = 0x1000, // uncategorized error. Don't use this.
     module_not_started, // module was used before it was started
     hash_collision, // distinct values returned an identical hash
+    cancelled, // the work was abandoned at the request of its consumer
+    deadline_exceeded, // the work didn't finish before its deadline
+    channel_closed, // a channel was closed while an operation was pending
 };
 
 } /* namespace nonstd */
@@ -158,6 +161,12 @@ inline std::string error_category_t::message(int code) const {
         return "Attempted interaction with uninitialized module";
     case nonstd::error::hash_collision:
         return "Non-reconcilable hash collision detected";
+    case nonstd::error::cancelled:
+        return "Operation cancelled";
+    case nonstd::error::deadline_exceeded:
+        return "Operation did not complete before its deadline";
+    case nonstd::error::channel_closed:
+        return "Channel closed";
     } /* switch (static_cast<nonstd::error>(code)) */
 }
 
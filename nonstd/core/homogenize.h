@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 /* Platform and compiler characteristics */
 namespace nonstd {
 enum struct operating_system_t {
@@ -125,6 +127,51 @@ enum struct compiler_t {
 #  endif
 #endif
 
+/** NOINLINE
+ *  --------
+ *  Forbids the compiler from inlining this function. Useful for keeping cold
+ *  paths out of hot loops.
+ */
+#if !defined(NOINLINE)
+#  if defined(NONSTD_COMPILER_MSVC)
+#    define NOINLINE __declspec(noinline)
+#  else
+#    define NOINLINE __attribute__((noinline))
+#  endif
+#endif
+
+/** Cache Line Size
+ *  ---------------
+ *  The assumed size of a destructive-interference region. Data that's written
+ *  from different threads should be aligned to -- and padded out to -- this
+ *  many bytes to avoid false sharing. `std::hardware_destructive_interference`
+ *  would be the standard answer here, but not all of our toolchains define it.
+ */
+namespace nonstd {
+    constexpr size_t cache_line_size = 64;
+}
+
+/** CPU Relax
+ *  ---------
+ *  Hint to the processor that the calling thread is in a spin-wait loop. On x86
+ *  this is the `pause` instruction, which saves power and avoids a memory-order
+ *  violation pipeline flush when the loop exits. On ARM it's `yield`.
+ */
+#if defined(NONSTD_COMPILER_MSVC)
+#  include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#  include <immintrin.h>
+#endif
+namespace nonstd {
+    FORCEINLINE void cpu_relax() noexcept {
+#if defined(NONSTD_COMPILER_MSVC) || defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__ ("yield");
+#endif
+    }
+}
+
 /** Preferred Path Separator
  *  ------------------------
  */
@@ -0,0 +1,75 @@
+/** Range Benchmarks
+ *  ================
+ *  Checks that loops over ranges vectorize; a weighted sum indexed by a range
+ *  against the equivalent hand-written counted loop, and `iota` against
+ *  filling a vector element by element. If they vectorize, the two sums run
+ *  at about the same speed, and `iota` is no slower than the element-wise
+ *  fill. (Where they don't, check with `-fopt-info-vec` or
+ *  `-Rpass=loop-vectorize`.)
+ */
+
+#include <nonstd/core/range.h>
+#include <nonstd/benchmark.h>
+
+#include <vector>
+
+#include <nonstd/nonstd.h>
+
+
+namespace nonstd_bench::range {
+
+using nonstd::range;
+
+NOINLINE i32 sum_range(std::vector<i32> const & values) {
+    i32 sum = 0;
+    for (auto i : range(static_cast<i32>(values.size()))) {
+        sum += values[i] * i;
+    }
+    return sum;
+}
+
+NOINLINE i32 sum_counted(std::vector<i32> const & values) {
+    i32 sum = 0;
+    i32 const n = static_cast<i32>(values.size());
+    for (i32 i = 0; i < n; ++i) { sum += values[i] * i; }
+    return sum;
+}
+
+NOINLINE void fill_iota(std::vector<i32> & out) {
+    range(static_cast<i32>(out.size())).iota(out.data(), out.size());
+}
+
+NOINLINE void fill_elementwise(std::vector<i32> & out) {
+    i32 value = 0;
+    for (auto & element : out) { element = value++; }
+}
+
+
+NONSTD_BENCHMARK("range vectorization") {
+    u64 const n = 1 << 16;
+    std::vector<i32> buffer (n);
+
+    auto const & iota = bench.run("iota", [&] {
+        fill_iota(buffer);
+        nonstd::clobber_memory();
+    }, n);
+    auto const & elementwise = bench.run("element-wise fill", [&] {
+        fill_elementwise(buffer);
+        nonstd::clobber_memory();
+    }, n);
+    bench.expect_speedup(elementwise, iota, 0.75,
+        "range.h: iota is no slower than filling element by element");
+
+    auto const & by_range = bench.run("sum over range", [&] {
+        nonstd::do_not_optimize(buffer);
+        nonstd::do_not_optimize(sum_range(buffer));
+    }, n);
+    auto const & by_count = bench.run("sum, counted loop", [&] {
+        nonstd::do_not_optimize(buffer);
+        nonstd::do_not_optimize(sum_counted(buffer));
+    }, n);
+    bench.expect_speedup(by_count, by_range, 0.75,
+        "range.h: a loop over a range runs as quickly as a counted loop");
+}
+
+} /* namespace nonstd_bench::range */
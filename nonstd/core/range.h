@@ -4,9 +4,21 @@
  *  often missing little conveniences to make the task of using them as simple
  *  as it could be. This iterator will lazily yield types of `T`. It's behavior
  *  is based on the python `range()` function.
+ *
+ *  A range knows how many values it will yield -- its trip count -- from the
+ *  moment it's constructed, and its iterators are random-access; the `i`th
+ *  value is computed as `first + i * step`, rather than by accumulating steps.
+ *  That means `std::distance` and `size()` are O(1), parallel algorithms can
+ *  split a range, floating-point ranges don't drift, and loops over a range
+ *  compile down to a plain counted loop that compilers are happy to
+ *  vectorize. Dereferencing yields values, not references.
+ *
+ *  Steps may be negative (`range(10, 0, -2)` yields 10, 8, 6, 4, 2). A step
+ *  of zero yields nothing.
  */
 #pragma once
 
+#include <array>
 #include <iterator>
 #include <type_traits>
 #include <vector>
@@ -42,47 +54,133 @@ struct range_t {
         "saying it won't work for the type given, but you should test it. "
         "And then modify this assert.");
 
-    template <typename U> struct iterator;
+    struct iterator;
 
-    /* named start / stop to avoid colliding with begin() / end() */
-    iterator<T> start;
-    iterator<T> stop;
+private:
+    T   m_first;
+    T   m_step;
+    u64 m_count;
 
+    /** Number of values in `[first, last)` -- or `(last, first]`, stepping
+     *  down -- reached by stepping from `first`.
+     */
+    static constexpr u64 trip_count(T first, T last, T step) noexcept {
+        if constexpr (std::is_integral_v<T>) {
+            // Measure the span in unsigned arithmetic, where it can't
+            // overflow however wide the range, and never negate `step`;
+            // -`step` overflows for the most negative `T`.
+            using U = std::make_unsigned_t<T>;
+            U span { }, stride { };
+            if (step > T{0} && first < last) {
+                span   = static_cast<U>(static_cast<U>(last)
+                                      - static_cast<U>(first));
+                stride = static_cast<U>(step);
+            } else if (step < T{0} && last < first) {
+                span   = static_cast<U>(static_cast<U>(first)
+                                      - static_cast<U>(last));
+                stride = static_cast<U>(U{0} - static_cast<U>(step));
+            } else {
+                return 0;
+            }
+            return static_cast<u64>(static_cast<U>(span - 1u) / stride) + 1;
+        } else {
+            if (step < T{0}) {
+                // Mirror the range s.t. the step is positive.
+                return trip_count(-first, -last, -step);
+            }
+            if (!(step > T{0}) || !(first < last)) { return 0; }
+            u64 count = static_cast<u64>((last - first) / step);
+            if (first + static_cast<T>(count) * step < last) { count += 1; }
+            return count;
+        }
+    }
+
+public:
     constexpr range_t(T begin, T end, T step = 1) noexcept
-        : start { begin, end, step }
-        , stop  { end,   end, step }
+        : m_first ( begin )
+        , m_step  ( step )
+        , m_count ( trip_count(begin, end, step) )
     { }
 
-    constexpr iterator<T> begin() const noexcept { return start; }
-    constexpr iterator<T> end()   const noexcept { return stop; }
+    constexpr iterator begin() const noexcept {
+        return { m_first, m_step, 0 };
+    }
+    constexpr iterator end() const noexcept {
+        return begin() + static_cast<ptrdiff>(m_count);
+    }
+
+    constexpr u64  size()  const noexcept { return m_count; }
+    constexpr bool empty() const noexcept { return m_count == 0; }
+    constexpr T    first() const noexcept { return m_first; }
+    constexpr T    step()  const noexcept { return m_step; }
+
+    /** The `i`th value of the range. */
+    constexpr T operator[] (u64 i) const noexcept {
+        if constexpr (std::is_integral_v<T>) {
+            // `i * step` may overflow `T` where `first + i * step` doesn't.
+            using U = std::make_unsigned_t<T>;
+            return static_cast<T>(static_cast<U>(m_first)
+                                + static_cast<U>(i) * static_cast<U>(m_step));
+        } else {
+            return static_cast<T>(m_first + static_cast<T>(i) * m_step);
+        }
+    }
+
+    /** bulk writes
+     *  -----------
+     *  Write the first `n` values of the range (or all of them, if there are
+     *  fewer than `n`) to `out`, and return how many were written. The loop is
+     *  blocked into fixed-width lanes s.t. compilers emit vector stores. Each
+     *  value is `first + i * step`, as `operator[]` computes it; stepping a
+     *  block at a time would accumulate error in floating-point ranges.
+     */
+    template <typename V>
+    inline u64 iota(V * out, u64 n) const noexcept {
+        n = n2min(n, m_count);
+        constexpr u64 lanes = 8;
+        u64 i = 0;
+        for (; i + lanes <= n; i += lanes) {
+            for (u64 j = 0; j < lanes; ++j) {
+                out[i + j] = static_cast<V>((*this)[i + j]);
+            }
+        }
+        for (; i < n; ++i) { out[i] = static_cast<V>((*this)[i]); }
+        return n;
+    }
 
     /** container fill utilities
      *  ------------------------
      *  It's sometimes handy to have a vector or array that's prefilled with a
-     *  sequential run of numbers, like those from a range.
+     *  sequential run of numbers, like those from a range. Ranges larger than
+     *  the container are truncated. Contiguous containers are written with
+     *  `iota`.
      */
     template <typename IterableType>
     inline IterableType& fill(IterableType& iterable) {
-        auto range_it = std::begin(*this);
-        for (auto& element : iterable) {
-            if(range_it == this->end()) {
-                break;
+        if constexpr (std::is_array_v<IterableType>) {
+            iota(&iterable[0], std::extent_v<IterableType>);
+        } else if constexpr (is_contiguous<IterableType>::value) {
+            iota(iterable.data(), static_cast<u64>(iterable.size()));
+        } else {
+            u64 i = 0;
+            for (auto& element : iterable) {
+                if (i == m_count) { break; }
+                element = (*this)[i++];
             }
-            element = *range_it;
-            ++ range_it;
         }
         return iterable;
     }
 
     /** container fill-to-vector utilities
      *  ----------------------------------
-     *  Same as the above, but specialized for vectors in particular.
+     *  Same as the above, but specialized for vectors in particular; vectors
+     *  grow (once) to hold the whole range, after any existing elements.
      */
     template <typename ValueType>
     inline std::vector<ValueType>& fill(std::vector<ValueType>& vector) {
-        for (auto const& element : *this) {
-            vector.push_back(element);
-        }
+        auto const existing = vector.size();
+        vector.resize(existing + m_count);
+        iota(vector.data() + existing, m_count);
         return vector;
     }
 
@@ -92,72 +190,139 @@ struct range_t {
      *  initialization for containers.
      */
     template <typename ValueType>
-    inline operator std::vector<ValueType>() {
-        std::vector<ValueType> ret { };
-        fill(ret);
+    inline operator std::vector<ValueType>() const {
+        std::vector<ValueType> ret ( m_count );
+        iota(ret.data(), m_count);
         return ret;
     }
     template <typename ValueType, size_t Length>
-    inline operator std::array<ValueType, Length> () {
+    inline operator std::array<ValueType, Length> () const {
         std::array<ValueType, Length> ret { };
-        fill(ret);
+        iota(ret.data(), Length);
         return ret;
     }
 
-    // Redefining the template parameter is useless _except_ for the part where
-    // it un-breaks an inscrutable MSVC error.
-    template <typename U>
     struct iterator {
         /* Iterator type trait boilerplate. See,
          * http://en.cppreference.com/w/cpp/iterator/iterator_traits
          * http://www.cplusplus.com/reference/iterator/
+         *
+         * NB. Values are computed, not stored, so `reference` is a value type.
          */
         using difference_type   = ptrdiff;
-        using value_type        = U;
-        using pointer           = U*;
-        using reference         = U&;
-        using iterator_category = std::input_iterator_tag;
+        using value_type        = T;
+        using pointer           = void;
+        using reference         = T;
+        using iterator_category = std::random_access_iterator_tag;
 
-        U       value;
-        U const max;
-        U const step;
+        /* For integral types `value` is the current value, advanced as the
+         * iterator moves, s.t. loops over a range carry a single induction
+         * variable of type `T`. Floating-point ranges would drift that way, so
+         * for those `value` stays the first value, and each is recomputed. */
+        T       value;
+        T       step;
+        ptrdiff index;
 
-        constexpr iterator(U value, U max, U step) noexcept
-            : value ( value )
-            , max   ( max   )
-            , step  ( step  )
-        { }
-
-        constexpr iterator() = delete;
-        constexpr iterator(iterator const &)            = default;
-        constexpr iterator& operator=(iterator const &) = default;
-        constexpr iterator(iterator &&)                 = default;
-        constexpr iterator& operator=(iterator &&)      = default;
-        ~iterator() noexcept                            = default;
-
-        constexpr U const & operator*() const noexcept {
-            return value;
+        constexpr T operator*() const noexcept {
+            if constexpr (std::is_integral_v<T>) { return value; }
+            else {
+                return static_cast<T>(value + static_cast<T>(index) * step);
+            }
+        }
+        constexpr T operator[](ptrdiff n) const noexcept {
+            return *(*this + n);
         }
 
+        /* NB. Increments step the value in `T`, as range iterators always
+         * have, s.t. the loop vectorizes; a range ending within one step of
+         * `T`'s limits overflows on its last increment. */
         constexpr iterator& operator++() noexcept {
-            value = n2min(value + step, max);
+            if constexpr (std::is_integral_v<T>) {
+                value = static_cast<T>(value + step);
+            }
+            ++index;
             return *this;
         }
-        constexpr iterator& operator++(int) noexcept {
+        constexpr iterator& operator--() noexcept {
+            if constexpr (std::is_integral_v<T>) {
+                value = static_cast<T>(value - step);
+            }
+            --index;
+            return *this;
+        }
+        constexpr iterator operator++(int) noexcept {
+            iterator tmp { *this };
+            ++*this;
+            return tmp;
+        }
+        constexpr iterator operator--(int) noexcept {
             iterator tmp { *this };
-            value = n2min(value + step, max);
+            --*this;
             return tmp;
         }
 
+        constexpr iterator& operator+=(ptrdiff n) noexcept {
+            index += n;
+            if constexpr (std::is_integral_v<T>) {
+                // Step in unsigned arithmetic; past-the-end values may wrap.
+                using U = std::make_unsigned_t<T>;
+                value = static_cast<T>(
+                    static_cast<U>(value)
+                    + static_cast<U>(n) * static_cast<U>(step));
+            }
+            return *this;
+        }
+        constexpr iterator& operator-=(ptrdiff n) noexcept {
+            return *this += -n;
+        }
+        friend constexpr iterator operator+(iterator it, ptrdiff n) noexcept {
+            return it += n;
+        }
+        friend constexpr iterator operator+(ptrdiff n, iterator it) noexcept {
+            return it += n;
+        }
+        friend constexpr iterator operator-(iterator it, ptrdiff n) noexcept {
+            return it -= n;
+        }
+        friend constexpr ptrdiff operator-(iterator const & lhs,
+                                           iterator const & rhs) noexcept {
+            return lhs.index - rhs.index;
+        }
+
         friend constexpr bool operator==(iterator const & lhs,
                                          iterator const & rhs) noexcept {
-            return lhs.value == rhs.value;
+            return lhs.index == rhs.index;
         }
         friend constexpr bool operator!=(iterator const & lhs,
                                          iterator const & rhs) noexcept {
-            return lhs.value != rhs.value;
+            return lhs.index != rhs.index;
+        }
+        friend constexpr bool operator<(iterator const & lhs,
+                                        iterator const & rhs) noexcept {
+            return lhs.index < rhs.index;
+        }
+        friend constexpr bool operator>(iterator const & lhs,
+                                        iterator const & rhs) noexcept {
+            return lhs.index > rhs.index;
+        }
+        friend constexpr bool operator<=(iterator const & lhs,
+                                         iterator const & rhs) noexcept {
+            return lhs.index <= rhs.index;
+        }
+        friend constexpr bool operator>=(iterator const & lhs,
+                                         iterator const & rhs) noexcept {
+            return lhs.index >= rhs.index;
         }
     };
+
+private:
+    template <typename C, typename = void>
+    struct is_contiguous : std::false_type { };
+    template <typename C>
+    struct is_contiguous<C, std::void_t<
+        decltype(std::declval<C&>().data()),
+        decltype(std::declval<C&>().size())>>
+        : std::is_pointer<decltype(std::declval<C&>().data())> { };
 };
 
 } /* namespace nonstd */
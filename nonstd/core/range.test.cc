@@ -6,7 +6,12 @@
 #include <nonstd/core/range.h>
 #include <platform/testrunner/testrunner.h>
 
+#include <algorithm>
 #include <array>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <numeric>
 #include <vector>
 
 #include <nonstd/core/enumerate.h>
@@ -160,6 +165,57 @@ TEST_CASE("Range API Demo", "[nonstd][api][range]") {
         }
     }
 
+    SECTION("count negative steps down") {
+        std::vector<i32> values = range(10, 0, -3);
+        REQUIRE(values == std::vector<i32> { 10, 7, 4, 1 });
+        REQUIRE(range(0, 10, -1).empty());
+        REQUIRE(range(0, 10, 0).empty());
+    }
+
+    SECTION("don't accumulate floating-point error") {
+        auto tenths = range(0.f, 1.f, 0.1f);
+        REQUIRE(tenths.size() == 10);
+        REQUIRE(tenths[7] == 7.f * 0.1f);
+
+        // Bulk writes compute each value as indexing does, too.
+        auto const wide = range(0.f, 1e5f, 0.1f);
+        std::vector<f32> values = wide;
+        REQUIRE(values.size() == wide.size());
+        u64 mismatches = 0;
+        auto it = wide.begin();
+        for (u64 i = 0; i < values.size(); ++i, ++it) {
+            mismatches += values[i] != wide[i] || values[i] != *it;
+        }
+        REQUIRE(mismatches == 0);
+    }
+
+    SECTION("count ranges that span most of their type") {
+        using limits = std::numeric_limits<i32>;
+        auto const wide = range(-2'000'000'000, 2'000'000'000, 1'000'000'000);
+        REQUIRE(wide.size() == 4);
+        REQUIRE(std::vector<i32>(wide)
+                == std::vector<i32> { -2'000'000'000, -1'000'000'000, 0,
+                                      1'000'000'000 });
+        REQUIRE(range(limits::min(), limits::max()).size()
+                == u64 { limits::max() } * 2 + 1);
+        REQUIRE(range(limits::max(), limits::min(), -1).size()
+                == u64 { limits::max() } * 2 + 1);
+        REQUIRE(range(0, limits::min(), limits::min()).size() == 1);
+        REQUIRE(range(limits::max(), limits::min(), limits::min()).size()
+                == 2);
+        REQUIRE(range(limits::max(), limits::min(), limits::min())[1] == -1);
+        REQUIRE(range(limits::min(), limits::max(), limits::max()).size()
+                == 3);
+        REQUIRE(range(i8 { -128 }, i8 { 127 }, i8 { 100 }).size() == 3);
+        REQUIRE(range(u64 { 0 }, ~u64 { 0 }, u64 { 1 } << 63).size() == 2);
+    }
+
+    SECTION("can fill non-contiguous containers") {
+        std::list<u32> list (5);
+        range(2u, 100u, 2u).fill(list);
+        REQUIRE(list == std::list<u32> { 2, 4, 6, 8, 10 });
+    }
+
 #if !defined(NONSTD_OS_WINDOWS)
     SECTION("They're even constexpr, if you're not on MSVC") {
         constexpr auto result = constexpr_sum(10, 20);
@@ -169,5 +225,53 @@ TEST_CASE("Range API Demo", "[nonstd][api][range]") {
 #endif
 }
 
+
+TEST_CASE("Range Random Access", "[nonstd][range]") {
+    auto r = range(5, 50, 5);
+
+    SECTION("know their size up front") {
+        REQUIRE(r.size() == 9);
+        REQUIRE(std::distance(r.begin(), r.end()) == 9);
+        REQUIRE(range(0, 10, 3).size() == 4);
+        REQUIRE(range(10).size() == 10);
+        static_assert(range(3, 3).size() == 0);
+    }
+
+    SECTION("index, and step in either direction") {
+        auto it = r.begin();
+        REQUIRE(*(it + 3) == 20);
+        REQUIRE(it[8] == 45);
+        REQUIRE(r[2] == 15);
+        REQUIRE(*(r.end() - 1) == 45);
+        REQUIRE(r.end() - r.begin() == 9);
+        REQUIRE(it < r.end());
+    }
+
+    SECTION("return the previous position from post-increment") {
+        auto it = r.begin();
+        auto previous = it++;
+        REQUIRE(*previous == 5);
+        REQUIRE(*it == 10);
+        previous = it--;
+        REQUIRE(*previous == 10);
+        REQUIRE(*it == 5);
+    }
+
+    SECTION("work with standard algorithms") {
+        REQUIRE(std::accumulate(r.begin(), r.end(), 0) == 225);
+        REQUIRE(*std::lower_bound(r.begin(), r.end(), 23) == 25);
+        std::vector<i32> reversed (r.size());
+        std::reverse_copy(r.begin(), r.end(), reversed.begin());
+        REQUIRE(reversed.front() == 45);
+    }
+
+    SECTION("write blocks of values") {
+        std::vector<i64> out (20, -1);
+        REQUIRE(range(0, 39, 3).iota(out.data(), out.size()) == 13);
+        for (u64 i = 0; i < 13; ++i) { REQUIRE(out[i] == i64(3 * i)); }
+        REQUIRE(out[13] == -1);
+    }
+}
+
 } /* namespace iterator */
 } /* namespace nonstd_test */
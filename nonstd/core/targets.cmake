@@ -90,6 +90,7 @@ n2_platform_test(
     SOURCES enumerate.test.cc
     DEPENDS
         nonstd::core::enumerate
+        nonstd::core::range
         platform::testrunner
 )
 n2_platform_test(
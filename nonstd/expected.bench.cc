@@ -0,0 +1,87 @@
+/** Expected Benchmarks
+ *  ===================
+ *  Parses numbers -- some fraction of which are malformed -- with failures
+ *  returned in an `expected` vs. thrown as `std::system_error`s. Checks
+ *  expected.h's premise; that where failures are common, throwing (and
+ *  unwinding) dominates the cost.
+ */
+
+#include <nonstd/expected.h>
+#include <nonstd/benchmark.h>
+
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+
+
+namespace nonstd_bench::expected {
+
+using nonstd::expected;
+using nonstd::unexpected;
+
+NOINLINE i32 parse_or_throw(std::string_view text) {
+    if (text.empty()) { throw std::system_error { nonstd::error::pebcak }; }
+    i32 result = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') {
+            throw std::system_error { nonstd::error::pebcak };
+        }
+        result = result * 10 + (c - '0');
+    }
+    return result;
+}
+
+NOINLINE expected<i32> parse_or_return(std::string_view text) {
+    if (text.empty()) { return unexpected { nonstd::error::pebcak }; }
+    i32 result = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') {
+            return unexpected { nonstd::error::pebcak };
+        }
+        result = result * 10 + (c - '0');
+    }
+    return result;
+}
+
+
+NONSTD_BENCHMARK("expected failure paths") {
+    u32 const count = 10'000;
+
+    for (u32 failure_percent : { 0u, 1u, 10u, 50u }) {
+        std::vector<std::string> inputs;
+        inputs.reserve(count);
+        for (u32 i = 0; i < count; ++i) {
+            bool const fail = (i * 7919u) % 100u < failure_percent;
+            inputs.push_back(fail ? "12x4" : std::to_string(i % 10000));
+        }
+
+        auto const & thrown = bench.run(
+            fmt::format("throwing, {}% failures", failure_percent), [&] {
+                i64 sum = 0;
+                for (auto const & input : inputs) {
+                    try { sum += parse_or_throw(input); }
+                    catch (std::system_error const &) { sum -= 1; }
+                }
+                nonstd::do_not_optimize(sum);
+            }, count);
+        auto const & returned = bench.run(
+            fmt::format("expected, {}% failures", failure_percent), [&] {
+                i64 sum = 0;
+                for (auto const & input : inputs) {
+                    sum += parse_or_return(input).value_or(-1);
+                }
+                nonstd::do_not_optimize(sum);
+            }, count);
+
+        if (failure_percent >= 10) {
+            bench.expect_speedup(thrown, returned, 2.0, fmt::format(
+                "expected.h: with {}% failures, returning them is at least "
+                "2x quicker than throwing them", failure_percent));
+        }
+    }
+}
+
+} /* namespace nonstd_bench::expected */
@@ -0,0 +1,586 @@
+/** Expected
+ *  ========
+ *  A value, or the reason there isn't one. For the paths where failure is
+ *  common enough -- cache misses, parse errors, retried I/O -- that throwing
+ *  (and unwinding) would dominate their cost, return an `expected<T, E>`
+ *  instead, and let the caller decide what's exceptional.
+ *
+ *      nonstd::expected<u32> parse_port(std::string_view text) {
+ *          ...
+ *          if (bad) { return nonstd::unexpected { nonstd::error::pebcak }; }
+ *          return port;
+ *      }
+ *
+ *      auto socket = parse_port(text)
+ *          .and_then(open_socket)                      // -> expected<socket>
+ *          .transform([](socket s) { return s.fd; })   // -> expected<i32>
+ *          .or_else([](std::error_code) { return fallback_fd(); });
+ *
+ *  `E` defaults to `std::error_code`, which `nonstd::error` codes convert to.
+ *  Errors are wrapped in an `unexpected` to construct an `expected` from them,
+ *  s.t. a value and an error are never confused, and `unexpect` constructs the
+ *  error in place.
+ *
+ *  The interface follows C++23's `std::expected`;
+ *   - `has_value()`/`operator bool`, `*`/`->`, `error()`, and `value_or(v)`.
+ *   - `value()` throws if there's no value; a `std::system_error` for
+ *     `std::error_code`s (as `BREAK` would), or a `bad_expected_access<E>`.
+ *   - `and_then(fn)` calls `fn(value)`, which returns an `expected<U, E>`.
+ *   - `transform(fn)` calls `fn(value)`, and wraps what it returns.
+ *   - `or_else(fn)` calls `fn(error)`, which returns an `expected<T, G>`.
+ *   - `transform_error(fn)` calls `fn(error)`, and wraps what it returns.
+ *  Each of the monadic operations passes through -- moving, where called on
+ *  an rvalue -- whichever of the value or error it doesn't act on. `T` may
+ *  be `void`, for operations that only succeed or fail.
+ *
+ *  The value and the error are overlaid in a union, behind a flag saying
+ *  which of the two is present, s.t. an `expected<T, E>` is only as big as
+ *  the larger of the two, plus the flag (and padding). If both `T` and `E` are
+ *  trivially copyable, so is `expected<T, E>`, and it's copied with a plain
+ *  memcpy. Small, trivially copyable expecteds are passed and returned in
+ *  registers under the x86-64 and AArch64 ABIs; `expected<u32, i32>` is 8
+ *  bytes, and `expected<u64, i32>` is 16. A `std::error_code` is 16 bytes on
+ *  its own, though, so `expected<u32>` is 24, and is passed in memory. Where
+ *  that matters, use a narrower error type. Assigning an expected may swap
+ *  its value for an error, or vice versa, so neither `T`'s nor `E`'s move
+ *  constructor may throw.
+ */
+
+#pragma once
+
+#include <exception>
+#include <new>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/utility_ext.h>
+
+
+namespace nonstd {
+
+template <typename T, typename E = std::error_code>
+class expected;
+
+
+/** Unexpected
+ *  ----------
+ *  An error, on its way into an `expected`.
+ */
+template <typename E>
+class unexpected {
+private:
+    E m_error;
+
+public:
+    template < typename G = E
+             , typename = std::enable_if_t<
+                   std::is_constructible_v<E, G&&>
+                && !std::is_same_v<std::decay_t<G>, unexpected> > >
+    constexpr explicit unexpected(G && error)
+        : m_error ( std::forward<G>(error) )
+    { }
+
+    constexpr E       &  error()       &  noexcept { return m_error; }
+    constexpr E const &  error() const &  noexcept { return m_error; }
+    constexpr E       && error()       && noexcept {
+        return std::move(m_error);
+    }
+    constexpr E const && error() const && noexcept {
+        return std::move(m_error);
+    }
+};
+
+template <typename E>
+unexpected(E) -> unexpected<E>;
+
+/** Tag type for constructing an `expected`'s error in place. */
+struct unexpect_t {
+    explicit unexpect_t() = default;
+};
+inline constexpr unexpect_t unexpect { };
+
+
+namespace exception {
+
+/** Thrown by `value()` on an `expected` with no value, unless `E` is a
+ *  `std::error_code` (in which case a `std::system_error` is thrown).
+ */
+template <typename E>
+class bad_expected_access : public std::exception {
+private:
+    E m_error;
+
+public:
+    explicit bad_expected_access(E error) : m_error ( std::move(error) ) { }
+
+    E const & error() const noexcept { return m_error; }
+    char const * what() const noexcept override {
+        return "Attempted to access the value of an expected that holds an "
+               "error.";
+    }
+};
+
+} /* namespace exception */
+
+
+namespace detail::expected_ {
+
+/** Stands in for the value of an `expected<void, E>`. */
+struct unit { };
+
+template <typename T>
+using stored_t = std::conditional_t<std::is_void_v<T>, unit, T>;
+
+template <typename T>
+struct is_expected : std::false_type { };
+template <typename T, typename E>
+struct is_expected<expected<T, E>> : std::true_type { };
+
+/** Call `fn` with the value of `self` -- or with nothing, if it's void. */
+template <typename Self, typename Fn>
+constexpr decltype(auto) invoke_value(Self && self, Fn && fn) {
+    using value_type = typename std::decay_t<Self>::value_type;
+    if constexpr (std::is_void_v<value_type>) {
+        return std::forward<Fn>(fn)();
+    } else {
+        return std::forward<Fn>(fn)(*std::forward<Self>(self));
+    }
+}
+
+template <typename Self, typename Fn>
+using value_result_t = std::remove_cv_t<std::remove_reference_t<decltype(
+    invoke_value(std::declval<Self>(), std::declval<Fn>()))>>;
+
+template <typename Self, typename Fn>
+using error_result_t = std::remove_cv_t<std::remove_reference_t<decltype(
+    std::declval<Fn>()(std::declval<Self>().error()))>>;
+
+
+/** Storage
+ *  -------
+ *  The value and the error share a union, behind a flag saying which of the
+ *  two is alive. The special members are left to the compiler when both `T`
+ *  and `E` are trivially copyable, s.t. the `expected` is too.
+ */
+template < typename T
+         , typename E
+         , bool Trivial = std::is_trivially_copyable_v<T>
+                       && std::is_trivially_copyable_v<E> >
+class storage {
+public:
+    bool m_has_value;
+    union {
+        T m_value;
+        E m_error;
+    };
+
+    template <typename ... Args>
+    constexpr explicit storage(nonstd::in_place_t /*unused*/, Args && ... args)
+        : m_has_value ( true )
+        , m_value     ( std::forward<Args>(args)... )
+    { }
+    template <typename ... Args>
+    constexpr explicit storage(unexpect_t /*unused*/, Args && ... args)
+        : m_has_value ( false )
+        , m_error     ( std::forward<Args>(args)... )
+    { }
+};
+
+template <typename T, typename E>
+class storage<T, E, /* Trivial */ false> {
+public:
+    bool m_has_value;
+    union {
+        T m_value;
+        E m_error;
+    };
+
+    template <typename ... Args>
+    explicit storage(nonstd::in_place_t /*unused*/, Args && ... args)
+        : m_has_value ( true )
+        , m_value     ( std::forward<Args>(args)... )
+    { }
+    template <typename ... Args>
+    explicit storage(unexpect_t /*unused*/, Args && ... args)
+        : m_has_value ( false )
+        , m_error     ( std::forward<Args>(args)... )
+    { }
+
+    storage(storage const & rhs) : m_has_value ( rhs.m_has_value ) {
+        _construct_from(rhs);
+    }
+    storage(storage && rhs)
+    noexcept(std::is_nothrow_move_constructible_v<T>
+          && std::is_nothrow_move_constructible_v<E>)
+        : m_has_value ( rhs.m_has_value )
+    {
+        _construct_from(std::move(rhs));
+    }
+    ~storage() { _destroy(); }
+
+    /* Switching between the value and the error destroys one before the
+     * other is constructed. The copy is made first, and then moved in, s.t.
+     * only a move -- which mustn't throw -- happens in between. */
+    storage& operator= (storage const & rhs) {
+        if (this == &rhs) { return *this; }
+        if (m_has_value == rhs.m_has_value) {
+            if (m_has_value) { m_value = rhs.m_value; }
+            else             { m_error = rhs.m_error; }
+            return *this;
+        }
+        return *this = storage { rhs };
+    }
+    storage& operator= (storage && rhs)
+    noexcept(std::is_nothrow_move_assignable_v<T>
+          && std::is_nothrow_move_assignable_v<E>) {
+        static_assert(std::is_nothrow_move_constructible_v<T>
+                   && std::is_nothrow_move_constructible_v<E>,
+            "Assigning an expected may replace its value with its error, or "
+            "vice versa, which requires that neither move throws.");
+        if (this == &rhs) { return *this; }
+        if (m_has_value == rhs.m_has_value) {
+            if (m_has_value) { m_value = std::move(rhs.m_value); }
+            else             { m_error = std::move(rhs.m_error); }
+            return *this;
+        }
+        _destroy();
+        m_has_value = rhs.m_has_value;
+        _construct_from(std::move(rhs));
+        return *this;
+    }
+
+private:
+    /* Construct whichever of `rhs`'s members is alive; `m_has_value` must
+     * already match it. */
+    template <typename S>
+    void _construct_from(S && rhs) {
+        if (m_has_value) {
+            new ((void*)&m_value) T(std::forward<S>(rhs).m_value);
+        } else {
+            new ((void*)&m_error) E(std::forward<S>(rhs).m_error);
+        }
+    }
+
+    void _destroy() noexcept {
+        if (m_has_value) { m_value.~T(); }
+        else             { m_error.~E(); }
+    }
+};
+
+} /* namespace detail::expected_ */
+
+
+template <typename T, typename E>
+class expected
+    : private detail::expected_::storage<detail::expected_::stored_t<T>, E>
+{
+    static_assert(!std::is_reference_v<T>,
+        "expected can't hold references; use a pointer or reference_wrapper.");
+
+    using stored_type = detail::expected_::stored_t<T>;
+    using base        = detail::expected_::storage<stored_type, E>;
+
+public:
+    using value_type      = T;
+    using error_type      = E;
+    using unexpected_type = nonstd::unexpected<E>;
+    template <typename U>
+    using rebind = expected<U, E>;
+
+
+    /** Construction
+     *  ------------
+     */
+    template < typename S = stored_type
+             , typename = std::enable_if_t<
+                   std::is_default_constructible_v<S>> >
+    constexpr expected() : base ( nonstd::in_place ) { }
+
+    template < typename U = T
+             , typename = std::enable_if_t<
+                   !std::is_void_v<T>
+                && std::is_constructible_v<stored_type, U&&>
+                && !std::is_same_v<std::decay_t<U>, nonstd::in_place_t>
+                && !std::is_same_v<std::decay_t<U>, unexpect_t>
+                && !std::is_same_v<std::decay_t<U>, expected>
+                && !detail::expected_::is_expected<std::decay_t<U>>::value> >
+    constexpr expected(U && value)
+        : base ( nonstd::in_place, std::forward<U>(value) )
+    { }
+
+    template <typename ... Args>
+    constexpr explicit expected(nonstd::in_place_t /*unused*/,
+                                Args && ... args)
+        : base ( nonstd::in_place, std::forward<Args>(args)... )
+    { }
+
+    template < typename G
+             , typename = std::enable_if_t<
+                   std::is_constructible_v<E, G const &>> >
+    constexpr expected(nonstd::unexpected<G> const & error)
+        : base ( unexpect, error.error() )
+    { }
+    template < typename G
+             , typename = std::enable_if_t<std::is_constructible_v<E, G&&>> >
+    constexpr expected(nonstd::unexpected<G> && error)
+        : base ( unexpect, std::move(error).error() )
+    { }
+
+    template <typename ... Args>
+    constexpr explicit expected(unexpect_t /*unused*/, Args && ... args)
+        : base ( unexpect, std::forward<Args>(args)... )
+    { }
+
+
+    /** Observers
+     *  ---------
+     */
+    constexpr bool has_value() const noexcept {
+        return this->m_has_value;
+    }
+    constexpr explicit operator bool () const noexcept { return has_value(); }
+
+    template < typename S = stored_type
+             , typename = std::enable_if_t<!std::is_void_v<T>, S> >
+    constexpr S       *  operator-> ()       noexcept {
+        return &this->m_value;
+    }
+    template < typename S = stored_type
+             , typename = std::enable_if_t<!std::is_void_v<T>, S> >
+    constexpr S const *  operator-> () const noexcept {
+        return &this->m_value;
+    }
+
+    constexpr decltype(auto) operator* ()       &  noexcept {
+        return value_ref(this->m_value);
+    }
+    constexpr decltype(auto) operator* () const &  noexcept {
+        return value_ref(this->m_value);
+    }
+    constexpr decltype(auto) operator* ()       && noexcept {
+        return value_ref(std::move(this->m_value));
+    }
+    constexpr decltype(auto) operator* () const && noexcept {
+        return value_ref(std::move(this->m_value));
+    }
+
+    constexpr decltype(auto) value()       &  {
+        _check_value();
+        return **this;
+    }
+    constexpr decltype(auto) value() const &  {
+        _check_value();
+        return **this;
+    }
+    constexpr decltype(auto) value()       && {
+        _check_value();
+        return *std::move(*this);
+    }
+    constexpr decltype(auto) value() const && {
+        _check_value();
+        return *std::move(*this);
+    }
+
+    constexpr E       &  error()       &  noexcept { return this->m_error; }
+    constexpr E const &  error() const &  noexcept { return this->m_error; }
+    constexpr E       && error()       && noexcept {
+        return std::move(this->m_error);
+    }
+    constexpr E const && error() const && noexcept {
+        return std::move(this->m_error);
+    }
+
+    template < typename U >
+    constexpr T value_or(U && value) const & {
+        return has_value() ? **this : static_cast<T>(std::forward<U>(value));
+    }
+    template < typename U >
+    constexpr T value_or(U && value) && {
+        return has_value() ? *std::move(*this)
+                           : static_cast<T>(std::forward<U>(value));
+    }
+
+
+    /** Monadic Operations
+     *  ------------------
+     */
+    template <typename Fn> constexpr auto and_then(Fn && fn) & {
+        return and_then_impl(*this, std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto and_then(Fn && fn) const & {
+        return and_then_impl(*this, std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto and_then(Fn && fn) && {
+        return and_then_impl(std::move(*this), std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto and_then(Fn && fn) const && {
+        return and_then_impl(std::move(*this), std::forward<Fn>(fn));
+    }
+
+    template <typename Fn> constexpr auto transform(Fn && fn) & {
+        return transform_impl(*this, std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto transform(Fn && fn) const & {
+        return transform_impl(*this, std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto transform(Fn && fn) && {
+        return transform_impl(std::move(*this), std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto transform(Fn && fn) const && {
+        return transform_impl(std::move(*this), std::forward<Fn>(fn));
+    }
+
+    template <typename Fn> constexpr auto or_else(Fn && fn) & {
+        return or_else_impl(*this, std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto or_else(Fn && fn) const & {
+        return or_else_impl(*this, std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto or_else(Fn && fn) && {
+        return or_else_impl(std::move(*this), std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto or_else(Fn && fn) const && {
+        return or_else_impl(std::move(*this), std::forward<Fn>(fn));
+    }
+
+    template <typename Fn> constexpr auto transform_error(Fn && fn) & {
+        return transform_error_impl(*this, std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto transform_error(Fn && fn) const & {
+        return transform_error_impl(*this, std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto transform_error(Fn && fn) && {
+        return transform_error_impl(std::move(*this), std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto transform_error(Fn && fn) const && {
+        return transform_error_impl(std::move(*this), std::forward<Fn>(fn));
+    }
+
+private:
+    template <typename V>
+    static constexpr decltype(auto) value_ref(V && value) noexcept {
+        if constexpr (std::is_void_v<T>) { return; }
+        else { return std::forward<V>(value); }
+    }
+
+    constexpr void _check_value() const {
+        if (has_value()) { return; }
+        if constexpr (std::is_same_v<E, std::error_code>) {
+            throw std::system_error { this->m_error };
+        } else {
+            throw exception::bad_expected_access<E> { this->m_error };
+        }
+    }
+
+    template <typename Self, typename Fn>
+    static constexpr auto and_then_impl(Self && self, Fn && fn) {
+        using result = detail::expected_::value_result_t<Self, Fn>;
+        static_assert(detail::expected_::is_expected<result>::value,
+            "and_then's function must return an expected.");
+        static_assert(std::is_same_v<typename result::error_type, E>,
+            "and_then's function must return an expected of the same error.");
+        if (self.has_value()) {
+            return detail::expected_::invoke_value(std::forward<Self>(self),
+                                                   std::forward<Fn>(fn));
+        }
+        return result { unexpect, std::forward<Self>(self).error() };
+    }
+
+    template <typename Self, typename Fn>
+    static constexpr auto transform_impl(Self && self, Fn && fn) {
+        using value  = detail::expected_::value_result_t<Self, Fn>;
+        using result = expected<value, E>;
+        if (!self.has_value()) {
+            return result { unexpect, std::forward<Self>(self).error() };
+        }
+        if constexpr (std::is_void_v<value>) {
+            detail::expected_::invoke_value(std::forward<Self>(self),
+                                            std::forward<Fn>(fn));
+            return result { };
+        } else {
+            return result { nonstd::in_place,
+                            detail::expected_::invoke_value(
+                                std::forward<Self>(self),
+                                std::forward<Fn>(fn)) };
+        }
+    }
+
+    template <typename Self, typename Fn>
+    static constexpr auto or_else_impl(Self && self, Fn && fn) {
+        using result = detail::expected_::error_result_t<Self, Fn>;
+        static_assert(detail::expected_::is_expected<result>::value,
+            "or_else's function must return an expected.");
+        static_assert(std::is_same_v<typename result::value_type, T>,
+            "or_else's function must return an expected of the same value.");
+        if (!self.has_value()) {
+            return std::forward<Fn>(fn)(std::forward<Self>(self).error());
+        }
+        if constexpr (std::is_void_v<T>) {
+            return result { };
+        } else {
+            return result { nonstd::in_place, *std::forward<Self>(self) };
+        }
+    }
+
+    template <typename Self, typename Fn>
+    static constexpr auto transform_error_impl(Self && self, Fn && fn) {
+        using error  = detail::expected_::error_result_t<Self, Fn>;
+        using result = expected<T, error>;
+        if (!self.has_value()) {
+            return result { unexpect,
+                            std::forward<Fn>(fn)(
+                                std::forward<Self>(self).error()) };
+        }
+        if constexpr (std::is_void_v<T>) {
+            return result { };
+        } else {
+            return result { nonstd::in_place, *std::forward<Self>(self) };
+        }
+    }
+};
+
+
+/** Comparisons
+ *  -----------
+ */
+template <typename T, typename E, typename U, typename G>
+constexpr bool operator== (expected<T, E> const & lhs,
+                           expected<U, G> const & rhs) {
+    if (lhs.has_value() != rhs.has_value()) { return false; }
+    if (!lhs.has_value()) { return lhs.error() == rhs.error(); }
+    if constexpr (std::is_void_v<T>) { return true; }
+    else { return *lhs == *rhs; }
+}
+template <typename T, typename E, typename U, typename G>
+constexpr bool operator!= (expected<T, E> const & lhs,
+                           expected<U, G> const & rhs) {
+    return !(lhs == rhs);
+}
+
+template < typename T, typename E, typename U
+         , typename = std::enable_if_t<
+               !detail::expected_::is_expected<U>::value> >
+constexpr bool operator== (expected<T, E> const & lhs, U const & value) {
+    return lhs.has_value() && *lhs == value;
+}
+template < typename T, typename E, typename U
+         , typename = std::enable_if_t<
+               !detail::expected_::is_expected<U>::value> >
+constexpr bool operator!= (expected<T, E> const & lhs, U const & value) {
+    return !(lhs == value);
+}
+
+template <typename T, typename E, typename G>
+constexpr bool operator== (expected<T, E> const & lhs,
+                           unexpected<G> const & error) {
+    return !lhs.has_value() && lhs.error() == error.error();
+}
+template <typename T, typename E, typename G>
+constexpr bool operator!= (expected<T, E> const & lhs,
+                           unexpected<G> const & error) {
+    return !(lhs == error);
+}
+
+} /* namespace nonstd */
@@ -0,0 +1,187 @@
+/** Expected Tests
+ *  ==============
+ *  GOAL: Validate that expecteds hold a value or an error, that the monadic
+ *  operations act on the right one and pass the other through (moving from
+ *  rvalues), that the value and error share storage, and that expecteds of
+ *  trivially copyable types are themselves trivially copyable and usable at
+ *  compile time.
+ */
+
+#include <nonstd/expected.h>
+#include <platform/testrunner/testrunner.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+
+
+namespace nonstd_test::expected {
+
+using nonstd::expected;
+using nonstd::unexpect;
+using nonstd::unexpected;
+
+static_assert(std::is_trivially_copyable_v<expected<u32>>);
+static_assert(std::is_trivially_copyable_v<expected<void>>);
+static_assert(std::is_trivially_copyable_v<expected<f32, i32>>);
+static_assert(!std::is_trivially_copyable_v<expected<std::string>>);
+
+// The value and error overlap; only the flag (and padding) is added.
+static_assert(sizeof(expected<u32, i32>) == 2 * sizeof(u32));
+static_assert(sizeof(expected<u64, i32>) == 2 * sizeof(u64));
+static_assert(sizeof(expected<void, i32>) == 2 * sizeof(i32));
+static_assert(sizeof(expected<u32>)
+              == sizeof(std::error_code) + alignof(std::error_code));
+
+namespace cx {
+constexpr expected<i32, i32> half(i32 x) {
+    if (x % 2 != 0) { return unexpected { x }; }
+    return x / 2;
+}
+static_assert(half(8).and_then(half) == 2);
+static_assert(half(8).and_then(half).and_then(half).and_then(half)
+              == unexpected { 1 });
+static_assert(half(3).transform([](i32 x) { return x + 1; }).error() == 3);
+static_assert(half(3).or_else([](i32) { return expected<i32, i32> { 0 }; })
+              == 0);
+static_assert(half(3).value_or(-1) == -1);
+} /* namespace cx */
+
+
+/** Parse a non-negative decimal integer. */
+expected<i32> parse(std::string_view text) {
+    if (text.empty()) {
+        return unexpected { nonstd::error::pebcak };
+    }
+    i32 result = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') {
+            return unexpected { nonstd::error::pebcak };
+        }
+        result = result * 10 + (c - '0');
+    }
+    return result;
+}
+
+
+TEST_CASE("Expected", "[nonstd][expected]") {
+    SECTION("hold a value or an error") {
+        auto const good = parse("42");
+        REQUIRE(good);
+        REQUIRE(*good == 42);
+        REQUIRE(good.value() == 42);
+
+        auto const bad = parse("4x2");
+        REQUIRE_FALSE(bad.has_value());
+        REQUIRE(bad.error() == nonstd::error::pebcak);
+        auto const code = std::error_code { nonstd::error::pebcak };
+        REQUIRE(bad == unexpected { code });
+        REQUIRE(bad.value_or(7) == 7);
+    }
+
+    SECTION("throw system_errors from value() when holding error codes") {
+        auto const bad = parse("");
+        REQUIRE_THROWS_AS(bad.value(), std::system_error);
+
+        expected<i32, std::string> other { unexpect, "nope" };
+        REQUIRE_THROWS_AS(other.value(),
+                          nonstd::exception::bad_expected_access<std::string>);
+    }
+
+    SECTION("chain operations") {
+        auto doubled = [](i32 x) { return x * 2; };
+        auto positive = [](i32 x) -> expected<i32> {
+            if (x > 0) { return x; }
+            return unexpected { nonstd::error::error };
+        };
+        REQUIRE(parse("21").transform(doubled).and_then(positive) == 42);
+        REQUIRE(parse("0").and_then(positive).error()
+                == nonstd::error::error);
+        REQUIRE(parse("?").transform(doubled).and_then(positive).error()
+                == nonstd::error::pebcak);
+
+        auto const recovered = parse("?").or_else([](std::error_code) {
+            return expected<i32> { -1 };
+        });
+        REQUIRE(recovered == -1);
+
+        auto const described = parse("?").transform_error(
+            [](std::error_code code) { return code.value(); });
+        static_assert(std::is_same_v<decltype(described)::error_type, int>);
+        REQUIRE(described.error() == i32(nonstd::error::pebcak));
+    }
+
+    SECTION("move values through rvalue chains") {
+        auto owned = expected<std::unique_ptr<i32>> {
+            std::make_unique<i32>(5) };
+        auto const result = std::move(owned)
+            .transform([](std::unique_ptr<i32> p) { *p += 1; return p; })
+            .and_then([](std::unique_ptr<i32> p) {
+                return expected<std::unique_ptr<i32>> { std::move(p) };
+            });
+        REQUIRE(**result == 6);
+
+        expected<std::string> text { "a fairly long string, to defeat SSO" };
+        auto const kept = std::move(text).or_else([](std::error_code) {
+            return expected<std::string> { "" };
+        });
+        REQUIRE(kept->size() == 35);
+    }
+
+    SECTION("hold nothing but success or an error, for void") {
+        expected<void> ok;
+        REQUIRE(ok.has_value());
+        ok.value();
+
+        expected<void> failed { unexpect, nonstd::error::cancelled };
+        REQUIRE_THROWS_AS(failed.value(), std::system_error);
+
+        i32 calls = 0;
+        auto const next = ok.and_then([&] { calls += 1; return expected<i32> {
+            calls }; });
+        REQUIRE(next == 1);
+        REQUIRE(failed.transform([&] { calls += 1; }).error()
+                == nonstd::error::cancelled);
+        REQUIRE(calls == 1);
+    }
+
+    SECTION("copy and assign non-trivial values") {
+        expected<std::vector<i32>> a { std::vector<i32> { 1, 2, 3 } };
+        expected<std::vector<i32>> b { unexpect, nonstd::error::error };
+        b = a;
+        REQUIRE(b->size() == 3);
+        a = unexpected { std::error_code { nonstd::error::pebcak } };
+        REQUIRE_FALSE(a);
+        b = std::move(a);
+        REQUIRE(b.error() == nonstd::error::pebcak);
+    }
+
+    SECTION("destroy the value or error it replaces") {
+        auto value = std::make_shared<i32>(1);
+        auto error = std::make_shared<i32>(2);
+        using both = expected<std::shared_ptr<i32>, std::shared_ptr<i32>>;
+        {
+            both e { value };
+            both const failed { unexpect, error };
+            REQUIRE(value.use_count() == 2);
+            e = failed;
+            REQUIRE(value.use_count() == 1);
+            REQUIRE(error.use_count() == 3);
+            e = both { value };
+            REQUIRE(value.use_count() == 2);
+            REQUIRE(error.use_count() == 2);
+            both copy { e };
+            REQUIRE(value.use_count() == 3);
+            REQUIRE(*copy.value() == 1);
+        }
+        REQUIRE(value.use_count() == 1);
+        REQUIRE(error.use_count() == 1);
+    }
+}
+
+} /* namespace nonstd_test::expected */
@@ -0,0 +1,303 @@
+/** Fibers
+ *  ======
+ *  Cooperatively scheduled execution contexts; each `fiber` owns a stack and a
+ *  saved register set, and `switch_fiber(from, to)` suspends the running fiber
+ *  and resumes another on the calling thread. Nothing here schedules anything;
+ *  see job_system.h for the thing that does.
+ *
+ *  There are three backends;
+ *   - x86-64 System V (Linux, macOS): a hand-written switch. Only the stack
+ *     pointer, frame pointer, and resume address are pushed to the suspended
+ *     stack; everything else is declared clobbered, so the compiler spills only
+ *     the registers that are live across the switch. No syscalls, no signal
+ *     mask juggling.
+ *   - Other POSIX targets: `<ucontext.h>`. Correct, but `swapcontext` saves the
+ *     signal mask on every switch, which costs a syscall.
+ *   - Windows: the Win32 Fiber API.
+ *
+ *  NB. The x86-64 switch doesn't preserve MXCSR or the x87 control word. Fibers
+ *  that run on the same thread are expected to share floating point state.
+ *
+ *  NB. A suspended fiber may be resumed on a different thread than the one that
+ *  suspended it. Don't cache the address of `thread_local` data across a call
+ *  to `switch_fiber`.
+ */
+
+#pragma once
+
+#include <cstdlib>
+#include <type_traits>
+
+#include <nonstd/nonstd.h>
+
+#if defined(NONSTD_OS_WINDOWS)
+#  include <nonstd/windows.h>
+#  define NONSTD_FIBER_WIN32 true
+#elif defined(__x86_64__)
+#  include <sys/mman.h>
+#  include <unistd.h>
+#  define NONSTD_FIBER_X86_64 true
+#else
+#  include <sys/mman.h>
+#  include <ucontext.h>
+#  include <unistd.h>
+#  define NONSTD_FIBER_UCONTEXT true
+#endif
+
+
+namespace nonstd {
+
+class fiber;
+inline void switch_fiber(fiber & from, fiber & to) noexcept;
+
+
+namespace detail::fiber_ {
+
+/** Fiber Stacks
+ *  ------------
+ *  `mmap`ed, with an inaccessible guard page below the stack so an overflow
+ *  faults immediately rather than quietly corrupting a neighbouring stack.
+ */
+#if !defined(NONSTD_FIBER_WIN32)
+struct stack {
+    ptr    base;
+    size_t size;
+
+    static size_t page_size() noexcept {
+        static size_t const size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    explicit stack(size_t requested)
+        : base ( nullptr )
+        , size ( 0       )
+    {
+        size_t const page = page_size();
+        size = ((requested + page - 1) / page + 1) * page;
+        void * mem = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        BREAK_IF(mem == MAP_FAILED, nonstd::error::insufficient_memory,
+                 "Failed to map a {} byte fiber stack", size);
+        bool const guarded = mprotect(mem, page, PROT_NONE) == 0;
+        if (!guarded) { munmap(mem, size); }
+        BREAK_IF(!guarded, nonstd::error::os,
+                 "Failed to protect the guard page of a fiber stack");
+        base = static_cast<ptr>(mem);
+    }
+
+    ~stack() {
+        if (base) { munmap(base, size); }
+    }
+
+    ptr top() const noexcept { return base + size; }
+};
+#endif
+
+/** Saved Context
+ *  -------------
+ *  This is the first member of `fiber`, s.t. the x86-64 entry trampoline can
+ *  recover the `fiber*` from the address the switch was given.
+ */
+struct context {
+#if defined(NONSTD_FIBER_X86_64)
+    void * stack_pointer = nullptr;
+#elif defined(NONSTD_FIBER_UCONTEXT)
+    ucontext_t ucontext;
+#elif defined(NONSTD_FIBER_WIN32)
+    LPVOID handle = nullptr;
+#endif
+};
+
+} /* namespace detail::fiber_ */
+
+
+/** Fiber
+ *  -----
+ *  A fiber is created either around the calling thread's own stack (with
+ *  `fiber::this_thread`), which lets that thread switch into other fibers and
+ *  later be switched back to, or with an entry function and a new stack.
+ *
+ *  An entry function must never return; it should instead switch to another
+ *  fiber, and let its own fiber be destroyed while suspended.
+ */
+class fiber {
+public:
+    using entry_t = void (*)(void * arg);
+
+    static constexpr size_t default_stack_size = KBYTES(64);
+
+    struct this_thread_t { };
+    static constexpr this_thread_t this_thread { };
+
+private:
+    detail::fiber_::context m_context;
+    entry_t                 m_entry;
+    void *                  m_arg;
+#if defined(NONSTD_FIBER_WIN32)
+    bool                    m_converted_thread;
+#else
+    detail::fiber_::stack * m_stack;
+#endif
+
+    friend void switch_fiber(fiber & from, fiber & to) noexcept;
+
+    [[noreturn]] static void run(fiber & self) noexcept {
+        self.m_entry(self.m_arg);
+        fmt::print("A fiber entry function returned. Fiber entry functions "
+                   "must switch away, and never return.\n");
+        std::abort();
+    }
+
+#if defined(NONSTD_FIBER_X86_64)
+    // Jumped to -- not called -- by the first switch into this fiber. The
+    // switch leaves `&from.m_context` in %rdi and `&to.m_context` in %rsi,
+    // which are exactly where the SysV ABI expects our arguments.
+    [[noreturn]] static void trampoline(void * /*from*/, void * to) noexcept {
+        run(*reinterpret_cast<fiber *>(to));
+    }
+#elif defined(NONSTD_FIBER_UCONTEXT)
+    // `makecontext` only forwards `int` arguments, so the `fiber*` is split.
+    // The halves are joined in 64 bits; shifting a 32-bit `uintptr_t` by 32
+    // is undefined, and there `hi` is always zero.
+    static void trampoline(u32 hi, u32 lo) noexcept {
+        auto const addr = static_cast<uintptr_t>((u64{hi} << 32) | u64{lo});
+        run(*reinterpret_cast<fiber *>(addr));
+    }
+#elif defined(NONSTD_FIBER_WIN32)
+    static void WINAPI trampoline(LPVOID self) noexcept {
+        run(*static_cast<fiber *>(self));
+    }
+#endif
+
+public:
+    explicit fiber(this_thread_t /*unused*/)
+        : m_context ( )
+        , m_entry   ( nullptr )
+        , m_arg     ( nullptr )
+#if defined(NONSTD_FIBER_WIN32)
+        , m_converted_thread ( false )
+#else
+        , m_stack   ( nullptr )
+#endif
+    {
+#if defined(NONSTD_FIBER_WIN32)
+        if (IsThreadAFiber()) {
+            m_context.handle = GetCurrentFiber();
+        } else {
+            m_context.handle = ConvertThreadToFiber(nullptr);
+            m_converted_thread = true;
+        }
+        BREAK_IF(m_context.handle == nullptr, nonstd::error::os,
+                 "Failed to convert the calling thread to a fiber");
+#endif
+    }
+
+    fiber(entry_t entry, void * arg, size_t stack_size = default_stack_size)
+        : m_context ( )
+        , m_entry   ( entry )
+        , m_arg     ( arg   )
+#if defined(NONSTD_FIBER_WIN32)
+        , m_converted_thread ( false )
+#else
+        , m_stack   ( new detail::fiber_::stack(stack_size) )
+#endif
+    {
+#if defined(NONSTD_FIBER_X86_64)
+        // Lay the stack out as though `trampoline` had just been called; the
+        // resume address and the saved %rbp sit below a null return address,
+        // and the entry %rsp is 8 bytes off of 16 byte alignment.
+        auto top = reinterpret_cast<uintptr_t>(m_stack->top()) & ~uintptr_t{15};
+        auto sp  = reinterpret_cast<void **>(top);
+        *--sp = nullptr;                                            // ret addr
+        *--sp = nullptr;                                            // %rbp
+        *--sp = reinterpret_cast<void *>(&fiber::trampoline);       // resume
+        m_context.stack_pointer = sp;
+#elif defined(NONSTD_FIBER_UCONTEXT)
+        getcontext(&m_context.ucontext);
+        m_context.ucontext.uc_stack.ss_sp   = m_stack->base
+                                            + detail::fiber_::stack::page_size();
+        m_context.ucontext.uc_stack.ss_size = m_stack->size
+                                            - detail::fiber_::stack::page_size();
+        m_context.ucontext.uc_link = nullptr;
+        auto const addr = static_cast<u64>(reinterpret_cast<uintptr_t>(this));
+        makecontext(&m_context.ucontext,
+                    reinterpret_cast<void (*)()>(&fiber::trampoline), 2,
+                    static_cast<u32>(addr >> 32), static_cast<u32>(addr));
+#elif defined(NONSTD_FIBER_WIN32)
+        m_context.handle = CreateFiber(stack_size, &fiber::trampoline, this);
+        BREAK_IF(m_context.handle == nullptr, nonstd::error::os,
+                 "Failed to create a {} byte fiber", stack_size);
+#endif
+    }
+
+    fiber(fiber const &) = delete;
+    fiber(fiber &&) = delete;
+    fiber& operator= (fiber const &) = delete;
+    fiber& operator= (fiber &&) = delete;
+
+    ~fiber() {
+#if defined(NONSTD_FIBER_WIN32)
+        if (m_converted_thread) {
+            ConvertFiberToThread();
+        } else if (m_entry != nullptr && m_context.handle != nullptr) {
+            DeleteFiber(m_context.handle);
+        }
+#else
+        delete m_stack;
+#endif
+    }
+};
+
+static_assert(std::is_standard_layout_v<fiber>,
+    "`fiber` must be standard layout s.t. `m_context` is interconvertible "
+    "with the `fiber` itself.");
+
+
+/** Switch Fiber
+ *  ------------
+ *  Save the state of the running fiber into `from`, and resume `to`. Returns
+ *  when some thread switches back to `from`.
+ */
+inline void switch_fiber(fiber & from, fiber & to) noexcept {
+#if defined(NONSTD_FIBER_X86_64)
+    void * from_ctx = &from.m_context;
+    void * to_ctx   = &to.m_context;
+    // Skip the red zone, push %rbp and a resume address to the current stack,
+    // swap stacks, then pop the other fiber's %rbp and resume address and jump.
+    __asm__ __volatile__ (
+        "subq   $128, %%rsp\n\t"
+        "leaq   1f(%%rip), %%rax\n\t"
+        "pushq  %%rbp\n\t"
+        "pushq  %%rax\n\t"
+        "movq   %%rsp, (%%rdi)\n\t"
+        "movq   (%%rsi), %%rsp\n\t"
+        "popq   %%rax\n\t"
+        "popq   %%rbp\n\t"
+        "jmpq   *%%rax\n"
+        "1:\n\t"
+#if defined(__CET__)
+        "endbr64\n\t"
+#endif
+        "addq   $128, %%rsp\n\t"
+        : "+D" (from_ctx), "+S" (to_ctx)
+        :
+        : "rax", "rbx", "rcx", "rdx", "r8", "r9", "r10", "r11",
+          "r12", "r13", "r14", "r15", "memory", "cc",
+          "xmm0", "xmm1", "xmm2",  "xmm3",  "xmm4",  "xmm5",  "xmm6",  "xmm7",
+          "xmm8", "xmm9", "xmm10", "xmm11", "xmm12", "xmm13", "xmm14", "xmm15",
+#if defined(__AVX512F__)
+          "xmm16", "xmm17", "xmm18", "xmm19", "xmm20", "xmm21", "xmm22",
+          "xmm23", "xmm24", "xmm25", "xmm26", "xmm27", "xmm28", "xmm29",
+          "xmm30", "xmm31",
+#endif
+          "st", "st(1)", "st(2)", "st(3)", "st(4)", "st(5)", "st(6)", "st(7)"
+    );
+#elif defined(NONSTD_FIBER_UCONTEXT)
+    swapcontext(&from.m_context.ucontext, &to.m_context.ucontext);
+#elif defined(NONSTD_FIBER_WIN32)
+    UNUSED(from);
+    SwitchToFiber(to.m_context.handle);
+#endif
+}
+
+} /* namespace nonstd */
@@ -0,0 +1,74 @@
+/** Frame Pacer Benchmarks
+ *  ======================
+ *  Precision, rather than cost; paces a loop at 240Hz, first with `sleep_for`
+ *  to each boundary, then with `wallclock::delay_until`, and then with a
+ *  `frame_pacer`, and reports how late each frame begins. Lateness isn't a
+ *  per-call cost the harness can sample, so it's only printed.
+ */
+
+#include <nonstd/frame_pacer.h>
+#include <nonstd/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/chrono.h>
+#include <nonstd/wallclock.h>
+
+
+namespace nonstd_bench::frame_pacer {
+
+using nonstd::frame_pacer;
+using nonstd::wallclock;
+using namespace nonstd::literals::chrono_literals;
+
+void report(nonstd::benchmark::suite const & bench, c_cstr name,
+            std::vector<nonstd::chrono::nanoseconds> late) {
+    std::sort(late.begin(), late.end());
+    auto us = [](nonstd::chrono::nanoseconds d) {
+        return f64(d.count()) / 1e3;
+    };
+    fmt::print("{}/{:<20} lateness; median {:>8.2f}us, 99th {:>8.2f}us, "
+               "max {:>8.2f}us\n", bench.name(), name,
+               us(late[late.size() / 2]), us(late[late.size() * 99 / 100]),
+               us(late.back()));
+}
+
+
+NONSTD_BENCHMARK("frame_pacer") {
+    u32 const frames = bench.settings().samples * 8;
+
+    std::vector<nonstd::chrono::nanoseconds> late;
+    frame_pacer const reference { 240_Hz };
+    auto const period = reference.period();
+
+    auto const origin = wallclock::now();
+    for (u32 i = 1; i <= frames; ++i) {
+        auto const deadline = origin + period * i;
+        std::this_thread::sleep_for(deadline - wallclock::now());
+        late.push_back(wallclock::now() - deadline);
+    }
+    report(bench, "sleep_for", late);
+
+    late.clear();
+    for (u32 i = 1; i <= frames; ++i) {
+        auto const deadline = origin + period * (frames + i);
+        wallclock::delay_until(deadline);
+        late.push_back(wallclock::now() - deadline);
+    }
+    report(bench, "delay_until", late);
+
+    frame_pacer pacer { 240_Hz };
+    for (u32 i = 0; i < frames; ++i) { pacer.wait(); }
+    auto const & stats = pacer.stats();
+    fmt::print("{}/pacer: {} frames, {} overruns, {} missed, worst lateness "
+               "{}ns, drift {}ns, sleep margin {}ns\n", bench.name(),
+               stats.frames, stats.overruns, stats.missed,
+               stats.worst_lateness.count(), stats.drift.count(),
+               wallclock::sleep_margin().count());
+}
+
+} /* namespace nonstd_bench::frame_pacer */
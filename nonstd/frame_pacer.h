@@ -0,0 +1,126 @@
+/** Frame Pacer
+ *  ===========
+ *  Paces a loop to a fixed rate;
+ *
+ *      nonstd::frame_pacer pacer { 240_Hz };
+ *      while (running) {
+ *          update_and_render();
+ *          pacer.wait();
+ *      }
+ *
+ *  Frame boundaries are fixed multiples of the period from the pacer's start
+ *  (or last `reset()`), not offsets from whenever the previous `wait()`
+ *  returned, so lateness in one frame doesn't push back every frame after it.
+ *  `wait()` blocks with `wallclock::delay_until`, which sleeps most of the way
+ *  and spins the rest, so frames begin within a few microseconds of their
+ *  boundaries rather than the 50us-1ms that `sleep_for` allows.
+ *
+ *  A frame whose work runs past its boundary is an overrun; `wait()` returns
+ *  at once, and if the work ran past one or more further boundaries those are
+ *  skipped -- counted in `missed` -- rather than run back-to-back to catch up.
+ *  `stats()` reports overruns, the worst oversleep of frames that weren't
+ *  overruns (the pacer's own jitter), and the cumulative drift; how far the
+ *  current frame began behind where the ideal schedule -- `frames` periods
+ *  after the start -- would have put it. Drift only grows with missed
+ *  boundaries, or with lateness in the frame that just began.
+ */
+
+#pragma once
+
+#include <nonstd/nonstd.h>
+#include <nonstd/chrono.h>
+#include <nonstd/wallclock.h>
+
+
+namespace nonstd {
+
+class frame_pacer {
+public:
+    struct stats_t {
+        /** Completed calls to `wait()`. */
+        u64                 frames;
+        /** Frames whose work ran past their boundary. */
+        u64                 overruns;
+        /** Boundaries skipped because an overrun ran past them too. */
+        u64                 missed;
+        /** The longest, and total, time that overrunning work ran past its
+         *  boundary.
+         */
+        chrono::nanoseconds worst_overrun;
+        chrono::nanoseconds total_overrun;
+        /** The latest that `wait()` returned after a boundary it didn't
+         *  overrun; a measure of the delay's precision.
+         */
+        chrono::nanoseconds worst_lateness;
+        /** How far the last frame began behind the ideal schedule. */
+        chrono::nanoseconds drift;
+    };
+
+    template <typename Rep, typename Period>
+    explicit frame_pacer(chrono::frequency<Rep, Period> rate)
+        : m_period ( f64 { 1.0 } / rate )
+    {
+        BREAK_UNLESS(m_period.count() > 0.0 && m_period.count() < 1e18,
+                     nonstd::error::pebcak,
+                     "A frame_pacer's rate must be positive and finite.");
+        reset();
+    }
+
+    /** The time between frame boundaries. */
+    chrono::nanoseconds period() const noexcept {
+        return chrono::round<chrono::nanoseconds>(m_period);
+    }
+
+    /** Block until the next frame boundary; or, if it has passed already,
+     *  record an overrun and return at once.
+     */
+    void wait() {
+        m_frame += 1;
+        auto const deadline = _boundary(m_frame);
+        auto const arrived  = wallclock::now();
+
+        if (arrived <= deadline) {
+            wallclock::delay_until(deadline);
+            auto const late = wallclock::now() - deadline;
+            m_stats.worst_lateness = n2max(m_stats.worst_lateness, late);
+        } else {
+            auto const overrun = arrived - deadline;
+            m_stats.overruns      += 1;
+            m_stats.total_overrun += overrun;
+            m_stats.worst_overrun  = n2max(m_stats.worst_overrun, overrun);
+
+            // Resume the schedule at the last boundary passed, s.t. the next
+            // wait() ends at the first one still ahead.
+            u64 const skipped = u64(
+                chrono::duration<f64, std::nano>(overrun) / m_period);
+            m_frame        += skipped;
+            m_stats.missed += skipped;
+        }
+        m_stats.frames += 1;
+        m_stats.drift   = wallclock::now() - _boundary(m_stats.frames);
+    }
+
+    /** Restart the schedule from now, and zero the statistics. */
+    void reset() {
+        m_origin = wallclock::now();
+        m_frame  = 0;
+        m_stats  = { };
+    }
+
+    stats_t const & stats() const noexcept { return m_stats; }
+
+private:
+    /** The start of frame `n`, rounded once from the exact product s.t.
+     *  truncating the period can't accumulate.
+     */
+    chrono::nanoseconds _boundary(u64 n) const noexcept {
+        return m_origin + chrono::round<chrono::nanoseconds>(m_period * f64(n));
+    }
+
+    chrono::duration<f64, std::nano> m_period;
+    chrono::nanoseconds              m_origin;
+    u64                              m_frame;
+    stats_t                          m_stats;
+};
+
+} /* namespace nonstd */
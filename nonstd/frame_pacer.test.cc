@@ -0,0 +1,81 @@
+/** Frame Pacer Tests
+ *  =================
+ *  GOAL: Validate that a pacer holds a loop to its rate without accumulating
+ *  error, and that overruns skip the boundaries they run past and show up in
+ *  the statistics and drift.
+ *
+ *  Timing on shared test machines is noisy, so the bounds here are loose; the
+ *  pacer's precision is what frame_pacer.bench.cc is for.
+ */
+
+#include <nonstd/frame_pacer.h>
+#include <platform/testrunner/testrunner.h>
+
+#include <thread>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/chrono.h>
+#include <nonstd/wallclock.h>
+
+
+namespace nonstd_test::frame_pacer {
+
+using nonstd::frame_pacer;
+using nonstd::wallclock;
+using namespace nonstd::literals::chrono_literals;
+
+
+TEST_CASE("Frame Pacer", "[nonstd][time][frame_pacer]") {
+    SECTION("compute the period from the rate") {
+        REQUIRE(frame_pacer { 240_Hz }.period() == 4'166'667ns);
+        REQUIRE(frame_pacer { 1_kHz }.period() == 1ms);
+        REQUIRE(frame_pacer { 0.5_Hz }.period() == 2s);
+        REQUIRE_THROWS(frame_pacer { 0_Hz });
+    }
+
+    SECTION("hold a loop to its rate") {
+        frame_pacer pacer { 500_Hz };
+        auto const start = wallclock::now();
+        for (u32 i = 0; i < 100; ++i) { pacer.wait(); }
+        auto const elapsed = wallclock::now() - start;
+
+        auto const & stats = pacer.stats();
+        REQUIRE(stats.frames == 100);
+        REQUIRE(elapsed >= 200ms);
+        // Any frame that was preempted long enough to overrun was skipped,
+        // and its lost time shows up in the drift.
+        REQUIRE(elapsed < 200ms + 2ms * stats.missed + stats.drift + 5ms);
+        if (stats.overruns == 0) {
+            REQUIRE(stats.missed == 0);
+            REQUIRE(stats.worst_overrun == 0ns);
+        }
+    }
+
+    SECTION("skip boundaries that an overrun runs past") {
+        frame_pacer pacer { 1_kHz };
+        pacer.wait();
+        std::this_thread::sleep_for(5500us);
+        pacer.wait();
+
+        auto const & stats = pacer.stats();
+        REQUIRE(stats.frames == 2);
+        REQUIRE(stats.overruns >= 1);
+        REQUIRE(stats.missed >= 4);
+        REQUIRE(stats.worst_overrun >= 4500us);
+        REQUIRE(stats.total_overrun >= stats.worst_overrun);
+        REQUIRE(stats.drift >= 1ms * stats.missed);
+
+        // The next frame waits for the first boundary still ahead, rather
+        // than starting immediately to catch up.
+        auto const before = wallclock::now();
+        pacer.wait();
+        REQUIRE(pacer.stats().overruns == stats.overruns);
+        REQUIRE(wallclock::now() - before <= 1ms + 1ms);
+
+        pacer.reset();
+        REQUIRE(pacer.stats().frames == 0);
+        REQUIRE(pacer.stats().drift == 0ns);
+    }
+}
+
+} /* namespace nonstd_test::frame_pacer */
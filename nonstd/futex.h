@@ -0,0 +1,138 @@
+/** Futex-Style Waits
+ *  =================
+ *  Block the calling thread until a 32-bit atomic word changes, and wake
+ *  threads blocked on a word. This is the primitive that blocking types --
+ *  channels, one-time initializers, etc. -- build their slow paths on. None of
+ *  these calls touch the word itself, and waits may return spuriously; callers
+ *  are expected to re-check their condition in a loop.
+ *
+ *      while (word.load() == busy) {
+ *          nonstd::futex_wait(word, busy);
+ *      }
+ *
+ *  There are three backends;
+ *   - Linux: the `futex(2)` syscall, with process-private waits.
+ *   - Windows: `WaitOnAddress` / `WakeByAddress*` (Windows 8 and up).
+ *   - Everything else: a small, static table of mutex/condition variable
+ *     pairs, hashed by address. Correct, but every wake takes a lock.
+ */
+
+#pragma once
+
+#include <atomic>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/chrono.h>
+
+#if defined(NONSTD_OS_LINUX)
+#  include <climits>
+#  include <ctime>
+#  include <linux/futex.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#  define NONSTD_FUTEX_LINUX true
+#elif defined(NONSTD_OS_WINDOWS)
+#  include <nonstd/windows.h>
+#  pragma comment(lib, "Synchronization.lib")
+#  define NONSTD_FUTEX_WIN32 true
+#else
+#  include <condition_variable>
+#  include <mutex>
+#  define NONSTD_FUTEX_PARKING_LOT true
+#endif
+
+
+namespace nonstd {
+
+static_assert(sizeof(std::atomic<u32>) == sizeof(u32),
+    "Futex waits require `std::atomic<u32>` to be a bare `u32`.");
+
+
+#if defined(NONSTD_FUTEX_PARKING_LOT)
+namespace detail::futex_ {
+
+struct ALIGNAS(cache_line_size) bucket {
+    std::mutex              mutex;
+    std::condition_variable cv;
+};
+
+inline bucket & bucket_for(void const * address) noexcept {
+    static bucket table[64];
+    auto const key = reinterpret_cast<uintptr_t>(address);
+    return table[(key >> 2) % 64];
+}
+
+} /* namespace detail::futex_ */
+#endif
+
+
+/** Block while `word` holds `expected`. */
+inline void futex_wait(std::atomic<u32> const & word, u32 expected) noexcept {
+#if defined(NONSTD_FUTEX_LINUX)
+    syscall(SYS_futex, reinterpret_cast<u32 const *>(&word),
+            FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#elif defined(NONSTD_FUTEX_WIN32)
+    WaitOnAddress(const_cast<std::atomic<u32> *>(&word), &expected,
+                  sizeof(u32), INFINITE);
+#else
+    auto & b = detail::futex_::bucket_for(&word);
+    std::unique_lock<std::mutex> lock { b.mutex };
+    if (word.load(std::memory_order_acquire) == expected) { b.cv.wait(lock); }
+#endif
+}
+
+/** Block while `word` holds `expected`, for no longer than `timeout`. */
+inline void futex_wait_for(std::atomic<u32> const & word, u32 expected,
+                           chrono::nanoseconds timeout) noexcept {
+    if (timeout <= chrono::nanoseconds::zero()) { return; }
+#if defined(NONSTD_FUTEX_LINUX)
+    timespec ts;
+    ts.tv_sec  = static_cast<time_t>(timeout.count() / 1'000'000'000);
+    ts.tv_nsec = static_cast<long>(timeout.count() % 1'000'000'000);
+    syscall(SYS_futex, reinterpret_cast<u32 const *>(&word),
+            FUTEX_WAIT_PRIVATE, expected, &ts, nullptr, 0);
+#elif defined(NONSTD_FUTEX_WIN32)
+    auto const ms = chrono::ceil<chrono::milliseconds>(timeout).count();
+    auto const wait_ms = static_cast<DWORD>(n2min(ms, i64{INFINITE - 1}));
+    WaitOnAddress(const_cast<std::atomic<u32> *>(&word), &expected,
+                  sizeof(u32), wait_ms);
+#else
+    auto & b = detail::futex_::bucket_for(&word);
+    std::unique_lock<std::mutex> lock { b.mutex };
+    if (word.load(std::memory_order_acquire) == expected) {
+        b.cv.wait_for(lock, timeout);
+    }
+#endif
+}
+
+/** Wake at least one thread blocked on `word`. */
+inline void futex_wake_one(std::atomic<u32> const & word) noexcept {
+#if defined(NONSTD_FUTEX_LINUX)
+    syscall(SYS_futex, reinterpret_cast<u32 const *>(&word),
+            FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#elif defined(NONSTD_FUTEX_WIN32)
+    WakeByAddressSingle(const_cast<std::atomic<u32> *>(&word));
+#else
+    // Buckets are shared between words, so waking one might wake the wrong
+    // thread. Wake them all.
+    auto & b = detail::futex_::bucket_for(&word);
+    { std::lock_guard<std::mutex> lock { b.mutex }; }
+    b.cv.notify_all();
+#endif
+}
+
+/** Wake every thread blocked on `word`. */
+inline void futex_wake_all(std::atomic<u32> const & word) noexcept {
+#if defined(NONSTD_FUTEX_LINUX)
+    syscall(SYS_futex, reinterpret_cast<u32 const *>(&word),
+            FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#elif defined(NONSTD_FUTEX_WIN32)
+    WakeByAddressAll(const_cast<std::atomic<u32> *>(&word));
+#else
+    auto & b = detail::futex_::bucket_for(&word);
+    { std::lock_guard<std::mutex> lock { b.mutex }; }
+    b.cv.notify_all();
+#endif
+}
+
+} /* namespace nonstd */
@@ -12,12 +12,19 @@
  *  MSVC is organized.
  *
  *  All the code in this file is a workaround for the above.
+ *
+ *  Promises also carry a `cancellation_source`. Futures taken from them with
+ *  `get_future` can request cancellation explicitly, and do so implicitly when
+ *  they're destroyed before the value is ready; the producer can observe that
+ *  through `get_cancellation_token`, and stop working on a result nobody will
+ *  read.
  */
 #pragma once
 
 #include <future>
 
 #include <nonstd/nonstd.h>
+#include <nonstd/cancellation.h>
 #include <nonstd/chrono.h>
 #include <nonstd/optional.h>
 
@@ -34,18 +41,41 @@ using std::future_status;
 // They probably work, but if they don't... blame me.
 template <typename T>
 class future : public std::future<optional<T>> {
+private:
+    cancellation_source m_source { cancellation_source::no_state };
+
 public:
     future() noexcept = default;
     future(future && rhs) noexcept = default;
     future(std::future<optional<T>> && rhs)
         : std::future<optional<T>> ( std::move(rhs) )
     { }
-    future& operator= (future && rhs) noexcept = default;
+    future(std::future<optional<T>> && rhs, cancellation_source source)
+        : std::future<optional<T>> ( std::move(rhs)    )
+        , m_source                 ( std::move(source) )
+    { }
+    /** Assigning over a future abandons its current value, as destroying it
+     *  would.
+     */
+    future& operator= (future && rhs) noexcept {
+        if (this != &rhs) {
+            _abandon();
+            std::future<optional<T>>::operator=(std::move(rhs));
+            m_source = std::move(rhs.m_source);
+        }
+        return *this;
+    }
     future& operator= (std::future<optional<T>> && rhs) {
+        _abandon();
         std::future<optional<T>>::operator=(std::move(rhs));
+        m_source = cancellation_source { cancellation_source::no_state };
+        return *this;
     }
 
-    ~future() = default;
+    /** Abandoning a future that's still waiting on its value requests that the
+     *  producer stop working on it.
+     */
+    ~future() { _abandon(); }
 
     future(future const &) = delete;
     future& operator= (future const &) = delete;
@@ -79,6 +109,29 @@ public:
     const {
         return std::future<optional<T>>::wait_until(abs_time);
     }
+
+    future_status wait_until(nonstd::deadline const & d) const {
+        if (d.is_never()) {
+            wait();
+            return future_status::ready;
+        }
+        return std::future<optional<T>>::wait_until(d.time_point());
+    }
+
+    /** Ask the producer to stop working on this future's value. Returns true
+     *  if this call made the request.
+     */
+    bool request_cancellation() const noexcept {
+        return m_source.request_cancellation();
+    }
+
+private:
+    void _abandon() noexcept {
+        if (m_source.has_state() && valid()
+            && wait_for(chrono::seconds::zero()) != future_status::ready) {
+            m_source.request_cancellation();
+        }
+    }
 };
 
 
@@ -115,6 +168,9 @@ class future<void> : public std::future<void> {
 // They probably work, but if they don't... blame me.
 template <typename T>
 class promise : public std::promise<optional<T>> {
+private:
+    cancellation_source m_source;
+
 public:
     promise() = default;
     promise(promise const &) = delete;
@@ -127,6 +183,19 @@ public:
     { }
     ~promise() = default;
 
+    /** Get the future, linked to this promise's cancellation state. */
+    future<T> get_future() {
+        return future<T> { std::promise<optional<T>>::get_future(), m_source };
+    }
+
+    /** Observe whether the consumer of this promise has given up on it. */
+    cancellation_token get_cancellation_token() const noexcept {
+        return m_source.token();
+    }
+    bool cancellation_requested() const noexcept {
+        return m_source.cancellation_requested();
+    }
+
     void set_value(T const & val) {
         std::promise<optional<T>>::set_value({ val });
     }
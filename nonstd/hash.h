@@ -5,13 +5,18 @@
 
 #pragma once
 
+#include <cstring>
+#include <string_view>
+
 #include <nonstd/nonstd.h>
 
 
 namespace nonstd {
 
 constexpr inline u64 shift64(u64 key) noexcept;
+constexpr inline u64 hash_combine(u64 seed, u64 value) noexcept;
 inline u64  djb2(c_cstr str);
+inline u64  djb2(std::string_view str) noexcept;
 inline void sha1(u8 const * const data, u64 num_bytes, cstr sha_out);
 
 
@@ -31,6 +36,7 @@ template<typename T>
 inline u64 hash(T key);
 
 inline u64 hash(c_cstr key) { return djb2(key);    }
+inline u64 hash(std::string_view key) noexcept { return djb2(key); }
 
 constexpr inline u64 hash(u8  key) noexcept { return shift64(key); }
 constexpr inline u64 hash(u16 key) noexcept { return shift64(key); }
@@ -41,6 +47,21 @@ constexpr inline u64 hash(i16 key) noexcept { return shift64(key); }
 constexpr inline u64 hash(i32 key) noexcept { return shift64(key); }
 constexpr inline u64 hash(i64 key) noexcept { return shift64(key); }
 
+/* Floats hash their bit patterns, with -0 folded into +0 s.t. values that
+ * compare equal hash equal. (NaNs don't compare equal to anything.) */
+inline u64 hash(f32 key) noexcept {
+    if (key == 0.f) { key = 0.f; }
+    u32 bits;
+    std::memcpy(&bits, &key, sizeof(bits));
+    return shift64(bits);
+}
+inline u64 hash(f64 key) noexcept {
+    if (key == 0.) { key = 0.; }
+    u64 bits;
+    std::memcpy(&bits, &key, sizeof(bits));
+    return shift64(bits);
+}
+
 
 /** shift64 Hash
  *  ------------
@@ -59,6 +80,16 @@ constexpr inline u64 shift64(u64 key) noexcept {
 }
 
 
+/** Hash Combination
+ *  ----------------
+ *  Fold `value` into `seed`, for hashing aggregates one member at a time. This
+ *  is boost's `hash_combine`, widened to 64 bits.
+ */
+constexpr inline u64 hash_combine(u64 seed, u64 value) noexcept {
+    return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 12) + (seed >> 4));
+}
+
+
 /** DJB2 Hash
  *  ---------
  *  Simple bytestring to 64bit integer hash function. It's blazing fast and
@@ -72,6 +103,13 @@ inline u64 djb2(c_cstr str) {
   return hash;
 };
 
+inline u64 djb2(std::string_view str) noexcept {
+  u64 hash = 5381;
+  for (char c : str)
+      hash = ((hash << 5) + hash) + c;
+  return hash;
+}
+
 
 /** SHA1
  *  ----
@@ -0,0 +1,271 @@
+/** Incremental Computation
+ *  =======================
+ *  Cells of derived data that are recomputed only when something they read
+ *  has changed.
+ *
+ *      nonstd::input<f32> width  { 640.f };
+ *      nonstd::input<f32> height { 480.f };
+ *      nonstd::derived aspect { [&] { return width.get() / height.get(); } };
+ *      nonstd::derived wide   { [&] { return aspect.get() > 1.5f; } };
+ *
+ *      wide.get();        // computes aspect, then wide
+ *      wide.get();        // cached; nothing is recomputed
+ *      width.set(1280.f);
+ *      wide.get();        // recomputes aspect, then wide
+ *
+ *  `input<T>`s hold values that are set from outside. `derived<T>`s hold a
+ *  function that computes their value from other cells; whatever cells it
+ *  reads through `get()` while running are captured as its dependencies, s.t.
+ *  nothing needs declaring up front, and the dependencies may differ from one
+ *  run to the next.
+ *
+ *  Every change to an input advances a global revision, and stamps the input
+ *  with it. A derived cell remembers the revision it last verified itself at,
+ *  and the revision its value last changed at. Reading one is pull-based; if
+ *  anything has changed since it was verified, it first brings each of its
+ *  dependencies up to date (recursively), and recomputes only if one of them
+ *  has changed since its own value was computed. If a recomputed value
+ *  compares equal to the previous one, the cell's change stamp is left alone,
+ *  and cells downstream of it don't recompute either.
+ *
+ *  Cached values are kept in `optional_storage`. Dependency lists are reused
+ *  between recomputations, so a steady-state graph doesn't allocate.
+ *
+ *  Cells hold raw pointers to the cells they read; cells must outlive the
+ *  cells that depend on them, and can be neither copied nor moved. Graphs are
+ *  not thread-safe; every cell in a graph must be read and written from one
+ *  thread at a time, and handing a graph to another thread needs the usual
+ *  synchronization. Independent graphs may be used on different threads at
+ *  once; they share only the revision counter, which is atomic. A change in
+ *  one graph can make cells in another re-verify their dependencies, but
+ *  never recompute. A derived cell that (transitively) reads itself breaks.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/optional_storage.h>
+#include <nonstd/scope_guard.h>
+
+
+namespace nonstd {
+
+namespace detail::incremental_ {
+
+template <typename T, typename = void>
+struct is_equality_comparable : std::false_type { };
+template <typename T>
+struct is_equality_comparable<T, std::void_t<
+    decltype(std::declval<T const &>() == std::declval<T const &>())>>
+    : std::true_type { };
+
+/** A cell, as seen by the cells that depend on it. */
+class node {
+public:
+    node() = default;
+    node(node const &) = delete;
+    node(node &&) = delete;
+    node& operator= (node const &) = delete;
+    node& operator= (node &&) = delete;
+    virtual ~node() = default;
+
+    /** Bring this cell up to date, and return the revision at which its value
+     *  last changed.
+     */
+    virtual u64 refresh() = 0;
+
+protected:
+    /** The most recent revision; advanced by every change to an input, in
+     *  any graph.
+     */
+    static u64 current_revision() noexcept {
+        return revision_counter().load(std::memory_order_relaxed);
+    }
+    /** Advance the revision, and return the new one. */
+    static u64 next_revision() noexcept {
+        return revision_counter().fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    /** The dependency list of the derived cell currently computing, if any. */
+    static std::vector<node *> *& tracking() noexcept {
+        static thread_local std::vector<node *> * dependencies = nullptr;
+        return dependencies;
+    }
+
+    /** Note that this cell was read by whatever is currently computing. */
+    void record_read() {
+        auto * dependencies = tracking();
+        if (dependencies == nullptr) { return; }
+        if (!dependencies->empty() && dependencies->back() == this) { return; }
+        dependencies->push_back(this);
+    }
+
+private:
+    static std::atomic<u64> & revision_counter() noexcept {
+        static std::atomic<u64> revision { 1 };
+        return revision;
+    }
+};
+
+} /* namespace detail::incremental_ */
+
+
+/** Input Cells
+ *  -----------
+ */
+template <typename T>
+class input : public detail::incremental_::node {
+private:
+    T   m_value;
+    u64 m_changed_at;
+
+public:
+    template < typename ... Args
+             , typename = std::enable_if_t<
+                   std::is_constructible_v<T, Args&&...> > >
+    explicit input(Args&&... args)
+        : m_value      ( std::forward<Args>(args)... )
+        , m_changed_at ( current_revision() )
+    { }
+
+    T const & get() {
+        record_read();
+        return m_value;
+    }
+
+    /** Replace the value. If `T` is equality-comparable and the new value
+     *  equals the old, nothing is invalidated.
+     */
+    template <typename U>
+    void set(U && value) {
+        if constexpr (detail::incremental_::is_equality_comparable<T>::value) {
+            if (m_value == value) { return; }
+        }
+        m_value = std::forward<U>(value);
+        mark_changed();
+    }
+
+    /** Modify the value in place with `fn(T&)`. Always invalidates. */
+    template <typename Fn>
+    void modify(Fn && fn) {
+        std::forward<Fn>(fn)(m_value);
+        mark_changed();
+    }
+
+    /** The revision at which this value last changed. */
+    u64 version() const noexcept { return m_changed_at; }
+
+    u64 refresh() override { return m_changed_at; }
+
+private:
+    void mark_changed() noexcept {
+        m_changed_at = next_revision();
+    }
+};
+
+
+/** Derived Cells
+ *  -------------
+ */
+template <typename T>
+class derived : public detail::incremental_::node {
+private:
+    std::function<T()>  m_compute;
+    optional_storage<T> m_value;
+    std::vector<node *> m_dependencies;
+    u64                 m_changed_at;
+    u64                 m_verified_at;
+    u64                 m_computations;
+    bool                m_computing;
+
+public:
+    template < typename Fn
+             , typename = std::enable_if_t<
+                   std::is_convertible_v<std::invoke_result_t<Fn&>, T> > >
+    explicit derived(Fn && compute)
+        : m_compute      ( std::forward<Fn>(compute) )
+        , m_value        ( )
+        , m_dependencies ( )
+        , m_changed_at   ( 0 )
+        , m_verified_at  ( 0 )
+        , m_computations ( 0 )
+        , m_computing    ( false )
+    { }
+
+    /** The up-to-date value, recomputing it first if needed. */
+    T const & get() {
+        refresh();
+        record_read();
+        return m_value.get_value();
+    }
+
+    /** Whether a value has been computed, regardless of whether it's stale. */
+    bool has_value() const noexcept { return m_value.has_value(); }
+
+    /** The revision at which this value last changed (as of the last read). */
+    u64 version() const noexcept { return m_changed_at; }
+
+    /** How many times this cell's function has run. */
+    u64 computations() const noexcept { return m_computations; }
+
+    u64 refresh() override {
+        BREAK_IF(m_computing, nonstd::error::pebcak,
+                 "Incremental cell depends on itself");
+        u64 const revision = current_revision();
+        if (m_value.has_value() && m_verified_at == revision) {
+            return m_changed_at;
+        }
+        if (!m_value.has_value() || dependencies_changed()) {
+            recompute(revision);
+        }
+        m_verified_at = revision;
+        return m_changed_at;
+    }
+
+private:
+    bool dependencies_changed() {
+        m_computing = true;
+        auto done = make_guard([this] { m_computing = false; });
+        for (node * dependency : m_dependencies) {
+            if (dependency->refresh() > m_verified_at) { return true; }
+        }
+        return false;
+    }
+
+    void recompute(u64 revision) {
+        m_dependencies.clear();
+        auto * const outer = tracking();
+        tracking() = &m_dependencies;
+        m_computing = true;
+        auto done = make_guard([this, outer] {
+            tracking() = outer;
+            m_computing = false;
+        });
+        // If the computation throws, the dependencies it captured are
+        // incomplete; drop the cached value s.t. the next read starts over.
+        auto failed = make_guard([this] {
+            if (m_value.has_value()) { m_value.remove_value(); }
+        });
+        T next = m_compute();
+        failed.dismiss();
+        m_computations += 1;
+
+        if constexpr (detail::incremental_::is_equality_comparable<T>::value) {
+            if (m_value.has_value() && m_value.get_value() == next) { return; }
+        }
+        if (m_value.has_value()) { m_value.remove_value(); }
+        m_value.construct_value(std::move(next));
+        m_changed_at = revision;
+    }
+};
+
+template <typename Fn>
+derived(Fn) -> derived<std::decay_t<std::invoke_result_t<Fn&>>>;
+
+} /* namespace nonstd */
@@ -0,0 +1,153 @@
+/** Incremental Computation Tests
+ *  =============================
+ *  GOAL: Validate that derived cells compute lazily, capture their
+ *  dependencies automatically, and recompute only when -- and only as far as
+ *  -- one of their inputs has actually changed.
+ */
+
+#include <nonstd/incremental.h>
+#include <platform/testrunner/testrunner.h>
+
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+
+
+namespace nonstd_test::incremental {
+
+using nonstd::derived;
+using nonstd::input;
+
+
+TEST_CASE("Incremental Computation", "[nonstd][incremental]") {
+    SECTION("compute on first read, then cache") {
+        input<i32> a { 2 };
+        input<i32> b { 3 };
+        derived<i32> sum { [&] { return a.get() + b.get(); } };
+        REQUIRE_FALSE(sum.has_value());
+        REQUIRE(sum.get() == 5);
+        REQUIRE(sum.get() == 5);
+        REQUIRE(sum.computations() == 1);
+    }
+
+    SECTION("recompute only what depends on a changed input") {
+        input<i32> a { 1 };
+        input<i32> b { 10 };
+        derived left  { [&] { return a.get() * 2; } };
+        derived right { [&] { return b.get() * 2; } };
+        derived total { [&] { return left.get() + right.get(); } };
+
+        REQUIRE(total.get() == 22);
+        a.set(2);
+        REQUIRE(total.get() == 24);
+        REQUIRE(left.computations() == 2);
+        REQUIRE(right.computations() == 1);
+        REQUIRE(total.computations() == 2);
+    }
+
+    SECTION("ignore sets that don't change the value") {
+        input<i32> a { 1 };
+        derived<i32> twice { [&] { return a.get() * 2; } };
+        twice.get();
+        auto const version = a.version();
+        a.set(1);
+        REQUIRE(a.version() == version);
+        twice.get();
+        REQUIRE(twice.computations() == 1);
+    }
+
+    SECTION("stop propagating when a recomputed value is unchanged") {
+        input<i32> a { 3 };
+        derived parity { [&] { return a.get() % 2; } };
+        derived label  { [&] {
+            return std::string { parity.get() ? "odd" : "even" };
+        } };
+
+        REQUIRE(label.get() == "odd");
+        a.set(5);
+        REQUIRE(label.get() == "odd");
+        REQUIRE(parity.computations() == 2);
+        REQUIRE(label.computations() == 1);
+
+        a.set(6);
+        REQUIRE(label.get() == "even");
+        REQUIRE(label.computations() == 2);
+    }
+
+    SECTION("track dependencies that differ between runs") {
+        input<bool> use_a { true };
+        input<i32>  a { 1 };
+        input<i32>  b { 2 };
+        derived<i32> chosen { [&] { return use_a.get() ? a.get() : b.get(); } };
+
+        REQUIRE(chosen.get() == 1);
+        b.set(20);   // Not a dependency yet.
+        chosen.get();
+        REQUIRE(chosen.computations() == 1);
+
+        use_a.set(false);
+        REQUIRE(chosen.get() == 20);
+        a.set(10);   // No longer a dependency.
+        chosen.get();
+        REQUIRE(chosen.computations() == 2);
+    }
+
+    SECTION("modify inputs in place") {
+        input<std::vector<i32>> values { std::vector<i32> { 1, 2, 3 } };
+        derived<size_t> count { [&] { return values.get().size(); } };
+        REQUIRE(count.get() == 3);
+        values.modify([](auto & v) { v.push_back(4); });
+        REQUIRE(count.get() == 4);
+    }
+
+    SECTION("recover from a throwing computation") {
+        input<i32> divisor { 0 };
+        derived<i32> quotient { [&] {
+            if (divisor.get() == 0) { throw std::domain_error("zero"); }
+            return 12 / divisor.get();
+        } };
+        REQUIRE_THROWS_AS(quotient.get(), std::domain_error);
+        divisor.set(4);
+        REQUIRE(quotient.get() == 3);
+    }
+
+    SECTION("reject cycles") {
+        derived<i32> * other = nullptr;
+        derived<i32> self_reading { [&] { return other->get() + 1; } };
+        other = &self_reading;
+        REQUIRE_THROWS_AS(self_reading.get(), std::system_error);
+    }
+
+    SECTION("run independent graphs on different threads") {
+        auto run_graph = [](u64 & computations) {
+            input<i32> a { 0 };
+            derived doubled { [&] { return a.get() * 2; } };
+            derived sign    { [&] { return doubled.get() >= 0; } };
+            derived steady  { [&] { return sign.get() ? 1 : -1; } };
+            bool correct = true;
+            for (i32 i = 1; i <= 10'000; ++i) {
+                a.set(i);
+                correct &= doubled.get() == 2 * i && steady.get() == 1;
+            }
+            computations = steady.computations();
+            return correct;
+        };
+
+        u64 computations[2] = { };
+        bool correct[2] = { };
+        std::thread other { [&] { correct[1] = run_graph(computations[1]); } };
+        correct[0] = run_graph(computations[0]);
+        other.join();
+        REQUIRE(correct[0]);
+        REQUIRE(correct[1]);
+        // The other graph's changes never make `steady` recompute.
+        REQUIRE(computations[0] == 1);
+        REQUIRE(computations[1] == 1);
+    }
+}
+
+} /* namespace nonstd_test::incremental */
@@ -0,0 +1,483 @@
+/** Fiber Job System
+ *  ================
+ *  A pool of worker threads that execute small, plain-function jobs, in the
+ *  style of Naughty Dog's engine (Christian Gyrling, "Parallelizing the Naughty
+ *  Dog Engine Using Fibers", GDC 2015).
+ *
+ *  Every job runs on a pooled `fiber`, not directly on a worker's stack. When a
+ *  job needs to wait for other jobs to finish it calls `wait_for_counter`, which
+ *  parks the job's fiber and lets the worker pick up a fresh fiber and keep on
+ *  executing jobs. Once the counter reaches its target, whichever worker
+ *  notices first switches back into the parked fiber, and the job continues --
+ *  possibly on a different thread than the one it started on. Worker threads
+ *  never block inside jobs.
+ *
+ *  Usage;
+ *
+ *      nonstd::job_system jobs { };
+ *      nonstd::job_counter counter;
+ *      nonstd::job_decl decls[] = { { &animate, &skeletons[0] }
+ *                                 , { &animate, &skeletons[1] } };
+ *      jobs.run_jobs(decls, 2, &counter);
+ *      jobs.wait_for_counter(counter);
+ *
+ *  A few rules;
+ *   - `job_decl`s are a function pointer and a `void*`. The system doesn't own
+ *     (or copy) whatever the `void*` points at.
+ *   - A `job_counter` must outlive the jobs that were run against it.
+ *   - Jobs must not cache the address of `thread_local` data across a call to
+ *     `wait_for_counter`; they may wake up on another thread.
+ *   - The fiber pool must be larger than the number of jobs that will be
+ *     waiting at any one time, plus one for each worker.
+ *   - Wait on every counter before destroying the system. Queued jobs that
+ *     haven't started will still be run before the workers exit, but jobs
+ *     that are parked when the workers exit are never resumed.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/cancellation.h>
+#include <nonstd/chrono.h>
+#include <nonstd/fiber.h>
+#include <nonstd/mpmc_queue.h>
+#include <nonstd/wallclock.h>
+
+
+namespace nonstd {
+
+class job_system;
+
+
+/** Job Declaration
+ *  ---------------
+ */
+struct job_decl {
+    void (*entry)(void * data);
+    void * data;
+
+    /** Build a `job_decl` that calls `fn()`. `fn` is referenced, not copied,
+     *  so it must outlive the job.
+     */
+    template <typename Fn>
+    static job_decl from(Fn & fn) noexcept {
+        return job_decl {
+            [](void * data) { (*static_cast<Fn *>(data))(); },
+            static_cast<void *>(&fn)
+        };
+    }
+};
+
+
+/** Job Counter
+ *  -----------
+ *  Incremented once for every job run against it, and decremented as each of
+ *  those jobs completes.
+ */
+class job_counter {
+private:
+    std::atomic<i64> m_value;
+    friend class job_system;
+
+public:
+    job_counter() noexcept : m_value ( 0 ) { }
+
+    job_counter(job_counter const &) = delete;
+    job_counter& operator= (job_counter const &) = delete;
+
+    i64 value() const noexcept {
+        return m_value.load(std::memory_order_acquire);
+    }
+};
+
+
+/** Job System Statistics
+ *  ---------------------
+ *  Per-job timings are taken with `wallclock::now()` around each job's entry
+ *  function, so a job's time includes any time it spent parked.
+ */
+struct job_system_stats {
+    u64                  jobs_run    = 0;
+    chrono::nanoseconds  busy_time   = chrono::nanoseconds::zero();
+    chrono::nanoseconds  longest_job = chrono::nanoseconds::zero();
+};
+
+
+/** Job System Configuration
+ *  ------------------------
+ */
+struct job_system_config {
+    u32    worker_count     = 0;   // 0 => hardware_concurrency - 1 (min 1)
+    u32    fiber_count      = 128;
+    size_t fiber_stack_size = fiber::default_stack_size;
+    u64    queue_capacity   = 4096;
+    // Idle workers spin, then yield, then sleep for this long between polls.
+    // Dispatch latency after a long idle period is bounded by it.
+    chrono::microseconds idle_sleep = chrono::microseconds { 50 };
+};
+
+
+namespace detail::job_system_ {
+
+/** Spin Mutex
+ *  ----------
+ *  Only ever held for a handful of instructions, and never across a fiber
+ *  switch. Satisfies BasicLockable.
+ */
+class spin_mutex {
+    std::atomic_flag m_flag = ATOMIC_FLAG_INIT;
+public:
+    void lock() noexcept {
+        while (m_flag.test_and_set(std::memory_order_acquire)) {
+            cpu_relax();
+        }
+    }
+    bool try_lock() noexcept {
+        return !m_flag.test_and_set(std::memory_order_acquire);
+    }
+    void unlock() noexcept {
+        m_flag.clear(std::memory_order_release);
+    }
+};
+
+struct queued_job {
+    job_decl                   decl;
+    job_counter *              counter;
+    cancellation_token const * token;
+};
+
+struct waiting_fiber {
+    fiber *             parked;
+    job_counter const * counter;
+    i64                 target;
+};
+
+struct ALIGNAS(cache_line_size) worker {
+    fiber *          native = nullptr;
+    std::atomic<u64> jobs_run { 0 };
+    std::atomic<i64> busy_ns { 0 };
+    std::atomic<i64> longest_ns { 0 };
+};
+
+/** Per-Thread State
+ *  ----------------
+ *  `to_release` and `pending_wait` are set by a fiber immediately before it
+ *  switches away, and handled by whichever fiber runs next on that thread --
+ *  only once the first fiber's registers have been saved is it safe to let
+ *  another thread resume it.
+ */
+struct thread_state {
+    job_system *       system       = nullptr;
+    worker *           self         = nullptr;
+    fiber *            current      = nullptr;
+    fiber *            to_release   = nullptr;
+    waiting_fiber      pending_wait = { nullptr, nullptr, 0 };
+};
+
+/** Fetch the calling thread's state. This is out-of-line and opaque to the
+ *  optimizer on purpose; a fiber may resume on a different thread, so the
+ *  address of a `thread_local` must be re-derived after every switch.
+ */
+NOINLINE inline thread_state & this_thread_state() noexcept {
+    static thread_local thread_state state;
+#if !defined(NONSTD_COMPILER_MSVC)
+    __asm__ __volatile__ ("" : : : "memory");
+#endif
+    return state;
+}
+
+} /* namespace detail::job_system_ */
+
+
+/** Job System
+ *  ==========
+ */
+class job_system {
+public:
+    using config = job_system_config;
+
+private:
+    using queued_job    = detail::job_system_::queued_job;
+    using waiting_fiber = detail::job_system_::waiting_fiber;
+    using worker        = detail::job_system_::worker;
+    using spin_mutex    = detail::job_system_::spin_mutex;
+
+    config                               m_config;
+    std::atomic<bool>                    m_stopping;
+    mpmc_queue<queued_job>               m_queue;
+    std::vector<std::unique_ptr<fiber>>  m_fibers;
+    mpmc_queue<fiber *>                  m_free_fibers;
+    spin_mutex                           m_waiting_lock;
+    std::vector<waiting_fiber>           m_waiting;
+    std::atomic<u32>                     m_waiting_count;
+    std::unique_ptr<worker[]>            m_workers;
+    std::vector<std::thread>             m_threads;
+
+    static u32 default_worker_count() noexcept {
+        u32 const hw = std::thread::hardware_concurrency();
+        return hw > 1 ? hw - 1 : 1;
+    }
+
+public:
+    explicit job_system(config cfg = config { })
+        : m_config        ( cfg )
+        , m_stopping      ( false )
+        , m_queue         ( cfg.queue_capacity )
+        , m_fibers        ( )
+        , m_free_fibers   ( n2max(cfg.fiber_count, u32{2}) )
+        , m_waiting_lock  ( )
+        , m_waiting       ( )
+        , m_waiting_count ( 0 )
+        , m_workers       ( nullptr )
+        , m_threads       ( )
+    {
+        if (m_config.worker_count == 0) {
+            m_config.worker_count = default_worker_count();
+        }
+        BREAK_IF(m_config.fiber_count <= m_config.worker_count,
+                 nonstd::error::pebcak,
+                 "A job_system needs more fibers ({}) than workers ({})",
+                 m_config.fiber_count, m_config.worker_count);
+
+        m_fibers.reserve(m_config.fiber_count);
+        m_waiting.reserve(m_config.fiber_count);
+        for (u32 i = 0; i < m_config.fiber_count; ++i) {
+            m_fibers.push_back(std::make_unique<fiber>(
+                &job_system::fiber_main, this, m_config.fiber_stack_size));
+            m_free_fibers.try_push(m_fibers.back().get());
+        }
+
+        m_workers = std::make_unique<worker[]>(m_config.worker_count);
+        m_threads.reserve(m_config.worker_count);
+        for (u32 i = 0; i < m_config.worker_count; ++i) {
+            m_threads.emplace_back([this, i] { worker_main(i); });
+        }
+    }
+
+    job_system(job_system const &) = delete;
+    job_system(job_system &&) = delete;
+    job_system& operator= (job_system const &) = delete;
+    job_system& operator= (job_system &&) = delete;
+
+    ~job_system() {
+        m_stopping.store(true, std::memory_order_release);
+        for (auto & thread : m_threads) { thread.join(); }
+        ASSERT_M(m_waiting.empty(),
+                 "job_system destroyed with {} parked job(s)", m_waiting.size());
+    }
+
+    u32 worker_count() const noexcept { return m_config.worker_count; }
+
+    /** Is the calling code running inside a job (of any `job_system`)? */
+    static bool in_job() noexcept {
+        return detail::job_system_::this_thread_state().system != nullptr;
+    }
+
+    /** Queue `count` jobs, incrementing `counter` (if given) by `count`. If the
+     *  queue is full, the calling thread runs queued jobs until there's room.
+     *
+     *  If a `token` is given, jobs that haven't started by the time it's
+     *  cancelled are skipped -- though they still decrement `counter`. Like the
+     *  counter, the token must outlive the jobs.
+     */
+    void run_jobs(job_decl const * decls, u64 count, job_counter * counter,
+                  cancellation_token const * token = nullptr) {
+        if (counter) {
+            counter->m_value.fetch_add(static_cast<i64>(count),
+                                       std::memory_order_relaxed);
+        }
+        for (u64 i = 0; i < count; ++i) {
+            queued_job const job { decls[i], counter, token };
+            while (!m_queue.try_push(job)) {
+                if (auto queued = m_queue.try_pop()) { execute(*queued); }
+            }
+        }
+    }
+
+    void run_job(job_decl const & decl, job_counter * counter,
+                 cancellation_token const * token = nullptr) {
+        run_jobs(&decl, 1, counter, token);
+    }
+
+    /** Wait until `counter` drops to `target` or below. Inside a job this parks
+     *  the job's fiber and keeps the worker busy with other jobs. Outside of a
+     *  job, the calling thread spins (and eventually yields) until it's done.
+     */
+    void wait_for_counter(job_counter const & counter, i64 target = 0) {
+        if (counter.value() <= target) { return; }
+
+        auto & state = detail::job_system_::this_thread_state();
+        if (state.system != this) {
+            for (u32 spins = 0; counter.value() > target; ++spins) {
+                if (spins < 64) { cpu_relax(); }
+                else            { std::this_thread::yield(); }
+            }
+            return;
+        }
+
+        fiber * self = state.current;
+        fiber * next = acquire_fiber();
+        state.pending_wait = waiting_fiber { self, &counter, target };
+        state.current      = next;
+        switch_fiber(*self, *next);
+        after_switch();
+    }
+
+    /** Aggregate timing statistics across all workers. */
+    job_system_stats stats() const noexcept {
+        job_system_stats ret { };
+        for (u32 i = 0; i < m_config.worker_count; ++i) {
+            auto const & w = m_workers[i];
+            ret.jobs_run += w.jobs_run.load(std::memory_order_relaxed);
+            ret.busy_time += chrono::nanoseconds {
+                w.busy_ns.load(std::memory_order_relaxed) };
+            ret.longest_job = std::max(ret.longest_job, chrono::nanoseconds {
+                w.longest_ns.load(std::memory_order_relaxed) });
+        }
+        return ret;
+    }
+
+private:
+    static void fiber_main(void * arg) {
+        static_cast<job_system *>(arg)->scheduler_loop();
+    }
+
+    void worker_main(u32 index) {
+        fiber native { fiber::this_thread };
+        m_workers[index].native = &native;
+
+        auto & state = detail::job_system_::this_thread_state();
+        state.system  = this;
+        state.self    = &m_workers[index];
+        state.current = acquire_fiber();
+        switch_fiber(native, *state.current);
+
+        // Switched back to by a scheduler loop that saw `m_stopping`.
+        after_switch();
+        detail::job_system_::this_thread_state() = { };
+    }
+
+    void scheduler_loop() {
+        after_switch();
+        u32 idle_rounds = 0;
+        while (true) {
+            if (resume_ready_waiter()) {
+                idle_rounds = 0;
+                continue;
+            }
+            if (auto job = m_queue.try_pop()) {
+                execute(*job);
+                idle_rounds = 0;
+                continue;
+            }
+            if (m_stopping.load(std::memory_order_acquire)) { break; }
+
+            if      (idle_rounds < 64)  { cpu_relax(); }
+            else if (idle_rounds < 256) { std::this_thread::yield(); }
+            else    { std::this_thread::sleep_for(m_config.idle_sleep); }
+            idle_rounds += 1;
+        }
+
+        auto & state = detail::job_system_::this_thread_state();
+        fiber * self = state.current;
+        state.to_release = self;
+        state.current    = nullptr;
+        switch_fiber(*self, *state.self->native);
+    }
+
+    void execute(queued_job const & job) {
+        if (job.token && job.token->cancellation_requested()) {
+            if (job.counter) {
+                job.counter->m_value.fetch_sub(1, std::memory_order_acq_rel);
+            }
+            return;
+        }
+
+        auto const start = wallclock::now();
+        job.decl.entry(job.decl.data);
+        i64 const elapsed = (wallclock::now() - start).count();
+
+        // Re-fetch; the job may have parked and woken up on another thread.
+        auto & state = detail::job_system_::this_thread_state();
+        if (worker * self = state.self) {
+            self->jobs_run.store(
+                self->jobs_run.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+            self->busy_ns.store(
+                self->busy_ns.load(std::memory_order_relaxed) + elapsed,
+                std::memory_order_relaxed);
+            if (elapsed > self->longest_ns.load(std::memory_order_relaxed)) {
+                self->longest_ns.store(elapsed, std::memory_order_relaxed);
+            }
+        }
+
+        if (job.counter) {
+            job.counter->m_value.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+
+    fiber * acquire_fiber() noexcept {
+        while (true) {
+            if (auto f = m_free_fibers.try_pop()) { return *f; }
+            cpu_relax();
+        }
+    }
+
+    /** Complete the bookkeeping requested by the fiber we just switched from. */
+    void after_switch() {
+        auto & state = detail::job_system_::this_thread_state();
+        if (state.to_release) {
+            m_free_fibers.try_push(state.to_release);
+            state.to_release = nullptr;
+        }
+        if (state.pending_wait.parked) {
+            std::lock_guard<spin_mutex> lock { m_waiting_lock };
+            m_waiting.push_back(state.pending_wait);
+            m_waiting_count.store(static_cast<u32>(m_waiting.size()),
+                                  std::memory_order_release);
+            state.pending_wait = waiting_fiber { nullptr, nullptr, 0 };
+        }
+    }
+
+    /** If a parked fiber's counter has reached its target, switch to it and
+     *  release the calling fiber back into the pool.
+     */
+    bool resume_ready_waiter() {
+        if (m_waiting_count.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+        fiber * ready = nullptr;
+        {
+            std::unique_lock<spin_mutex> lock { m_waiting_lock,
+                                                std::try_to_lock };
+            if (!lock.owns_lock()) { return false; }
+            auto it = std::find_if(m_waiting.begin(), m_waiting.end(),
+                [](waiting_fiber const & w) {
+                    return w.counter->value() <= w.target;
+                });
+            if (it == m_waiting.end()) { return false; }
+            ready = it->parked;
+            *it = m_waiting.back();
+            m_waiting.pop_back();
+            m_waiting_count.store(static_cast<u32>(m_waiting.size()),
+                                  std::memory_order_release);
+        }
+
+        auto & state = detail::job_system_::this_thread_state();
+        fiber * self = state.current;
+        state.to_release = self;
+        state.current    = ready;
+        switch_fiber(*self, *ready);
+        after_switch();
+        return true;
+    }
+};
+
+} /* namespace nonstd */
@@ -0,0 +1,102 @@
+/** Fiber Job System Tests
+ *  ======================
+ *  GOAL: Validate that jobs run, that counters track them, and that jobs can
+ *  wait on other jobs without blocking worker threads.
+ *
+ *  The nesting test is the important one; it runs a chain of jobs -- each of
+ *  which waits on its child -- that's much deeper than the number of workers.
+ *  If waiting blocked the worker thread, it would deadlock.
+ */
+
+#include <nonstd/job_system.h>
+#include <platform/testrunner/testrunner.h>
+
+#include <atomic>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+
+
+namespace nonstd_test::job_system {
+
+using nonstd::job_counter;
+using nonstd::job_decl;
+using nonstd::job_system;
+
+
+void increment(void * data) {
+    static_cast<std::atomic<i32> *>(data)->fetch_add(1);
+}
+
+struct nested_job {
+    job_system *      jobs;
+    i32               depth;
+    std::atomic<i32> * visited;
+};
+
+void run_nested(void * data) {
+    auto & self = *static_cast<nested_job *>(data);
+    self.visited->fetch_add(1);
+    if (self.depth == 0) { return; }
+
+    nested_job child { self.jobs, self.depth - 1, self.visited };
+    job_counter counter;
+    self.jobs->run_job(job_decl { &run_nested, &child }, &counter);
+    self.jobs->wait_for_counter(counter);
+}
+
+
+TEST_CASE("Fiber Job System", "[nonstd][job_system]") {
+    job_system::config cfg;
+    cfg.worker_count = 2;
+    cfg.fiber_count  = 64;
+    job_system jobs { cfg };
+
+    SECTION("runs every job it's given") {
+        std::atomic<i32> hits { 0 };
+        std::vector<job_decl> decls (1000, job_decl { &increment, &hits });
+        job_counter counter;
+
+        jobs.run_jobs(decls.data(), decls.size(), &counter);
+        jobs.wait_for_counter(counter);
+
+        REQUIRE(counter.value() == 0);
+        REQUIRE(hits.load() == 1000);
+    }
+
+    SECTION("can run jobs built from callables") {
+        i32 value = 0;
+        auto fn = [&value] { value = 42; };
+        job_counter counter;
+
+        jobs.run_job(job_decl::from(fn), &counter);
+        jobs.wait_for_counter(counter);
+
+        REQUIRE(value == 42);
+    }
+
+    SECTION("lets jobs wait on jobs without blocking workers") {
+        std::atomic<i32> visited { 0 };
+        nested_job root { &jobs, 32, &visited };
+        job_counter counter;
+
+        jobs.run_job(job_decl { &run_nested, &root }, &counter);
+        jobs.wait_for_counter(counter);
+
+        REQUIRE(visited.load() == 33);
+    }
+
+    SECTION("records per-job timings") {
+        std::atomic<i32> hits { 0 };
+        job_counter counter;
+        auto before = jobs.stats().jobs_run;
+
+        jobs.run_job(job_decl { &increment, &hits }, &counter);
+        jobs.wait_for_counter(counter);
+
+        REQUIRE(jobs.stats().jobs_run >= before + 1);
+        REQUIRE(jobs.stats().longest_job >= std::chrono::nanoseconds::zero());
+    }
+}
+
+} /* namespace nonstd_test::job_system */
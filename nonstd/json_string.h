@@ -0,0 +1,50 @@
+/** JSON Strings
+ *  ============
+ *  Quoting for the JSON that's written by hand elsewhere -- trace files from
+ *  profile.h, results from benchmark.h. Only what JSON requires is escaped;
+ *  quotes, backslashes, and control characters. Anything else, including
+ *  UTF-8, is copied through as it is.
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include <nonstd/nonstd.h>
+
+
+namespace nonstd {
+
+/** Append `value` to `out` as a quoted JSON string. */
+inline void append_json_string(std::string & out, std::string_view value) {
+    constexpr char hex[] = "0123456789abcdef";
+    out.push_back('"');
+    for (char c : value) {
+        switch (c) {
+        case '"':  out.append("\\\""); break;
+        case '\\': out.append("\\\\"); break;
+        case '\n': out.append("\\n");  break;
+        case '\t': out.append("\\t");  break;
+        default:
+            if (static_cast<u8>(c) < 0x20) {
+                out.append("\\u00");
+                out.push_back(hex[static_cast<u8>(c) >> 4]);
+                out.push_back(hex[static_cast<u8>(c) & 0xF]);
+            } else {
+                out.push_back(c);
+            }
+        }
+    }
+    out.push_back('"');
+}
+
+/** `value` as a quoted JSON string. */
+inline std::string json_string(std::string_view value) {
+    std::string result;
+    result.reserve(value.size() + 2);
+    append_json_string(result, value);
+    return result;
+}
+
+} /* namespace nonstd */
@@ -0,0 +1,42 @@
+/** JSON String Tests
+ *  =================
+ *  GOAL: Validate that strings are quoted, and that exactly the characters
+ *  JSON requires are escaped.
+ */
+
+#include <nonstd/json_string.h>
+#include <platform/testrunner/testrunner.h>
+
+#include <string>
+
+#include <nonstd/nonstd.h>
+
+
+namespace nonstd_test::json_string {
+
+using nonstd::json_string;
+
+
+TEST_CASE("JSON Strings", "[nonstd][json_string]") {
+    SECTION("quote plain strings as they are") {
+        REQUIRE(json_string("") == R"("")");
+        REQUIRE(json_string("zone/name 42") == R"("zone/name 42")");
+        REQUIRE(json_string("\xc3\xa9t\xc3\xa9") == "\"\xc3\xa9t\xc3\xa9\"");
+    }
+
+    SECTION("escape quotes, backslashes, and control characters") {
+        REQUIRE(json_string("say \"hi\"") == R"("say \"hi\"")");
+        REQUIRE(json_string("C:\\tmp") == R"("C:\\tmp")");
+        REQUIRE(json_string("a\nb\tc") == R"("a\nb\tc")");
+        REQUIRE(json_string(std::string { "\x01\x1f", 2 })
+                == R"("\u0001\u001f")");
+    }
+
+    SECTION("append to what's already written") {
+        std::string out = "{\"name\":";
+        nonstd::append_json_string(out, "x");
+        REQUIRE(out == R"({"name":"x")");
+    }
+}
+
+} /* namespace nonstd_test::json_string */
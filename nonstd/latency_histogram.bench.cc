@@ -0,0 +1,91 @@
+/** Latency Histogram Benchmarks
+ *  ============================
+ *  Recording into a histogram -- from one thread, and from several sharing it
+ *  or each with their own -- against appending to a vector to sort later.
+ *  Each call records the same 64Ki samples, spread from 1ns to ~30s; calls
+ *  with several threads include starting them.
+ */
+
+#include <nonstd/latency_histogram.h>
+#include <nonstd/benchmark.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+
+
+namespace nonstd_bench::latency_histogram {
+
+using nonstd::latency_histogram;
+
+/** The same samples each time; a spread of latencies from 1ns to ~30s. */
+std::vector<i64> make_samples(u32 count) {
+    std::vector<i64> samples;
+    u64 state = 0x9e3779b97f4a7c15;
+    for (u32 i = 0; i < count; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        samples.push_back(i64(1 + (state % 1'000'000) * (state >> 44) / 32));
+    }
+    return samples;
+}
+
+/** Record every sample once, split between `threads` threads. */
+template <typename Record>
+void record_all(std::vector<i64> const & samples, u32 threads,
+                Record && record) {
+    if (threads == 1) {
+        for (i64 sample : samples) { record(0, sample); }
+        return;
+    }
+    std::vector<std::thread> workers;
+    for (u32 t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (u64 i = t; i < samples.size(); i += threads) {
+                record(t, samples[i]);
+            }
+        });
+    }
+    for (auto & worker : workers) { worker.join(); }
+}
+
+
+NONSTD_BENCHMARK("latency_histogram recording") {
+    auto const samples = make_samples(1 << 16);
+
+    latency_histogram shared;
+    bench.run("1 thread", [&] {
+        record_all(samples, 1, [&](u32, i64 sample) {
+            shared.record_ns(sample);
+        });
+    }, samples.size());
+    bench.run("4 threads, shared", [&] {
+        record_all(samples, 4, [&](u32, i64 sample) {
+            shared.record_ns(sample);
+        });
+    }, samples.size());
+    std::vector<latency_histogram> locals (4);
+    bench.run("4 threads, merged", [&] {
+        record_all(samples, 4, [&](u32 t, i64 sample) {
+            locals[t].record_ns(sample);
+        });
+    }, samples.size());
+
+    std::vector<i64> stored;
+    stored.reserve(samples.size());
+    bench.run("vector, then sorted", [&] {
+        stored.clear();
+        record_all(samples, 1, [&](u32, i64 sample) {
+            stored.push_back(sample);
+        });
+        std::sort(stored.begin(), stored.end());
+    }, samples.size());
+    fmt::print("  p99 {}ns vs {}ns exact\n",
+               shared.percentile(99.0).count(),
+               stored[stored.size() * 99 / 100]);
+}
+
+} /* namespace nonstd_bench::latency_histogram */
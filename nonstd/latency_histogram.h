@@ -0,0 +1,436 @@
+/** Latency Histogram
+ *  =================
+ *  A high-dynamic-range (HDR) histogram of durations; it answers "what was the
+ *  p99.9?" without storing every sample, in a fixed amount of memory, to a
+ *  configurable number of significant decimal digits.
+ *
+ *      nonstd::latency_histogram histogram;         // 1ns to 1min, 3 digits
+ *      histogram.record(wallclock::now() - start);
+ *      ...
+ *      auto p99 = histogram.percentile(99.0);
+ *
+ *  Buckets are log-linear, as in Gil Tene's HdrHistogram; each power-of-two
+ *  range of values is split into the same number of linear sub-buckets, enough
+ *  that any two values that differ in their first `significant_digits` decimal
+ *  digits land in different buckets. With the default 3 digits, a reported
+ *  value is within 0.1% of the samples it stands for, whether those were 80ns
+ *  or 80s. Recording is O(1); a leading-zero count, two shifts, and one
+ *  relaxed `fetch_add`, so many threads may record into one histogram without
+ *  locks. Queries read the buckets with relaxed loads, and are only an exact
+ *  snapshot when nothing is recording concurrently.
+ *
+ *  Memory is `8 * 2^ceil(log2(2 * 10^digits)) / 2` bytes for each power of two
+ *  between `lowest` and `highest`; ~220KB for the defaults. Where threads
+ *  record heavily enough to contend on shared buckets, give each thread its
+ *  own histogram and `merge()` them for reporting. Durations below `lowest`
+ *  are recorded in the first bucket; durations above `highest` are recorded
+ *  as `highest`, and counted by `saturated()`.
+ *
+ *  For offline aggregation, `write()` dumps a compact binary form -- counts
+ *  as run-length-encoded varints, usually a few hundred bytes -- and `read()`
+ *  loads it. `write_text()` / `read_text()` do the same with one
+ *  `<value-ns> <count>` line per occupied bucket, for tools that would rather
+ *  not parse binary; text dumps can be read into a histogram of any layout.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/chrono.h>
+#include <nonstd/four_char_code.h>
+#include <nonstd/math.h>
+
+
+namespace nonstd {
+
+class latency_histogram {
+public:
+    /** Track durations from `lowest` to `highest`, to `significant_digits`
+     *  (1 to 5) decimal digits of precision.
+     */
+    explicit latency_histogram(
+        chrono::nanoseconds lowest  = chrono::nanoseconds { 1 },
+        chrono::nanoseconds highest = chrono::minutes { 1 },
+        u32 significant_digits      = 3)
+        : m_lowest  ( lowest.count()  )
+        , m_highest ( highest.count() )
+        , m_digits  ( significant_digits )
+    {
+        BREAK_UNLESS(m_lowest >= 1 && m_highest >= 2 * m_lowest,
+                     nonstd::error::pebcak,
+                     "A latency_histogram needs 1ns <= 2 * lowest <= highest.");
+        BREAK_UNLESS(m_digits >= 1 && m_digits <= 5,
+                     nonstd::error::pebcak,
+                     "A latency_histogram keeps 1 to 5 significant digits.");
+
+        // Enough sub-buckets per power of two to tell apart 2 * 10^digits
+        // values; the factor of two because the lower half of each bucket
+        // overlaps the previous one, and is only used in the first.
+        u64 largest_single_unit = 2;
+        for (u32 i = 0; i < m_digits; ++i) { largest_single_unit *= 10; }
+        u32 const sub_bucket_magnitude = 64 - count_leading_zeros(
+                                                  largest_single_unit - 1);
+        m_half_magnitude  = sub_bucket_magnitude - 1;
+        m_half_count      = u64 { 1 } << m_half_magnitude;
+        m_unit_magnitude  = 63 - count_leading_zeros(u64(m_lowest));
+        m_sub_bucket_mask = ((m_half_count << 1) - 1) << m_unit_magnitude;
+
+        u64 smallest_untrackable = (m_half_count << 1) << m_unit_magnitude;
+        m_bucket_count = 1;
+        while (smallest_untrackable <= u64(m_highest)) {
+            m_bucket_count += 1;
+            if (smallest_untrackable > (u64 { 1 } << 62)) { break; }
+            smallest_untrackable <<= 1;
+        }
+        // One more counter than there are buckets, for `saturated()`.
+        m_counts_len = (m_bucket_count + 1) * m_half_count;
+        m_counts     = std::make_unique<std::atomic<u64>[]>(m_counts_len + 1);
+        reset();
+    }
+
+    latency_histogram(latency_histogram const & other)
+        : latency_histogram ( other.lowest(), other.highest(), other.m_digits )
+    {
+        merge(other);
+    }
+    latency_histogram& operator= (latency_histogram const & other) {
+        if (this != &other) { *this = latency_histogram { other }; }
+        return *this;
+    }
+    latency_histogram(latency_histogram &&) noexcept = default;
+    latency_histogram& operator= (latency_histogram &&) noexcept = default;
+
+
+    /** Recording
+     *  ---------
+     */
+    template <typename Rep, typename Period>
+    void record(chrono::duration<Rep, Period> const & duration,
+                u64 count = 1) noexcept
+    {
+        record_ns(chrono::duration_cast<chrono::nanoseconds>(duration).count(),
+                  count);
+    }
+
+    void record_ns(i64 ns, u64 count = 1) noexcept {
+        if (ns > m_highest) {
+            ns = m_highest;
+            _saturated().fetch_add(count, std::memory_order_relaxed);
+        }
+        ns = n2max(ns, i64 { 0 });
+        m_counts[_index_of(u64(ns))].fetch_add(count,
+                                               std::memory_order_relaxed);
+    }
+
+    /** Add `other`'s counts to this histogram's. Histograms of the same
+     *  layout add bucket-by-bucket; otherwise each of `other`'s buckets is
+     *  re-recorded at its midpoint.
+     */
+    void merge(latency_histogram const & other) noexcept {
+        if (_same_layout(other)) {
+            for (u64 i = 0; i < other.m_counts_len; ++i) {
+                u64 const count = other._count_at(i);
+                if (count) {
+                    m_counts[i].fetch_add(count, std::memory_order_relaxed);
+                }
+            }
+        } else {
+            other.for_each_bucket([&](i64 lowest, i64 highest, u64 count) {
+                record_ns(lowest + (highest - lowest) / 2, count);
+            });
+        }
+        _saturated().fetch_add(other.saturated(), std::memory_order_relaxed);
+    }
+
+    void reset() noexcept {
+        for (u64 i = 0; i <= m_counts_len; ++i) {
+            m_counts[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+
+    /** Queries
+     *  -------
+     *  Percentiles and `max()` report the upper edge of the bucket that holds
+     *  them, and so never understate a latency; `min()` reports the lower.
+     */
+    u64 count() const noexcept {
+        u64 total = 0;
+        for (u64 i = 0; i < m_counts_len; ++i) { total += _count_at(i); }
+        return total;
+    }
+
+    /** The number of samples that were recorded as `highest()` because they
+     *  were longer.
+     */
+    u64 saturated() const noexcept {
+        return _saturated().load(std::memory_order_relaxed);
+    }
+
+    /** The smallest duration that at least `percent`% of samples are at or
+     *  below. Zero if the histogram is empty.
+     */
+    chrono::nanoseconds percentile(f64 percent) const noexcept {
+        u64 const total = count();
+        if (total == 0) { return chrono::nanoseconds { 0 }; }
+        // The nearest-rank definition; the rank is shaved by a hair s.t. ex;
+        // 99.9% of 1000 is 999, despite rounding to 999.0000000000001.
+        percent = n2min(n2max(percent, 0.0), 100.0);
+        f64 const rank   = percent / 100.0 * f64(total);
+        u64 const target = n2max(u64(std::ceil(rank - rank * 1e-12)),
+                                 u64 { 1 });
+
+        u64 seen = 0;
+        for (u64 i = 0; i < m_counts_len; ++i) {
+            seen += _count_at(i);
+            if (seen >= target) {
+                return chrono::nanoseconds {
+                    highest_equivalent(_value_at_index(i))
+                };
+            }
+        }
+        return max();
+    }
+
+    chrono::nanoseconds min() const noexcept {
+        for (u64 i = 0; i < m_counts_len; ++i) {
+            if (_count_at(i)) {
+                return chrono::nanoseconds { _value_at_index(i) };
+            }
+        }
+        return chrono::nanoseconds { 0 };
+    }
+
+    chrono::nanoseconds max() const noexcept {
+        for (u64 i = m_counts_len; i-- > 0; ) {
+            if (_count_at(i)) {
+                return chrono::nanoseconds {
+                    highest_equivalent(_value_at_index(i))
+                };
+            }
+        }
+        return chrono::nanoseconds { 0 };
+    }
+
+    /** The mean, taking each sample to be at the middle of its bucket. */
+    chrono::duration<f64, std::nano> mean() const noexcept {
+        f64 sum   = 0.0;
+        u64 total = 0;
+        for_each_bucket([&](i64 lowest, i64 highest, u64 count) {
+            sum   += (f64(lowest) + f64(highest - lowest) / 2.0) * f64(count);
+            total += count;
+        });
+        return chrono::duration<f64, std::nano> {
+            total ? sum / f64(total) : 0.0
+        };
+    }
+
+    /** Call `fn(lowest_ns, highest_ns, count)` for each occupied bucket, in
+     *  ascending order.
+     */
+    template <typename Fn>
+    void for_each_bucket(Fn && fn) const {
+        for (u64 i = 0; i < m_counts_len; ++i) {
+            if (u64 const count = _count_at(i)) {
+                i64 const lowest = _value_at_index(i);
+                fn(lowest, highest_equivalent(lowest), count);
+            }
+        }
+    }
+
+    /** The smallest and largest values that share `ns`'s bucket. */
+    i64 lowest_equivalent(i64 ns) const noexcept {
+        return _value_at_index(_index_of(u64(n2max(ns, i64 { 0 }))));
+    }
+    i64 highest_equivalent(i64 ns) const noexcept {
+        i64 const lowest = lowest_equivalent(ns);
+        return lowest + _bucket_width(u64(lowest)) - 1;
+    }
+
+    chrono::nanoseconds lowest()  const noexcept {
+        return chrono::nanoseconds { m_lowest };
+    }
+    chrono::nanoseconds highest() const noexcept {
+        return chrono::nanoseconds { m_highest };
+    }
+    u32 significant_digits() const noexcept { return m_digits; }
+    /** The number of buckets, and so of u64 counters, allocated. */
+    u64 bucket_count() const noexcept { return m_counts_len; }
+
+
+    /** Dumping and Loading
+     *  -------------------
+     *  The binary form is; the magic `HDR1` (little-endian), then varints of
+     *  `lowest`, `highest`, `significant_digits`, and `saturated`, then the
+     *  bucket counts in index order as zigzag varints, where a positive value
+     *  is a count and a negative one a run of that many empty buckets, ending
+     *  with a 0.
+     */
+    void write(std::ostream & out) const {
+        u32 const magic = s_magic;
+        for (u32 i = 0; i < 4; ++i) { out.put(char(u8(magic >> (8 * i)))); }
+        _put_varint(out, u64(m_lowest));
+        _put_varint(out, u64(m_highest));
+        _put_varint(out, m_digits);
+        _put_varint(out, saturated());
+
+        u64 zeros = 0;
+        for (u64 i = 0; i < m_counts_len; ++i) {
+            u64 const count = _count_at(i);
+            if (count == 0) { zeros += 1; continue; }
+            if (zeros) { _put_varint(out, (zeros << 1) - 1); zeros = 0; }
+            _put_varint(out, count << 1);
+        }
+        _put_varint(out, 0);
+    }
+
+    static latency_histogram read(std::istream & in) {
+        u32 magic = 0;
+        for (u32 i = 0; i < 4; ++i) {
+            magic |= u32(u8(in.get())) << (8 * i);
+        }
+        BREAK_UNLESS(in && magic == s_magic, nonstd::error::external,
+                     "Not a latency_histogram dump.");
+        i64 const lowest    = i64(_get_varint(in));
+        i64 const highest   = i64(_get_varint(in));
+        u32 const digits    = u32(_get_varint(in));
+        u64 const saturated = _get_varint(in);
+
+        latency_histogram result {
+            chrono::nanoseconds { lowest }, chrono::nanoseconds { highest },
+            digits
+        };
+        result._saturated().store(saturated, std::memory_order_relaxed);
+        u64 index = 0;
+        while (u64 const token = _get_varint(in)) {
+            if (token & 1) { index += (token + 1) >> 1; continue; }
+            BREAK_UNLESS(index < result.m_counts_len, nonstd::error::external,
+                         "A latency_histogram dump has too many buckets.");
+            result.m_counts[index++].store(token >> 1,
+                                           std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    /** A `latency_histogram <lowest> <highest> <digits> <saturated>` header
+     *  line, then a `<lowest-ns> <count>` line per occupied bucket.
+     */
+    void write_text(std::ostream & out) const {
+        out << "latency_histogram " << m_lowest << ' ' << m_highest << ' '
+            << m_digits << ' ' << saturated() << '\n';
+        for_each_bucket([&](i64 lowest, i64, u64 count) {
+            out << lowest << ' ' << count << '\n';
+        });
+    }
+
+    static latency_histogram read_text(std::istream & in) {
+        std::string tag;
+        i64 lowest = 0, highest = 0;
+        u32 digits = 0;
+        u64 saturated = 0;
+        in >> tag >> lowest >> highest >> digits >> saturated;
+        BREAK_UNLESS(in && tag == "latency_histogram", nonstd::error::external,
+                     "Not a latency_histogram text dump.");
+
+        latency_histogram result {
+            chrono::nanoseconds { lowest }, chrono::nanoseconds { highest },
+            digits
+        };
+        result._saturated().store(saturated, std::memory_order_relaxed);
+        i64 value = 0;
+        u64 count = 0;
+        while (in >> value >> count) { result.record_ns(value, count); }
+        BREAK_UNLESS(in.eof(), nonstd::error::external,
+                     "A latency_histogram text dump is malformed.");
+        return result;
+    }
+
+private:
+    static constexpr u32 s_magic = four_char_code("HDR1");
+
+    /** The bucket of `value`; `bucket` picks the power of two, and
+     *  `sub_bucket` the linear step within it.
+     */
+    u64 _index_of(u64 value) const noexcept {
+        u32 const bucket     = _bucket_of(value);
+        u64 const sub_bucket = value >> (bucket + m_unit_magnitude);
+        return (u64(bucket + 1) << m_half_magnitude)
+             + (sub_bucket - m_half_count);
+    }
+
+    u32 _bucket_of(u64 value) const noexcept {
+        u32 const magnitude = 64 - count_leading_zeros(value
+                                                     | m_sub_bucket_mask);
+        return magnitude - m_unit_magnitude - (m_half_magnitude + 1);
+    }
+
+    i64 _value_at_index(u64 index) const noexcept {
+        i64 bucket     = i64(index >> m_half_magnitude) - 1;
+        u64 sub_bucket = (index & (m_half_count - 1)) + m_half_count;
+        if (bucket < 0) {
+            sub_bucket -= m_half_count;
+            bucket      = 0;
+        }
+        return i64(sub_bucket << (u32(bucket) + m_unit_magnitude));
+    }
+
+    /** The number of values sharing the bucket of `value`. */
+    i64 _bucket_width(u64 value) const noexcept {
+        return i64(1) << (m_unit_magnitude + _bucket_of(value));
+    }
+
+    std::atomic<u64>& _saturated() const noexcept {
+        return m_counts[m_counts_len];
+    }
+
+    u64 _count_at(u64 index) const noexcept {
+        return m_counts[index].load(std::memory_order_relaxed);
+    }
+
+    bool _same_layout(latency_histogram const & other) const noexcept {
+        return m_unit_magnitude == other.m_unit_magnitude
+            && m_half_magnitude == other.m_half_magnitude
+            && m_highest        >= other.m_highest;
+    }
+
+    static void _put_varint(std::ostream & out, u64 value) {
+        while (value >= 0x80) {
+            out.put(char(u8(value) | 0x80));
+            value >>= 7;
+        }
+        out.put(char(value));
+    }
+
+    static u64 _get_varint(std::istream & in) {
+        u64 value = 0;
+        for (u32 shift = 0; shift < 64; shift += 7) {
+            auto const byte = in.get();
+            BREAK_UNLESS(in, nonstd::error::external,
+                         "A latency_histogram dump ended early.");
+            value |= u64(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) { return value; }
+        }
+        BREAK(nonstd::error::external,
+              "A latency_histogram dump has an oversized varint.");
+    }
+
+    i64 m_lowest;
+    i64 m_highest;
+    u32 m_digits;
+    u32 m_unit_magnitude;
+    u32 m_half_magnitude;
+    u64 m_half_count;
+    u64 m_sub_bucket_mask;
+    u64 m_bucket_count;
+    u64 m_counts_len;
+    std::unique_ptr<std::atomic<u64>[]> m_counts;
+};
+
+} /* namespace nonstd */
@@ -0,0 +1,184 @@
+/** Latency Histogram Tests
+ *  =======================
+ *  GOAL: Validate that every recorded duration lands in a bucket no wider than
+ *  the requested precision allows, that percentiles agree with those of the
+ *  raw samples to that precision, and that histograms merge across threads
+ *  and survive a round trip through both dump formats unchanged.
+ */
+
+#include <nonstd/latency_histogram.h>
+#include <platform/testrunner/testrunner.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+
+
+namespace nonstd_test::latency_histogram {
+
+using nonstd::latency_histogram;
+using namespace nonstd::literals::chrono_literals;
+
+/** The same samples each time; a spread of latencies from 1ns to ~30s. */
+std::vector<i64> make_samples(u32 count) {
+    std::vector<i64> samples;
+    u64 state = 0x9e3779b97f4a7c15;
+    for (u32 i = 0; i < count; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        samples.push_back(i64(1 + (state % 1'000'000) * (state >> 44) / 32));
+    }
+    return samples;
+}
+
+bool same_buckets(latency_histogram const & a, latency_histogram const & b) {
+    std::vector<std::pair<i64, u64>> a_buckets, b_buckets;
+    a.for_each_bucket([&](i64 v, i64, u64 n) { a_buckets.emplace_back(v, n); });
+    b.for_each_bucket([&](i64 v, i64, u64 n) { b_buckets.emplace_back(v, n); });
+    return a_buckets == b_buckets && a.saturated() == b.saturated();
+}
+
+
+TEST_CASE("Latency Histograms", "[nonstd][time][latency_histogram]") {
+    SECTION("bucket values to the requested precision") {
+        for (u32 digits : { 1u, 2u, 3u, 4u }) {
+            latency_histogram histogram { 1ns, 1h, digits };
+            f64 const precision = std::pow(10.0, -f64(digits));
+            for (i64 value : make_samples(2000)) {
+                i64 const low  = histogram.lowest_equivalent(value);
+                i64 const high = histogram.highest_equivalent(value);
+                REQUIRE(low <= value);
+                REQUIRE(value <= high);
+                REQUIRE(f64(high - low) <= f64(value) * precision);
+            }
+        }
+        latency_histogram histogram;
+        for (i64 value = 0; value < 2048; ++value) {
+            REQUIRE(histogram.lowest_equivalent(value) == value);
+            REQUIRE(histogram.highest_equivalent(value) == value);
+        }
+        REQUIRE(histogram.bucket_count() == 27 * 1024);
+    }
+
+    SECTION("report percentiles of the recorded durations") {
+        latency_histogram histogram;
+        REQUIRE(histogram.percentile(50.0) == 0ns);
+        REQUIRE(histogram.max() == 0ns);
+
+        for (i64 ms = 1; ms <= 1000; ++ms) {
+            histogram.record(std::chrono::milliseconds { ms });
+        }
+        REQUIRE(histogram.count() == 1000);
+        auto near = [](std::chrono::nanoseconds actual,
+                       std::chrono::nanoseconds expected) {
+            return actual >= expected && actual <= expected + expected / 1000;
+        };
+        REQUIRE(near(histogram.percentile(50.0),  500ms));
+        REQUIRE(near(histogram.percentile(99.0),  990ms));
+        REQUIRE(near(histogram.percentile(99.9),  999ms));
+        REQUIRE(near(histogram.percentile(100.0), 1000ms));
+        REQUIRE(near(histogram.percentile(0.0),   1ms));
+        REQUIRE(histogram.min() <= 1ms);
+        REQUIRE(near(histogram.max(), 1000ms));
+        REQUIRE(std::abs(histogram.mean().count() - 500.5e6) < 500.5e3);
+    }
+
+    SECTION("agree with the percentiles of raw samples") {
+        auto samples = make_samples(100'000);
+        latency_histogram histogram { 1ns, 1min, 3 };
+        for (i64 sample : samples) { histogram.record_ns(sample); }
+        std::sort(samples.begin(), samples.end());
+
+        for (f64 percent : { 10.0, 50.0, 90.0, 99.0, 99.9, 99.99 }) {
+            auto const rank = u64(std::ceil(percent * f64(samples.size())
+                                            / 100.0 - 1e-6));
+            i64 const exact = samples[rank - 1];
+            REQUIRE(histogram.percentile(percent).count()
+                    == histogram.highest_equivalent(exact));
+        }
+    }
+
+    SECTION("clamp and count durations out of range") {
+        latency_histogram histogram { 1us, 1s, 2 };
+        histogram.record(-5ns);
+        histogram.record(10ns);
+        histogram.record(5s, 3);
+        REQUIRE(histogram.count() == 5);
+        REQUIRE(histogram.saturated() == 3);
+        REQUIRE(histogram.min() == 0ns);
+        REQUIRE(histogram.max() >= 1s);
+        REQUIRE(histogram.max() <= 1s + 10ms);
+
+        histogram.reset();
+        REQUIRE(histogram.count() == 0);
+        REQUIRE(histogram.saturated() == 0);
+        REQUIRE_THROWS(latency_histogram { 0ns, 1s, 3 });
+        REQUIRE_THROWS(latency_histogram { 1ns, 1s, 6 });
+    }
+
+    SECTION("merge histograms recorded by many threads") {
+        auto const samples = make_samples(40'000);
+        latency_histogram shared;
+        std::vector<latency_histogram> locals (4);
+        std::vector<std::thread> threads;
+        for (u32 t = 0; t < 4; ++t) {
+            threads.emplace_back([&, t] {
+                for (u64 i = t; i < samples.size(); i += 4) {
+                    shared.record_ns(samples[i]);
+                    locals[t].record_ns(samples[i]);
+                }
+            });
+        }
+        for (auto & thread : threads) { thread.join(); }
+
+        latency_histogram merged;
+        for (auto const & local : locals) { merged.merge(local); }
+        REQUIRE(merged.count() == samples.size());
+        REQUIRE(same_buckets(merged, shared));
+
+        // Into a coarser layout, each bucket lands within that one's precision.
+        latency_histogram coarse { 1us, 1h, 2 };
+        coarse.merge(merged);
+        REQUIRE(coarse.count() == samples.size());
+        auto const fine_p99   = f64(merged.percentile(99.0).count());
+        auto const coarse_p99 = f64(coarse.percentile(99.0).count());
+        REQUIRE(std::abs(coarse_p99 - fine_p99) <= fine_p99 / 100 + 1000);
+
+        latency_histogram const copy { merged };
+        REQUIRE(same_buckets(copy, merged));
+    }
+
+    SECTION("round-trip through binary and text dumps") {
+        latency_histogram histogram { 1ns, 1min, 3 };
+        for (i64 sample : make_samples(10'000)) { histogram.record_ns(sample); }
+        histogram.record(2min);
+
+        std::stringstream binary;
+        histogram.write(binary);
+        REQUIRE(binary.str().size() < 20'000);
+        auto const from_binary = latency_histogram::read(binary);
+        REQUIRE(same_buckets(from_binary, histogram));
+        REQUIRE(from_binary.significant_digits() == 3);
+
+        std::stringstream text;
+        histogram.write_text(text);
+        auto const from_text = latency_histogram::read_text(text);
+        REQUIRE(same_buckets(from_text, histogram));
+
+        std::stringstream garbage { "not a histogram" };
+        REQUIRE_THROWS(latency_histogram::read(garbage));
+        std::stringstream truncated { binary.str().substr(0, 20) };
+        REQUIRE_THROWS(latency_histogram::read(truncated));
+        std::stringstream bad_text { "latency_histogram 1 60000000000 3 0\n"
+                                     "100 x\n" };
+        REQUIRE_THROWS(latency_histogram::read_text(bad_text));
+    }
+}
+
+} /* namespace nonstd_test::latency_histogram */
@@ -4,10 +4,12 @@
  */
 #pragma once
 
-#include <functional>
+#include <cstddef>
 #include <tuple>
 #include <type_traits>
+#include <utility>
 
+#include <nonstd/nonstd.h>
 #include <nonstd/optional_storage.h>
 
 
@@ -15,36 +17,49 @@ namespace nonstd {
 
 /** Lazy Object Initializer
  *  -----------------------
- *  Created with the `lazy_init<T>` free function. Stores the arguments passed
- *  to it until dereferenced. Uses a direct placement-new to construct the
- *  given `T` upon first dereference.
+ *  Stores the arguments needed to construct a `T` until first dereferenced,
+ *  then constructs the `T` in place from them. The (decayed) arguments are
+ *  held in a tuple right next to the `T`'s storage, so a `lazy` never touches
+ *  the heap, and is exactly as large as its two members.
+ *
+ *      nonstd::lazy<mixer, u32, char const *> audio { 48000, "default" };
+ *      auto config = nonstd::lazy_init<config_db>(path, flags);
+ *
+ *  The argument types are part of the type; `lazy_init<T>(args...)` deduces
+ *  them. `lazy<T>` (no arguments) default-constructs its `T`.
+ *
+ *  The arguments are moved from to construct the `T`, and are destroyed along
+ *  with the `lazy` -- whether or not it was ever dereferenced. If `T`'s
+ *  constructor throws, the `lazy` remains uninitialized; the next dereference
+ *  will try again with whatever the arguments were left holding.
+ *
+ *  Dereferencing is a single, predictable branch on the storage's flag; the
+ *  construction itself is kept out of line.
  */
-template <typename T>
+template <typename T, typename ... Args>
 class lazy {
+    static_assert(!std::is_reference_v<T>,
+        "lazy objects cannot wrap referential types.");
+    static_assert((std::is_same_v<Args, std::decay_t<Args>> && ...),
+        "lazy objects store their arguments by value; use decayed types.");
+
 private:
     nonstd::optional_storage<T> m_storage;
-    std::function<void()>       m_init;
+    std::tuple<Args...>         m_args;
 
-    template <typename TuplePtr_T, std::size_t ... Is>
-    void initialize(TuplePtr_T arg_tuple_ptr, std::index_sequence<Is...>) {
-        m_storage.construct_value(std::get<Is>(std::move(*arg_tuple_ptr))...);
-        delete arg_tuple_ptr;
+    template <std::size_t ... Is>
+    NOINLINE void initialize(std::index_sequence<Is...>) {
+        m_storage.construct_value(std::get<Is>(std::move(m_args))...);
     }
 
 public:
-    template <typename ... Args>
-    lazy(Args&&... args)
+    template < typename ... Us
+             , typename = std::enable_if_t<
+                   sizeof...(Us) == sizeof...(Args)
+                && std::is_constructible_v<std::tuple<Args...>, Us&&...> > >
+    lazy(Us&&... args)
         : m_storage ( )
-        , m_init (
-            [ this,
-              args_tuple_ptr = new std::tuple<std::decay_t<Args>...> {
-                std::forward<Args>(args)...
-              }
-            ] () {
-                this->initialize(args_tuple_ptr,
-                                 std::index_sequence_for<Args...>{});
-            }
-        )
+        , m_args    ( std::forward<Us>(args)... )
     { }
     lazy(lazy const& other)       = delete;
     lazy(lazy && other)           = delete;
@@ -54,14 +69,24 @@ public:
     inline bool initialized() const { return m_storage.has_value(); }
 
     inline T& operator * () {
-        if (!initialized()) { m_init(); }
+        if (!initialized()) { initialize(std::index_sequence_for<Args...>{}); }
         return m_storage.get_value();
     }
 
-    inline T* operator -> () {
-        if (!initialized()) { m_init(); }
-        return &m_storage.get_value();
-    }
+    inline T* operator -> () { return &**this; }
 };
 
+
+/** Lazy Initializer Factory
+ *  ------------------------
+ *  Deduces the argument types of a `lazy<T, Args...>` from the given arguments.
+ *  `lazy`s can't be moved, but the result can be bound directly;
+ *
+ *      auto log = nonstd::lazy_init<logger>("game.log", KBYTES(4));
+ */
+template <typename T, typename ... Args>
+inline lazy<T, std::decay_t<Args>...> lazy_init(Args&&... args) {
+    return { std::forward<Args>(args)... };
+}
+
 } /* namespace nonstd */
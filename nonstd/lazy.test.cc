@@ -1,11 +1,17 @@
 /** Lazy Initialization Tests
  *  =========================
- *
+ *  GOAL: Validate that lazy wrappers construct their contained only when first
+ *  accessed, with a minimum of copies and moves, and that the stored arguments
+ *  are cleaned up whether or not that ever happens.
  */
 
 #include <nonstd/lazy.h>
 #include <platform/testrunner/testrunner.h>
 
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
 #include <nonstd/nonstd.h>
 #include <platform/memory/memory.h>
 #include <platform/memory/nr_ptr.h>
@@ -16,11 +22,12 @@ namespace nonstd_test::lazy {
 
 using namespace Catch::Matchers;
 using nonstd::lazy;
+using nonstd::lazy_init;
 using nonstd::test::construction_counter;
 using memory::nr_ptr;
 
 constexpr i32 test_value = 42;
-lazy<i32> global_instance { test_value };
+lazy<i32, i32> global_instance { test_value };
 TEST_CASE("Global Lazy Wrappers", "[nonstd][lazy]") {
     SECTION("Should be not initialized until accessed") {
         REQUIRE(global_instance.initialized() == false);
@@ -59,7 +66,9 @@ TEST_CASE("Lazy Wrappers", "[nonstd][lazy]") {
         SECTION("with inline argument construction") {
             // Create a lazy wrapper around a counter, initialize it, and get a
             // reference to the contained
-            lazy<inline_test_t> lazy_container { construction_counter{} };
+            lazy<inline_test_t, construction_counter> lazy_container {
+                construction_counter{}
+            };
             REQUIRE(lazy_container.initialized() == false);
             auto& counter = (*lazy_container).counter;
             REQUIRE(lazy_container.initialized() == true);
@@ -74,7 +83,9 @@ TEST_CASE("Lazy Wrappers", "[nonstd][lazy]") {
             // Create a lazy wrapper around a counter, initialize it, and get a
             // reference to the contained
             construction_counter initial_counter;
-            lazy<inline_test_t> lazy_container { initial_counter };
+            lazy<inline_test_t, construction_counter> lazy_container {
+                initial_counter
+            };
             REQUIRE(lazy_container.initialized() == false);
             auto& counter = (*lazy_container).counter;
             REQUIRE(lazy_container.initialized() == true);
@@ -87,7 +98,7 @@ TEST_CASE("Lazy Wrappers", "[nonstd][lazy]") {
     }
 
     SECTION("should be able to correctly nest") {
-        lazy<lazy<i32>> nested_instance  { test_value };
+        lazy<lazy<i32, i32>, i32> nested_instance { test_value };
 
         REQUIRE(nested_instance.initialized() == false);
         REQUIRE((*nested_instance).initialized() == false);
@@ -95,9 +106,53 @@ TEST_CASE("Lazy Wrappers", "[nonstd][lazy]") {
         REQUIRE(**nested_instance == test_value);
         REQUIRE((*nested_instance).initialized() == true);
     }
+
+    SECTION("should deduce argument types through lazy_init") {
+        auto deduced = lazy_init<std::string>(3, 'x');
+        static_assert(std::is_same_v<decltype(deduced),
+                                     lazy<std::string, i32, char>>);
+        REQUIRE(deduced.initialized() == false);
+        REQUIRE(*deduced == "xxx");
+        REQUIRE(deduced->size() == 3);
+    }
+
+    SECTION("should store arguments inline") {
+        using storage_t = nonstd::optional_storage<i64>;
+        static_assert(sizeof(lazy<i64, i64>) == sizeof(storage_t) + sizeof(i64));
+    }
+
+    SECTION("should destroy arguments that are never used") {
+        struct tracked {
+            i32 * live;
+            tracked(i32 * live) : live(live) { ++*live; }
+            tracked(tracked const& other) : live(other.live) { ++*live; }
+            ~tracked() { --*live; }
+        };
+        i32 live = 0;
+        {
+            lazy<i32, tracked> unused { tracked { &live } };
+            REQUIRE(live == 1);
+        }
+        REQUIRE(live == 0);
+    }
+
+    SECTION("should retry construction after a throwing constructor") {
+        struct fragile {
+            fragile(i32 * attempts) {
+                if (++*attempts < 2) { throw std::runtime_error("not yet"); }
+            }
+        };
+        i32 attempts = 0;
+        lazy<fragile, i32 *> instance { &attempts };
+        REQUIRE_THROWS_AS(*instance, std::runtime_error);
+        REQUIRE(instance.initialized() == false);
+        *instance;
+        REQUIRE(instance.initialized() == true);
+        REQUIRE(attempts == 2);
+    }
 }
 
-lazy<nr_ptr<i32>> lazy_nr { "test/lazy_nr" };
+lazy<nr_ptr<i32>, c_cstr> lazy_nr { "test/lazy_nr" };
 TEST_CASE("Lazy Wrappers Around nr_ptr", "[nonstd][lazy]") {
     SECTION("should not initialize until accessed") {
         REQUIRE(lazy_nr.initialized() == false);
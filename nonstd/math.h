@@ -54,6 +54,43 @@ constexpr T mask_lowest_bits(i32 nbits) noexcept {
 }
 
 
+/** Bit Scanning
+ *  ------------
+ *  The index of the lowest set bit, the number of bits above the highest set
+ *  bit (for both, `num` must be non-zero), and the number of set bits. These
+ *  lower to `tzcnt`/`bsf`, `lzcnt`/`bsr`, and `popcnt` where available.
+ */
+inline u32 count_trailing_zeros(u64 num) noexcept {
+    ASSERT(num != 0);
+#if defined(NONSTD_COMPILER_MSVC)
+    unsigned long index = 0;
+    _BitScanForward64(&index, num);
+    return static_cast<u32>(index);
+#else
+    return static_cast<u32>(__builtin_ctzll(num));
+#endif
+}
+
+inline u32 count_leading_zeros(u64 num) noexcept {
+    ASSERT(num != 0);
+#if defined(NONSTD_COMPILER_MSVC)
+    unsigned long index = 0;
+    _BitScanReverse64(&index, num);
+    return 63 - static_cast<u32>(index);
+#else
+    return static_cast<u32>(__builtin_clzll(num));
+#endif
+}
+
+inline u32 popcount(u64 num) noexcept {
+#if defined(NONSTD_COMPILER_MSVC)
+    return static_cast<u32>(__popcnt64(num));
+#else
+    return static_cast<u32>(__builtin_popcountll(num));
+#endif
+}
+
+
 /** Power of 2 Calculations/Comparisons
  *  ===================================
  *  These were lifted from Sean Eron Anderson's _Bit Twiddling Hacks_.
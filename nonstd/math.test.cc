@@ -14,6 +14,9 @@ using nonstd::mask_lowest_bits;
 using nonstd::is_power_of_two;
 using nonstd::ceil_power_of_two;
 using nonstd::floor_power_of_two;
+using nonstd::count_trailing_zeros;
+using nonstd::count_leading_zeros;
+using nonstd::popcount;
 
 
 TEST_CASE("Math Utilities", "[nonstd]") {
@@ -135,6 +138,21 @@ TEST_CASE("Math Utilities", "[nonstd]") {
         REQUIRE(floor_power_of_two((u64)(0x800000000000000))
                 ==                 (u64)(0x800000000000000));
     }
+
+    SECTION("should correctly scan and count set bits") {
+        REQUIRE(count_trailing_zeros(1) == 0);
+        REQUIRE(count_trailing_zeros(0b1000) == 3);
+        REQUIRE(count_trailing_zeros(0b1010) == 1);
+        REQUIRE(count_trailing_zeros(0x8000000000000000) == 63);
+
+        REQUIRE(count_leading_zeros(1) == 63);
+        REQUIRE(count_leading_zeros(0b1010) == 60);
+        REQUIRE(count_leading_zeros(0x8000000000000000) == 0);
+
+        REQUIRE(popcount(0) == 0);
+        REQUIRE(popcount(0b1011) == 3);
+        REQUIRE(popcount(0xFFFFFFFFFFFFFFFF) == 64);
+    }
 }
 
 } /* namespace math_utils */
@@ -0,0 +1,444 @@
+/** Memoization
+ *  ===========
+ *  Wrap a pure function in a bounded cache of its results.
+ *
+ *      auto measure = nonstd::memoize([&](std::string text, f32 size) {
+ *          return layout_text(font, text, size);
+ *      }, 1024);
+ *      extent e = measure("Continue", 14.f); // computed
+ *      extent f = measure("Continue", 14.f); // cached
+ *
+ *  The wrapper's call signature is the wrapped function's, deduced from a
+ *  function pointer or a function object with a single, non-template
+ *  `operator()`. Arguments are hashed through `nonstd::hash` (combined with
+ *  `hash_combine`), decayed, and stored by value alongside the result.
+ *  Parameters that only view a string -- `string_view` and C strings -- are
+ *  stored as `std::string`s, s.t. a cached key never outlives the caller's
+ *  string, and hash and compare by content. (C string arguments mustn't be
+ *  null.) Other pointers hash and compare by address. Other types fall back
+ *  to `std::hash`.
+ *
+ *  Results live in a fixed slab of entries, indexed by an open-addressing
+ *  (linear probing, backward-shift deletion) table of entry indices kept at
+ *  most half full. Nothing is allocated after construction. Once the cache is
+ *  full, each miss evicts an entry, chosen either by CLOCK (second-chance; the
+ *  default, and cheapest to maintain on hits) or true LRU.
+ *
+ *  `config::memory_budget`, if non-zero, further limits the number of entries
+ *  s.t. the entries and table together fit within that many bytes. Results
+ *  that own heap memory aren't counted.
+ *
+ *  With `config::shards` above 1, the cache is split into that many
+ *  independently locked shards (by hash), and may be called from any number
+ *  of threads. Misses compute outside the lock, so two threads that miss on
+ *  the same arguments at once may both call the function. With one shard (the
+ *  default), there's no locking at all, and the function may recursively call
+ *  its own memoized wrapper.
+ *
+ *  Results are returned by value; a cached result is copied out on every hit.
+ *  `stats()` reports hits, misses, and evictions, for tuning capacity.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/hash.h>
+#include <nonstd/optional_storage.h>
+
+
+namespace nonstd {
+
+enum class eviction_policy { clock, lru };
+
+struct memoize_config {
+    /** Maximum number of cached results. */
+    u32 capacity = 1024;
+    /** Maximum bytes of entries and table, or 0 for no limit. */
+    u64 memory_budget = 0;
+    eviction_policy policy = eviction_policy::clock;
+    /** Number of independently locked shards; 1 disables locking. */
+    u32 shards = 1;
+};
+
+struct memoize_stats {
+    u64 hits      = 0;
+    u64 misses    = 0;
+    u64 evictions = 0;
+    u32 size      = 0;
+    u32 capacity  = 0;
+};
+
+
+namespace detail::memoize_ {
+
+/** Signature deduction for function pointers and single-`operator()` function
+ *  objects. See `first_argument_t` in core/type_traits_ext.h.
+ */
+/** How a parameter is stored in a key; decayed, and by value, except that
+ *  views of strings are stored as the strings themselves.
+ */
+template <typename T>
+struct key_element { using type = T; };
+template <>
+struct key_element<std::string_view> { using type = std::string; };
+template <>
+struct key_element<c_cstr> { using type = std::string; };
+template <typename T>
+using key_element_t = typename key_element<std::decay_t<T>>::type;
+
+template <typename Return, typename ... Args>
+struct signature {
+    using result_type = std::decay_t<Return>;
+    using params_type = std::tuple<Args...>;
+    using key_type    = std::tuple<key_element_t<Args>...>;
+};
+
+/** A stored key element, as the parameter of type `Param` expects it. */
+template <typename Param, typename Stored>
+inline decltype(auto) pass_argument(Stored & stored) {
+    if constexpr (std::is_same_v<std::decay_t<Param>, c_cstr>) {
+        return stored.c_str();
+    } else {
+        return (stored);
+    }
+}
+
+template <typename Fn, typename Return, typename ... Args>
+signature<Return, Args...> helper(Return (Fn::*)(Args...));
+template <typename Fn, typename Return, typename ... Args>
+signature<Return, Args...> helper(Return (Fn::*)(Args...) const);
+template <typename Return, typename ... Args>
+signature<Return, Args...> helper(Return (*)(Args...));
+
+template <typename Fn, typename = void>
+struct signature_of {
+    using type = decltype(helper(std::declval<Fn>()));
+};
+template <typename Fn>
+struct signature_of<Fn, std::void_t<decltype(&Fn::operator())>> {
+    using type = decltype(helper(&Fn::operator()));
+};
+template <typename Fn>
+using signature_of_t = typename signature_of<Fn>::type;
+
+
+template <typename T>
+inline u64 hash_argument(T const & arg) {
+    if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+        return nonstd::hash(static_cast<u64>(arg));
+    } else if constexpr (std::is_floating_point_v<T>) {
+        return nonstd::hash(static_cast<f64>(arg));
+    } else if constexpr (std::is_convertible_v<T const &, std::string_view>) {
+        return nonstd::hash(std::string_view { arg });
+    } else if constexpr (std::is_pointer_v<T>) {
+        return nonstd::hash(u64 { reinterpret_cast<uintptr_t>(arg) });
+    } else {
+        return std::hash<T>{}(arg);
+    }
+}
+
+template <typename Tuple, std::size_t ... Is>
+inline u64 hash_key(Tuple const & key, std::index_sequence<Is...>) {
+    u64 seed = 0;
+    ((seed = hash_combine(seed, hash_argument(std::get<Is>(key)))), ...);
+    return seed;
+}
+
+
+/** One shard of a memoization cache. Not synchronized. */
+template <typename Key, typename Result>
+class cache {
+public:
+    static constexpr u32 none = ~u32{0};
+
+    struct record {
+        Key    key;
+        Result result;
+    };
+
+    struct entry {
+        optional_storage<record> value;
+        u64  hash       = 0;
+        u32  prev       = none; // LRU list, most recently used first.
+        u32  next       = none;
+        bool referenced = false; // CLOCK's second-chance bit.
+    };
+
+    /** Approximate bytes used per entry, for memory budgets. */
+    static constexpr u64 bytes_per_entry = sizeof(entry) + 2 * sizeof(u32);
+
+private:
+    std::vector<entry> m_entries;
+    std::vector<u32>   m_table;
+    u64                m_mask;
+    u32                m_size;
+    u32                m_hand;
+    u32                m_head;
+    u32                m_tail;
+    eviction_policy    m_policy;
+    u64                m_hits;
+    u64                m_misses;
+    u64                m_evictions;
+
+public:
+    cache(u32 capacity, eviction_policy policy)
+        : m_entries   ( n2max(capacity, u32{1}) )
+        , m_table     ( )
+        , m_mask      ( 0 )
+        , m_size      ( 0 )
+        , m_hand      ( 0 )
+        , m_head      ( none )
+        , m_tail      ( none )
+        , m_policy    ( policy )
+        , m_hits      ( 0 )
+        , m_misses    ( 0 )
+        , m_evictions ( 0 )
+    {
+        u64 slots = 2;
+        while (slots < 2 * static_cast<u64>(m_entries.size())) { slots <<= 1; }
+        m_table.assign(slots, none);
+        m_mask = slots - 1;
+    }
+
+    /** The cached result for `key`, or null. Counts a hit or a miss. */
+    Result const * find(Key const & key, u64 hash) {
+        u32 const index = lookup(key, hash);
+        if (index == none) {
+            m_misses += 1;
+            return nullptr;
+        }
+        m_hits += 1;
+        touch(index);
+        return &m_entries[index].value.get_value().result;
+    }
+
+    /** Cache `result` for `key`, evicting if full. No-op if already cached. */
+    void insert(Key && key, u64 hash, Result && result) {
+        if (lookup(key, hash) != none) { return; }
+        u32 const index = (m_size < m_entries.size()) ? m_size++ : evict();
+
+        entry & e = m_entries[index];
+        e.value.construct_value(record { std::move(key), std::move(result) });
+        e.hash = hash;
+        e.referenced = false;
+        u64 slot = hash & m_mask;
+        while (m_table[slot] != none) { slot = (slot + 1) & m_mask; }
+        m_table[slot] = index;
+        if (m_policy == eviction_policy::lru) { link_front(index); }
+    }
+
+    u32 size()     const noexcept { return m_size; }
+    u32 capacity() const noexcept { return static_cast<u32>(m_entries.size()); }
+
+    void add_stats(memoize_stats & stats) const noexcept {
+        stats.hits      += m_hits;
+        stats.misses    += m_misses;
+        stats.evictions += m_evictions;
+        stats.size      += m_size;
+        stats.capacity  += capacity();
+    }
+
+private:
+    u32 lookup(Key const & key, u64 hash) const {
+        for (u64 slot = hash & m_mask; ; slot = (slot + 1) & m_mask) {
+            u32 const index = m_table[slot];
+            if (index == none) { return none; }
+            entry const & e = m_entries[index];
+            if (e.hash == hash && e.value.get_value().key == key) {
+                return index;
+            }
+        }
+    }
+
+    void touch(u32 index) {
+        if (m_policy == eviction_policy::clock) {
+            m_entries[index].referenced = true;
+        } else if (m_head != index) {
+            unlink(index);
+            link_front(index);
+        }
+    }
+
+    /** Choose a victim, remove it from the table, and return its index. */
+    u32 evict() {
+        u32 victim;
+        if (m_policy == eviction_policy::clock) {
+            while (m_entries[m_hand].referenced) {
+                m_entries[m_hand].referenced = false;
+                m_hand = (m_hand + 1) % capacity();
+            }
+            victim = m_hand;
+            m_hand = (m_hand + 1) % capacity();
+        } else {
+            victim = m_tail;
+            unlink(victim);
+        }
+        erase_slot(victim);
+        m_entries[victim].value.remove_value();
+        m_evictions += 1;
+        return victim;
+    }
+
+    /** Remove `index` from the table, shifting later probes back into the
+     *  hole s.t. no tombstones are needed.
+     */
+    void erase_slot(u32 index) {
+        u64 hole = m_entries[index].hash & m_mask;
+        while (m_table[hole] != index) { hole = (hole + 1) & m_mask; }
+        for (u64 slot = (hole + 1) & m_mask; m_table[slot] != none;
+             slot = (slot + 1) & m_mask) {
+            u64 const home = m_entries[m_table[slot]].hash & m_mask;
+            // Move the entry back if its home isn't cyclically in (hole, slot].
+            if (((slot - home) & m_mask) >= ((slot - hole) & m_mask)) {
+                m_table[hole] = m_table[slot];
+                hole = slot;
+            }
+        }
+        m_table[hole] = none;
+    }
+
+    void unlink(u32 index) {
+        entry & e = m_entries[index];
+        if (e.prev != none) { m_entries[e.prev].next = e.next; }
+        else                { m_head = e.next; }
+        if (e.next != none) { m_entries[e.next].prev = e.prev; }
+        else                { m_tail = e.prev; }
+        e.prev = e.next = none;
+    }
+
+    void link_front(u32 index) {
+        entry & e = m_entries[index];
+        e.prev = none;
+        e.next = m_head;
+        if (m_head != none) { m_entries[m_head].prev = index; }
+        m_head = index;
+        if (m_tail == none) { m_tail = index; }
+    }
+};
+
+} /* namespace detail::memoize_ */
+
+
+/** Memoized Function
+ *  -----------------
+ *  What `memoize` returns. A call builds a key from its arguments, and looks
+ *  it up in the shard the key's hash selects; a hit copies the cached result
+ *  out, and a miss calls the wrapped function -- outside of any lock -- and
+ *  caches what it returns. Movable, but not copyable; its shards, and their
+ *  locks, are owned by exactly one wrapper.
+ */
+template <typename Fn>
+class memoized {
+private:
+    using signature   = detail::memoize_::signature_of_t<Fn>;
+    using key_type    = typename signature::key_type;
+    using result_type = typename signature::result_type;
+    using params_type = typename signature::params_type;
+    using cache_type  = detail::memoize_::cache<key_type, result_type>;
+    using indices     = std::make_index_sequence<std::tuple_size_v<key_type>>;
+
+    struct ALIGNAS(cache_line_size) shard {
+        std::mutex mutex;
+        cache_type cache;
+
+        shard(u32 capacity, eviction_policy policy)
+            : mutex ( )
+            , cache ( capacity, policy )
+        { }
+    };
+
+    Fn                                  m_fn;
+    u32                                 m_shard_count;
+    std::vector<std::unique_ptr<shard>> m_shards;
+
+    static u32 entries_for(memoize_config const & config) {
+        u64 entries = config.capacity;
+        if (config.memory_budget > 0) {
+            entries = n2min(entries, config.memory_budget
+                                   / cache_type::bytes_per_entry);
+        }
+        return static_cast<u32>(n2max(entries, u64{1}));
+    }
+
+    template <std::size_t ... Is>
+    result_type _call(key_type & key, std::index_sequence<Is...>) {
+        return m_fn(detail::memoize_::pass_argument<
+                        std::tuple_element_t<Is, params_type>>(
+                            std::get<Is>(key))...);
+    }
+
+public:
+    memoized(Fn fn, memoize_config const & config)
+        : m_fn          ( std::move(fn) )
+        , m_shard_count ( n2max(config.shards, u32{1}) )
+        , m_shards      ( )
+    {
+        u32 const total = entries_for(config);
+        u32 const per_shard = n2max(total / m_shard_count, u32{1});
+        m_shards.reserve(m_shard_count);
+        for (u32 i = 0; i < m_shard_count; ++i) {
+            m_shards.push_back(
+                std::make_unique<shard>(per_shard, config.policy));
+        }
+    }
+
+    template <typename ... Args>
+    result_type operator() (Args&&... args) {
+        key_type key { std::forward<Args>(args)... };
+        u64 const hash = detail::memoize_::hash_key(key, indices { });
+        shard & s = *m_shards[(hash >> 48) % m_shard_count];
+
+        if (m_shard_count == 1) {
+            if (auto cached = s.cache.find(key, hash)) { return *cached; }
+            result_type result = _call(key, indices { });
+            s.cache.insert(std::move(key), hash, result_type { result });
+            return result;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock { s.mutex };
+            if (auto cached = s.cache.find(key, hash)) { return *cached; }
+        }
+        result_type result = _call(key, indices { });
+        std::lock_guard<std::mutex> lock { s.mutex };
+        s.cache.insert(std::move(key), hash, result_type { result });
+        return result;
+    }
+
+    memoize_stats stats() {
+        memoize_stats result;
+        for (u32 i = 0; i < m_shard_count; ++i) {
+            std::unique_lock<std::mutex> lock { m_shards[i]->mutex,
+                                                std::defer_lock };
+            if (m_shard_count > 1) { lock.lock(); }
+            m_shards[i]->cache.add_stats(result);
+        }
+        return result;
+    }
+};
+
+
+/** Wrap `fn` in a cache of (at most) `capacity` results. */
+template <typename Fn>
+inline memoized<std::decay_t<Fn>> memoize(Fn && fn, memoize_config config) {
+    return { std::forward<Fn>(fn), config };
+}
+
+template <typename Fn>
+inline memoized<std::decay_t<Fn>> memoize(Fn && fn, u32 capacity = 1024) {
+    memoize_config config;
+    config.capacity = capacity;
+    return { std::forward<Fn>(fn), config };
+}
+
+} /* namespace nonstd */
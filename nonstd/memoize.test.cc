@@ -0,0 +1,181 @@
+/** Memoization Tests
+ *  =================
+ *  GOAL: Validate that memoized functions return the same results as the
+ *  functions they wrap, call them only on misses, evict within their capacity
+ *  under both policies, and stay consistent when called from many threads.
+ */
+
+#include <nonstd/memoize.h>
+#include <platform/testrunner/testrunner.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+
+
+namespace nonstd_test::memoize {
+
+using nonstd::eviction_policy;
+using nonstd::memoize;
+using nonstd::memoize_config;
+
+
+u64 square(u64 x) { return x * x; }
+
+
+TEST_CASE("Memoization", "[nonstd][memoize]") {
+    SECTION("call the wrapped function only on misses") {
+        u32 calls = 0;
+        auto area = memoize([&](i32 w, f32 h) {
+            calls += 1;
+            return f32(w) * h;
+        }, 16);
+
+        REQUIRE(area(3, 2.f) == 6.f);
+        REQUIRE(area(3, 2.f) == 6.f);
+        REQUIRE(area(2, 3.f) == 6.f);
+        REQUIRE(calls == 2);
+
+        auto stats = area.stats();
+        REQUIRE(stats.hits == 1);
+        REQUIRE(stats.misses == 2);
+        REQUIRE(stats.evictions == 0);
+        REQUIRE(stats.size == 2);
+    }
+
+    SECTION("wrap function pointers, and hash strings by content") {
+        auto squared = memoize(&square);
+        REQUIRE(squared(12) == 144);
+        REQUIRE(squared(12) == 144);
+        REQUIRE(squared.stats().hits == 1);
+
+        auto length = memoize([](std::string s) { return s.size(); });
+        std::string key = "layout";
+        REQUIRE(length(key) == 6);
+        REQUIRE(length("layout") == 6);
+        REQUIRE(length.stats().hits == 1);
+    }
+
+    SECTION("copy string views and C strings into their keys") {
+        u32 calls = 0;
+        auto length = memoize([&](std::string_view s) {
+            calls += 1;
+            return s.size();
+        });
+        // Each argument is freed before the next call; the cached key mustn't
+        // refer to it.
+        REQUIRE(length(std::string(40, 'x')) == 40);
+        REQUIRE(length(std::string(40, 'x')) == 40);
+        REQUIRE(length(std::string(40, 'y')) == 40);
+        REQUIRE(calls == 2);
+
+        auto first = memoize([](c_cstr s) { return s[0]; });
+        auto text = std::make_unique<std::string>("memoized");
+        REQUIRE(first(text->c_str()) == 'm');
+        text = std::make_unique<std::string>("memoized");
+        REQUIRE(first(text->c_str()) == 'm');
+        REQUIRE(first.stats().hits == 1);
+        text.reset();
+        REQUIRE(first("nonstd") == 'n');
+        REQUIRE(first.stats().misses == 2);
+    }
+
+    SECTION("stay within capacity") {
+        for (auto policy : { eviction_policy::clock, eviction_policy::lru }) {
+            memoize_config config;
+            config.capacity = 64;
+            config.policy = policy;
+            auto squared = memoize(&square, config);
+            for (u64 i = 0; i < 1000; ++i) { REQUIRE(squared(i) == i * i); }
+            // Earlier values are still correct, whether cached or not.
+            for (u64 i = 0; i < 1000; i += 7) { REQUIRE(squared(i) == i * i); }
+
+            auto stats = squared.stats();
+            REQUIRE(stats.size == 64);
+            REQUIRE(stats.capacity == 64);
+            REQUIRE(stats.evictions == stats.misses - 64);
+        }
+    }
+
+    SECTION("keep recently used entries under LRU") {
+        memoize_config config;
+        config.capacity = 4;
+        config.policy = eviction_policy::lru;
+        u32 calls = 0;
+        auto fn = memoize([&](u32 x) { calls += 1; return x; }, config);
+        for (u32 i = 0; i < 4; ++i) { fn(i); }
+        fn(0);        // 0 is now most recently used,
+        fn(100);      // so 1 is evicted,
+        calls = 0;
+        fn(0);
+        REQUIRE(calls == 0);
+        fn(1);
+        REQUIRE(calls == 1);
+    }
+
+    SECTION("give referenced entries a second chance under CLOCK") {
+        memoize_config config;
+        config.capacity = 4;
+        u32 calls = 0;
+        auto fn = memoize([&](u32 x) { calls += 1; return x; }, config);
+        for (u32 i = 0; i < 4; ++i) { fn(i); }
+        fn(0);        // 0 is referenced,
+        fn(100);      // so the hand passes it and evicts 1,
+        calls = 0;
+        fn(0);
+        REQUIRE(calls == 0);
+        fn(1);
+        REQUIRE(calls == 1);
+    }
+
+    SECTION("limit entries by memory budget") {
+        memoize_config config;
+        config.capacity = 1'000'000;
+        config.memory_budget = KBYTES(4);
+        auto squared = memoize(&square, config);
+        for (u64 i = 0; i < 10'000; ++i) { squared(i); }
+        REQUIRE(squared.stats().capacity < 1'000'000);
+        REQUIRE(squared.stats().size == squared.stats().capacity);
+    }
+
+    SECTION("allow recursion") {
+        std::function<u64(u32)> fib;
+        auto memo = memoize([&](u32 n) -> u64 {
+            return n < 2 ? n : fib(n - 1) + fib(n - 2);
+        }, 128);
+        fib = [&](u32 n) { return memo(n); };
+        REQUIRE(fib(90) == 2880067194370816120ull);
+        REQUIRE(memo.stats().misses == 91);
+    }
+
+    SECTION("share results between threads when sharded") {
+        memoize_config config;
+        config.capacity = 256;
+        config.shards = 8;
+        std::atomic<u32> wrong { 0 };
+        auto squared = memoize(&square, config);
+        std::vector<std::thread> threads;
+        for (u32 t = 0; t < 4; ++t) {
+            threads.emplace_back([&] {
+                for (u64 i = 0; i < 20'000; ++i) {
+                    u64 const x = i % 512;
+                    if (squared(x) != x * x) { wrong.fetch_add(1); }
+                }
+            });
+        }
+        for (auto & t : threads) { t.join(); }
+
+        auto stats = squared.stats();
+        REQUIRE(wrong.load() == 0);
+        REQUIRE(stats.hits + stats.misses == 4 * 20'000);
+        REQUIRE(stats.size <= stats.capacity);
+    }
+}
+
+} /* namespace nonstd_test::memoize */
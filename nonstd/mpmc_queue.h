@@ -0,0 +1,177 @@
+/** Bounded Multi-Producer Multi-Consumer Queue
+ *  ===========================================
+ *  A fixed-capacity, lock-free FIFO that any number of threads may push to and
+ *  pop from concurrently. This is Dmitry Vyukov's bounded MPMC queue;
+ *  http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+ *
+ *  Each cell of the ring carries a sequence number that tells producers and
+ *  consumers whether the cell is ready for them. A push or a pop costs a single
+ *  CAS on the relevant cursor in the uncontended case, and neither operation
+ *  ever blocks; when the queue is full (or empty) `try_push` (or `try_pop`)
+ *  just returns `false` (or `nullopt`). Blocking, waiting, and closing are left
+ *  to higher-level types built on this one.
+ *
+ *  The cursors and cells are padded out to `nonstd::cache_line_size` so that
+ *  producers and consumers don't false-share.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/math.h>
+#include <nonstd/optional.h>
+#include <nonstd/optional_storage.h>
+
+
+namespace nonstd {
+
+template <typename T>
+class mpmc_queue {
+    static_assert(std::is_nothrow_move_constructible_v<T>,
+        "mpmc_queue elements must be nothrow move constructible; a throwing "
+        "move would leave a cell claimed but never published.");
+
+private:
+    struct ALIGNAS(cache_line_size) cell {
+        std::atomic<u64>    sequence;
+        optional_storage<T> storage;
+    };
+
+    struct ALIGNAS(cache_line_size) cursor {
+        std::atomic<u64> position { 0 };
+    };
+
+    std::unique_ptr<cell[]> m_cells;
+    u64                     m_mask;
+    cursor                  m_enqueue;
+    cursor                  m_dequeue;
+
+public:
+    /** Construct a queue that can hold at least `capacity` elements. The
+     *  capacity is rounded up to the next power of two.
+     */
+    explicit mpmc_queue(u64 capacity)
+        : m_cells ( nullptr )
+        , m_mask  ( 0       )
+    {
+        BREAK_IF(capacity < 2, nonstd::error::pebcak,
+                 "mpmc_queue requires a capacity of at least 2 (given {})",
+                 capacity);
+        u64 const size = ceil_power_of_two(capacity);
+        m_cells = std::make_unique<cell[]>(size);
+        m_mask  = size - 1;
+        for (u64 i = 0; i < size; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    mpmc_queue(mpmc_queue const &) = delete;
+    mpmc_queue(mpmc_queue &&) = delete;
+    mpmc_queue& operator= (mpmc_queue const &) = delete;
+    mpmc_queue& operator= (mpmc_queue &&) = delete;
+
+    ~mpmc_queue() {
+        while (try_pop()) { }
+    }
+
+    u64 capacity() const noexcept { return m_mask + 1; }
+
+    /** Approximate number of elements in the queue. Only exact when no other
+     *  thread is pushing or popping.
+     */
+    u64 size_approx() const noexcept {
+        u64 const head = m_dequeue.position.load(std::memory_order_relaxed);
+        u64 const tail = m_enqueue.position.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    /** Attempt to emplace a `T` at the back of the queue. Returns `false` if
+     *  the queue is full.
+     *
+     *  Where constructing a `T` from `args` can't throw, it's constructed in
+     *  place, and not at all if the queue is full. Otherwise it's constructed
+     *  into a temporary before a cell is claimed, and moved in after, s.t. a
+     *  throwing constructor leaves the queue untouched rather than leaving a
+     *  claimed cell that's never published.
+     */
+    template <typename ... Args>
+    bool try_emplace(Args && ... args)
+    noexcept(std::is_nothrow_constructible_v<T, Args && ...>) {
+        if constexpr (std::is_nothrow_constructible_v<T, Args && ...>) {
+            u64 pos = 0;
+            cell* target = _claim_enqueue(pos);
+            if (!target) { return false; }
+            target->storage.construct_value(std::forward<Args>(args)...);
+            target->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        } else {
+            return try_emplace(T ( std::forward<Args>(args)... ));
+        }
+    }
+
+    bool try_push(T const & value)
+    noexcept(std::is_nothrow_copy_constructible_v<T>) {
+        return try_emplace(value);
+    }
+    bool try_push(T && value) noexcept {
+        return try_emplace(std::move(value));
+    }
+
+    /** Attempt to pop the element at the front of the queue. Returns `nullopt`
+     *  if the queue is empty.
+     */
+    optional<T> try_pop() noexcept {
+        cell* target = nullptr;
+        u64 pos = m_dequeue.position.load(std::memory_order_relaxed);
+        while (true) {
+            target = &m_cells[pos & m_mask];
+            u64 const seq  = target->sequence.load(std::memory_order_acquire);
+            i64 const diff = static_cast<i64>(seq) - static_cast<i64>(pos + 1);
+            if (diff == 0) {
+                if (m_dequeue.position.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return nullopt;
+            } else {
+                pos = m_dequeue.position.load(std::memory_order_relaxed);
+            }
+        }
+        optional<T> ret { std::move(target->storage.get_value()) };
+        target->storage.remove_value();
+        target->sequence.store(pos + m_mask + 1, std::memory_order_release);
+        return ret;
+    }
+
+private:
+    /** Claim the cell at the back of the queue, or return `nullptr` if the
+     *  queue is full. The caller must construct a value in the cell, then
+     *  publish it by storing `pos + 1` to its sequence.
+     */
+    cell* _claim_enqueue(u64 & pos) noexcept {
+        pos = m_enqueue.position.load(std::memory_order_relaxed);
+        while (true) {
+            cell* target = &m_cells[pos & m_mask];
+            u64 const seq  = target->sequence.load(std::memory_order_acquire);
+            i64 const diff = static_cast<i64>(seq) - static_cast<i64>(pos);
+            if (diff == 0) {
+                if (m_enqueue.position.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    return target;
+                }
+            } else if (diff < 0) {
+                return nullptr;
+            } else {
+                pos = m_enqueue.position.load(std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+} /* namespace nonstd */
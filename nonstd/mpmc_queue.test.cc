@@ -0,0 +1,147 @@
+/** MPMC Queue Tests
+ *  ================
+ *  GOAL: Validate that the queue is a FIFO that reports when it's full or
+ *  empty, keeps working as its cursors wrap the ring, survives throwing
+ *  constructors, and delivers every value exactly once under contention.
+ */
+
+#include <nonstd/mpmc_queue.h>
+#include <platform/testrunner/testrunner.h>
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+
+
+namespace nonstd_test::mpmc_queue {
+
+using nonstd::mpmc_queue;
+
+
+/** Constructible from a `u64`, except for 13, and nothrow movable. */
+struct fragile {
+    u64 value;
+
+    explicit fragile(u64 v) : value ( v ) {
+        if (v == 13) { throw std::runtime_error("unlucky"); }
+    }
+    fragile(fragile &&) noexcept = default;
+    fragile& operator= (fragile &&) noexcept = default;
+};
+
+
+TEST_CASE("MPMC Queue", "[nonstd][mpmc_queue]") {
+    SECTION("round capacity up to a power of two") {
+        mpmc_queue<u32> queue { 5 };
+        REQUIRE(queue.capacity() == 8);
+        REQUIRE_THROWS(mpmc_queue<u32> { 1 });
+    }
+
+    SECTION("report full and empty") {
+        mpmc_queue<u32> queue { 4 };
+        REQUIRE_FALSE(queue.try_pop());
+        for (u32 i = 0; i < 4; ++i) { REQUIRE(queue.try_push(i)); }
+        REQUIRE(queue.size_approx() == 4);
+        REQUIRE_FALSE(queue.try_push(4));
+        for (u32 i = 0; i < 4; ++i) { REQUIRE(*queue.try_pop() == i); }
+        REQUIRE_FALSE(queue.try_pop());
+        REQUIRE(queue.size_approx() == 0);
+    }
+
+    SECTION("stay in order as the cursors wrap the ring") {
+        mpmc_queue<u64> queue { 4 };
+        u64 pushed = 0;
+        u64 popped = 0;
+        // Alternate between filling and draining by uneven amounts, s.t. each
+        // cell is reused many times at every offset.
+        for (u32 round = 0; round < 100; ++round) {
+            while (queue.try_push(pushed)) { pushed += 1; }
+            REQUIRE(queue.size_approx() == 4);
+            for (u32 i = 0; i < 1 + round % 4; ++i) {
+                auto value = queue.try_pop();
+                REQUIRE(value);
+                REQUIRE(*value == popped);
+                popped += 1;
+            }
+        }
+        while (auto value = queue.try_pop()) {
+            REQUIRE(*value == popped);
+            popped += 1;
+        }
+        REQUIRE(popped == pushed);
+        REQUIRE(pushed > 50 * queue.capacity());
+    }
+
+    SECTION("leave the queue untouched when a constructor throws") {
+        mpmc_queue<fragile> queue { 2 };
+        REQUIRE(queue.try_emplace(u64 { 1 }));
+        REQUIRE_THROWS(queue.try_emplace(u64 { 13 }));
+        REQUIRE(queue.size_approx() == 1);
+
+        // No cell was left claimed; the queue still fills, and drains in
+        // order, across the point where the throw happened.
+        REQUIRE(queue.try_emplace(u64 { 2 }));
+        REQUIRE_FALSE(queue.try_emplace(u64 { 3 }));
+        REQUIRE(queue.try_pop()->value == 1);
+        REQUIRE(queue.try_pop()->value == 2);
+        REQUIRE_FALSE(queue.try_pop());
+        for (u64 i = 4; i < 10; ++i) {
+            REQUIRE(queue.try_emplace(i));
+            REQUIRE(queue.try_pop()->value == i);
+        }
+    }
+
+    SECTION("destroy what's left in it") {
+        auto counter = std::make_shared<u32>(0);
+        {
+            mpmc_queue<std::shared_ptr<u32>> queue { 8 };
+            for (u32 i = 0; i < 5; ++i) { queue.try_push(counter); }
+            REQUIRE(counter.use_count() == 6);
+        }
+        REQUIRE(counter.use_count() == 1);
+    }
+
+    SECTION("deliver every value exactly once to many consumers") {
+        constexpr u32 producers    = 4;
+        constexpr u32 consumers    = 4;
+        constexpr u64 per_producer = 50'000;
+        mpmc_queue<u64> queue { 64 };
+        std::atomic<u64> received_sum   { 0 };
+        std::atomic<u64> received_count { 0 };
+
+        std::vector<std::thread> threads;
+        for (u32 p = 0; p < producers; ++p) {
+            threads.emplace_back([&] {
+                for (u64 i = 1; i <= per_producer; ++i) {
+                    while (!queue.try_push(i)) { std::this_thread::yield(); }
+                }
+            });
+        }
+        for (u32 c = 0; c < consumers; ++c) {
+            threads.emplace_back([&] {
+                u64 sum = 0;
+                while (received_count.load() < producers * per_producer) {
+                    if (auto value = queue.try_pop()) {
+                        sum += *value;
+                        received_count.fetch_add(1);
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+                received_sum += sum;
+            });
+        }
+        for (auto & t : threads) { t.join(); }
+
+        REQUIRE(received_count.load() == producers * per_producer);
+        REQUIRE(received_sum.load()
+                == producers * (per_producer * (per_producer + 1) / 2));
+        REQUIRE_FALSE(queue.try_pop());
+    }
+}
+
+} /* namespace nonstd_test::mpmc_queue */
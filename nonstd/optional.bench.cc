@@ -0,0 +1,77 @@
+/** Optional Benchmarks
+ *  ===================
+ *  Runs the same filter -> transform -> and_then -> fallback pipeline over an
+ *  array of `optional<u32>`s, written as a monadic chain and as the presence
+ *  checks it stands for. Checks optional.h's premise; that the chain is free,
+ *  once the compiler has inlined it.
+ */
+
+#include <nonstd/optional.h>
+#include <nonstd/benchmark.h>
+
+#include <vector>
+
+#include <nonstd/nonstd.h>
+
+
+namespace nonstd_bench::optional {
+
+using nonstd::nullopt;
+using nonstd::optional;
+
+constexpr u32 limit = 1'000'000;
+
+NOINLINE u64 sum_chained(std::vector<optional<u32>> const & values) {
+    u64 sum = 0;
+    for (auto const & value : values) {
+        sum += value.filter([](u32 x) { return x % 3 != 0; })
+                    .transform([](u32 x) { return x * 5 + 1; })
+                    .and_then([](u32 x) -> optional<u32> {
+                        if (x > limit) { return nullopt; }
+                        return x / 2;
+                    })
+                    .value_or_else([] { return 7u; });
+    }
+    return sum;
+}
+
+NOINLINE u64 sum_checked(std::vector<optional<u32>> const & values) {
+    u64 sum = 0;
+    for (auto const & value : values) {
+        u32 result = 7;
+        if (value && *value % 3 != 0) {
+            u32 const x = *value * 5 + 1;
+            if (x <= limit) { result = x / 2; }
+        }
+        sum += result;
+    }
+    return sum;
+}
+
+
+NONSTD_BENCHMARK("optional monadic chains") {
+    u32 const count = 4096;
+    std::vector<optional<u32>> values (count);
+    for (u32 i = 0; i < count; ++i) {
+        // A quarter are empty, and some exceed the `and_then` limit.
+        if ((i * 7919u) % 4u != 0) { values[i] = (i * 2654435761u) % 400'000; }
+    }
+    BREAK_UNLESS(sum_chained(values) == sum_checked(values),
+                 nonstd::error::error,
+                 "The chained and hand-checked pipelines disagree.");
+
+    auto const & checked = bench.run("hand-written checks", [&] {
+        nonstd::do_not_optimize(values);
+        nonstd::do_not_optimize(sum_checked(values));
+    }, count);
+    auto const & chained = bench.run("monadic chain", [&] {
+        nonstd::do_not_optimize(values);
+        nonstd::do_not_optimize(sum_chained(values));
+    }, count);
+
+    bench.expect_speedup(checked, chained, 0.9,
+        "optional.h: a monadic chain runs as fast as the presence checks it "
+        "replaces (within 10%)");
+}
+
+} /* namespace nonstd_bench::optional */
@@ -67,6 +67,7 @@
 #include <iostream>
 #include <stdexcept>
 #include <type_traits>
+#include <utility>
 
 #include <nonstd/nonstd.h>
 #include <nonstd/optional_storage.h>
@@ -174,6 +175,78 @@ template <typename U, typename T>
 inline constexpr bool is_assignable_from_optional_v =
     is_assignable_from_optional<T,U>::value;
 
+template <typename T>
+struct is_optional : public std::false_type { };
+template <typename T>
+struct is_optional<optional<T>> : public std::true_type { };
+template <typename T>
+inline constexpr bool is_optional_v = is_optional<T>::value;
+
+
+/** Monadic Operation Implementations
+ *  ----------------------------------
+ *  Shared by `optional<T>` and `optional<T&>`. `Self` is the (forwarded)
+ *  optional, so `*std::forward<Self>(self)` is a `T&&` when called through an
+ *  rvalue `optional<T>`, and the contained value is moved -- not copied --
+ *  into `fn`. References are always passed as lvalues.
+ */
+template <typename Self, typename Fn>
+using _optional_invoke_result_t = std::remove_cv_t<std::remove_reference_t<
+    decltype(std::declval<Fn>()(*std::declval<Self>()))>>;
+
+template <typename Self, typename Fn>
+constexpr auto _optional_and_then(Self && self, Fn && fn) {
+    using result = _optional_invoke_result_t<Self, Fn>;
+    static_assert(is_optional_v<result>,
+        "and_then's function must return an optional.");
+    if (self.has_value()) {
+        return std::forward<Fn>(fn)(*std::forward<Self>(self));
+    }
+    return result { };
+}
+
+template <typename Self, typename Fn>
+constexpr auto _optional_transform(Self && self, Fn && fn) {
+    using value = _optional_invoke_result_t<Self, Fn>;
+    static_assert(!std::is_void_v<value>,
+        "transform's function must return a value.");
+    if (self.has_value()) {
+        return optional<value> { nonstd::in_place,
+                                 std::forward<Fn>(fn)(
+                                     *std::forward<Self>(self)) };
+    }
+    return optional<value> { };
+}
+
+template <typename Self, typename Fn>
+constexpr auto _optional_or_else(Self && self, Fn && fn) {
+    using result = std::decay_t<Self>;
+    static_assert(std::is_same_v<std::decay_t<decltype(std::declval<Fn>()())>,
+                                 result>,
+        "or_else's function must return an optional of the same type.");
+    if (self.has_value()) {
+        return result { std::forward<Self>(self) };
+    }
+    return std::forward<Fn>(fn)();
+}
+
+template <typename Self, typename Pred>
+constexpr auto _optional_filter(Self && self, Pred && pred) {
+    using result = std::decay_t<Self>;
+    if (self.has_value() && std::forward<Pred>(pred)(std::as_const(*self))) {
+        return result { std::forward<Self>(self) };
+    }
+    return result { };
+}
+
+template <typename R, typename Self, typename Fn>
+constexpr R _optional_value_or_else(Self && self, Fn && fn) {
+    if (self.has_value()) {
+        return *std::forward<Self>(self);
+    }
+    return std::forward<Fn>(fn)();
+}
+
 
 /** Base-Class for Value-Wrapping Optional Types
  *  ============================================================================
@@ -878,6 +951,96 @@ public:
              : static_cast<T>(std::forward<U>(value));
     }
 
+    /** Monadic Operations -- nonstd
+     *  ----------------------------
+     *  Chain operations over the contained value, without branching by hand;
+     *   - `and_then(fn)` returns `fn(*val)` -- itself an `optional` -- if
+     *     `*this` contains a value; otherwise an empty optional.
+     *   - `transform(fn)` returns an `optional` containing `fn(*val)` if
+     *     `*this` contains a value; otherwise an empty optional.
+     *   - `or_else(fn)` returns `*this` if it contains a value; otherwise
+     *     `fn()`, which must return an `optional<T>`.
+     *   - `filter(pred)` returns `*this` if it contains a value for which
+     *     `pred(*val)` is `true`; otherwise an empty optional.
+     *   - `value_or_else(fn)` returns `*val` if `*this` contains a value;
+     *     otherwise `fn()`. Unlike `value_or`, the fallback is only computed
+     *     when it's needed.
+     *  Each is overloaded for all four value categories of `*this`. Called on
+     *  an rvalue, the contained value is moved into `fn` (or into the result),
+     *  so values move through the whole chain;
+     *
+     *      auto name = find_user(id)                      // optional<user>
+     *                      .filter(is_active)
+     *                      .transform(&display_name)      // optional<string>
+     *                      .value_or_else(default_name);  // string
+     */
+    template <typename Fn> constexpr auto and_then(Fn && fn)       &  {
+        return _optional_and_then(*this, std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto and_then(Fn && fn) const &  {
+        return _optional_and_then(*this, std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto and_then(Fn && fn)       && {
+        return _optional_and_then(std::move(*this), std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto and_then(Fn && fn) const && {
+        return _optional_and_then(std::move(*this), std::forward<Fn>(fn));
+    }
+
+    template <typename Fn> constexpr auto transform(Fn && fn)       &  {
+        return _optional_transform(*this, std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto transform(Fn && fn) const &  {
+        return _optional_transform(*this, std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto transform(Fn && fn)       && {
+        return _optional_transform(std::move(*this), std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto transform(Fn && fn) const && {
+        return _optional_transform(std::move(*this), std::forward<Fn>(fn));
+    }
+
+    template <typename Fn> constexpr auto or_else(Fn && fn)       &  {
+        return _optional_or_else(*this, std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto or_else(Fn && fn) const &  {
+        return _optional_or_else(*this, std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto or_else(Fn && fn)       && {
+        return _optional_or_else(std::move(*this), std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto or_else(Fn && fn) const && {
+        return _optional_or_else(std::move(*this), std::forward<Fn>(fn));
+    }
+
+    template <typename Pred> constexpr auto filter(Pred && pred)       &  {
+        return _optional_filter(*this, std::forward<Pred>(pred));
+    }
+    template <typename Pred> constexpr auto filter(Pred && pred) const &  {
+        return _optional_filter(*this, std::forward<Pred>(pred));
+    }
+    template <typename Pred> constexpr auto filter(Pred && pred)       && {
+        return _optional_filter(std::move(*this), std::forward<Pred>(pred));
+    }
+    template <typename Pred> constexpr auto filter(Pred && pred) const && {
+        return _optional_filter(std::move(*this), std::forward<Pred>(pred));
+    }
+
+    template <typename Fn> constexpr T value_or_else(Fn && fn)       &  {
+        return _optional_value_or_else<T>(*this, std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr T value_or_else(Fn && fn) const &  {
+        return _optional_value_or_else<T>(*this, std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr T value_or_else(Fn && fn)       && {
+        return _optional_value_or_else<T>(std::move(*this),
+                                          std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr T value_or_else(Fn && fn) const && {
+        return _optional_value_or_else<T>(std::move(*this),
+                                          std::forward<Fn>(fn));
+    }
+
 private:
     /** Helper function; Check the validity of indirecting through `*this`. */
     constexpr inline void _check_value() const {
@@ -1206,6 +1369,82 @@ public:
         return this->_get_reference();
     }
 
+    /** Monadic Operations -- nonstd
+     *  ----------------------------
+     *  As for `optional<T>`, except that the referenced value is always passed
+     *  to `fn` as an lvalue -- there's nothing to move -- and that
+     *  `value_or_else(fn)` returns a reference, so `fn` must as well.
+     */
+    template <typename Fn> constexpr auto and_then(Fn && fn)       &  {
+        return _optional_and_then(*this, std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto and_then(Fn && fn) const &  {
+        return _optional_and_then(*this, std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto and_then(Fn && fn)       && {
+        return _optional_and_then(std::move(*this), std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto and_then(Fn && fn) const && {
+        return _optional_and_then(std::move(*this), std::forward<Fn>(fn));
+    }
+
+    template <typename Fn> constexpr auto transform(Fn && fn)       &  {
+        return _optional_transform(*this, std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto transform(Fn && fn) const &  {
+        return _optional_transform(*this, std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto transform(Fn && fn)       && {
+        return _optional_transform(std::move(*this), std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto transform(Fn && fn) const && {
+        return _optional_transform(std::move(*this), std::forward<Fn>(fn));
+    }
+
+    template <typename Fn> constexpr auto or_else(Fn && fn)       &  {
+        return _optional_or_else(*this, std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto or_else(Fn && fn) const &  {
+        return _optional_or_else(*this, std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto or_else(Fn && fn)       && {
+        return _optional_or_else(std::move(*this), std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr auto or_else(Fn && fn) const && {
+        return _optional_or_else(std::move(*this), std::forward<Fn>(fn));
+    }
+
+    template <typename Pred> constexpr auto filter(Pred && pred)       &  {
+        return _optional_filter(*this, std::forward<Pred>(pred));
+    }
+    template <typename Pred> constexpr auto filter(Pred && pred) const &  {
+        return _optional_filter(*this, std::forward<Pred>(pred));
+    }
+    template <typename Pred> constexpr auto filter(Pred && pred)       && {
+        return _optional_filter(std::move(*this), std::forward<Pred>(pred));
+    }
+    template <typename Pred> constexpr auto filter(Pred && pred) const && {
+        return _optional_filter(std::move(*this), std::forward<Pred>(pred));
+    }
+
+    template <typename Fn> constexpr T & value_or_else(Fn && fn)       &  {
+        return _optional_value_or_else<T &>(*this, std::forward<Fn>(fn));
+    }
+    template <typename Fn>
+    constexpr T const & value_or_else(Fn && fn) const &  {
+        return _optional_value_or_else<T const &>(*this,
+                                                  std::forward<Fn>(fn));
+    }
+    template <typename Fn> constexpr T & value_or_else(Fn && fn)       && {
+        return _optional_value_or_else<T &>(std::move(*this),
+                                            std::forward<Fn>(fn));
+    }
+    template <typename Fn>
+    constexpr T const & value_or_else(Fn && fn) const && {
+        return _optional_value_or_else<T const &>(std::move(*this),
+                                                  std::forward<Fn>(fn));
+    }
+
 private:
     /** Helper function; Check the validity of indirecting through `*this`. */
     constexpr inline void _check_value() const {
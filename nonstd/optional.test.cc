@@ -888,6 +888,129 @@ TEST_CASE("Optional types", "[nonstd][optional]") {
     }
 }
 
+/** MONADIC OPERATIONS
+ *  ==================
+ *  Chains of `and_then`, `transform`, `or_else`, `filter`, and
+ *  `value_or_else` should act only on containing optionals, should move values
+ *  through rvalue chains rather than copying them, and -- over trivial types
+ *  -- should fold away entirely at compile time.
+ */
+namespace monadic {
+
+constexpr optional<i32> half(i32 x) {
+    if (x % 2 != 0) { return { }; }
+    return x / 2;
+}
+constexpr bool is_small(i32 x) { return x < 10; }
+
+static_assert(half(8).and_then(half).and_then(half) == 1);
+static_assert(half(6).and_then(half) == nullopt);
+static_assert(half(8).transform([](i32 x) { return x * 3; }) == 12);
+static_assert(half(3).transform([](i32 x) { return x * 3; }) == nullopt);
+static_assert(half(40).filter(is_small) == nullopt);
+static_assert(half(4).filter(is_small) == 2);
+static_assert(half(3).or_else([] { return optional<i32> { 7 }; }) == 7);
+static_assert(half(4).or_else([] { return optional<i32> { 7 }; }) == 2);
+static_assert(half(3).value_or_else([] { return -1; }) == -1);
+static_assert(half(8).and_then(half)
+                     .transform([](i32 x) { return f32(x) / 4; })
+                     .filter([](f32 x) { return x > 0; })
+                     .value_or_else([] { return 0.f; }) == 0.5f);
+
+constexpr i32 global_value = 5;
+constexpr i32 global_fallback = 9;
+static_assert(just_cref(global_value)
+                  .transform([](i32 const & x) { return x + 1; }) == 6);
+static_assert(&optional<i32 const &> { }
+                  .value_or_else([]() -> i32 const & {
+                      return global_fallback;
+                  }) == &global_fallback);
+
+/* Counts the copies and moves made of it. */
+struct Counted {
+    static inline u32 copies = 0;
+    static inline u32 moves  = 0;
+    i32 value;
+
+    Counted(i32 v) : value ( v ) { }
+    Counted(Counted const & other) : value ( other.value ) { copies += 1; }
+    Counted(Counted && other) noexcept
+        : value ( other.value )
+    { moves += 1; }
+    Counted& operator= (Counted const &) = default;
+    Counted& operator= (Counted &&) = default;
+
+    static void reset() { copies = 0; moves = 0; }
+};
+
+} /* namespace monadic */
+
+TEST_CASE("Optional monadic operations", "[nonstd][optional][monadic]") {
+    using monadic::Counted;
+
+    SECTION("should skip empty optionals") {
+        i32 calls = 0;
+        auto count = [&](i32 x) { calls += 1; return x; };
+        optional<i32> empty { };
+        REQUIRE(empty.transform(count) == nullopt);
+        REQUIRE(empty.and_then([&](i32 x) { return just(count(x)); })
+                == nullopt);
+        REQUIRE(empty.filter([&](i32 x) { return count(x) > 0; }) == nullopt);
+        REQUIRE(calls == 0);
+
+        REQUIRE(empty.or_else([] { return just(3); }) == 3);
+        REQUIRE(empty.value_or_else([] { return 4; }) == 4);
+        REQUIRE(just(1).value_or_else([&] { return count(4); }) == 1);
+        REQUIRE(calls == 0);
+    }
+
+    SECTION("should move values through rvalue chains") {
+        Counted::reset();
+        auto result = optional<Counted> { in_place, 4 }
+            .filter([](Counted const & c) { return c.value > 0; })
+            .transform([](Counted c) { c.value *= 2; return c; })
+            .and_then([](Counted c) { return optional<Counted> {
+                std::move(c) }; })
+            .or_else([] { return optional<Counted> { in_place, 0 }; })
+            .value_or_else([] { return Counted { 0 }; });
+        REQUIRE(result.value == 8);
+        REQUIRE(Counted::copies == 0);
+    }
+
+    SECTION("should copy, and leave the source intact, from lvalues") {
+        Counted::reset();
+        optional<Counted> const source { in_place, 3 };
+        auto const copied = source.transform([](Counted const & c) {
+            return c.value;
+        });
+        auto const kept = source.filter([](Counted const &) { return true; });
+        REQUIRE(copied == 3);
+        REQUIRE(kept->value == 3);
+        REQUIRE(source->value == 3);
+        REQUIRE(Counted::copies == 1);
+    }
+
+    SECTION("should pass references through reference optionals") {
+        i32 value = 1;
+        i32 fallback = 0;
+        optional<i32&> ref { value };
+        optional<i32&> none_ref { };
+
+        ref.transform([](i32 & x) { x += 1; return x; });
+        REQUIRE(value == 2);
+        REQUIRE(&ref.filter([](i32 x) { return x == 2; }).value() == &value);
+        REQUIRE(none_ref.or_else([&] { return just_ref(fallback); })
+                    .has_value());
+        REQUIRE(&none_ref.value_or_else([&]() -> i32 & { return fallback; })
+                == &fallback);
+        REQUIRE(&ref.value_or_else([&]() -> i32 & { return fallback; })
+                == &value);
+        REQUIRE(ref.and_then([](i32 & x) { return just_cref(x); })
+                   .transform([](i32 const & x) { return x * 10; }) == 20);
+    }
+}
+
+
 #include "optional.test.compare_overloads.inl"
 #include "optional.test.disabled_special_members.inl"
 
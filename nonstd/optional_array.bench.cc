@@ -0,0 +1,81 @@
+/** Optional Array Benchmarks
+ *  =========================
+ *  Counts and sums the present elements of a sparse (10% present)
+ *  `optional_array<u32>`, and of the equivalent `std::vector<optional<u32>>`.
+ */
+
+#include <nonstd/optional_array.h>
+#include <nonstd/benchmark.h>
+
+#include <vector>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/optional.h>
+
+
+namespace nonstd_bench::optional_array {
+
+using nonstd::optional_array;
+
+NOINLINE u64 sum_present(std::vector<nonstd::optional<u32>> const & values) {
+    u64 sum = 0;
+    for (auto const & value : values) {
+        if (value) { sum += *value; }
+    }
+    return sum;
+}
+NOINLINE u64 sum_present(optional_array<u32> const & values) {
+    u64 sum = 0;
+    values.for_each_present([&](u64, u32 value) { sum += value; });
+    return sum;
+}
+
+NOINLINE u64 count_present(std::vector<nonstd::optional<u32>> const & values) {
+    u64 count = 0;
+    for (auto const & value : values) { count += value.has_value(); }
+    return count;
+}
+NOINLINE u64 count_present(optional_array<u32> const & values) {
+    return values.count_present();
+}
+
+
+NONSTD_BENCHMARK("optional_array scans") {
+    u64 const count = 1 << 20;
+
+    std::vector<nonstd::optional<u32>> flagged (count);
+    optional_array<u32> columnar { count };
+    for (u64 i = 0; i < count; ++i) {
+        if ((i * 2654435761u) % 100 < 10) {
+            flagged[i] = u32(i % 100);
+            columnar.emplace(i, u32(i % 100));
+        }
+    }
+
+    // The arrays are passed through `do_not_optimize`, s.t. the scans can't
+    // be hoisted out of the loop.
+    auto scan = [&](auto & values, auto fn) {
+        return [&values, fn] {
+            nonstd::do_not_optimize(values);
+            nonstd::do_not_optimize(fn(values));
+        };
+    };
+    auto sum = [](auto const & values) { return sum_present(values); };
+    auto counted = [](auto const & values) { return count_present(values); };
+    auto const & vector_sum = bench.run("sum, vector<optional<u32>>",
+                                        scan(flagged, sum), count);
+    auto const & array_sum = bench.run("sum, optional_array<u32>",
+                                       scan(columnar, sum), count);
+    auto const & vector_count = bench.run("count, vector<optional<u32>>",
+                                          scan(flagged, counted), count);
+    auto const & array_count = bench.run("count, optional_array<u32>",
+                                         scan(columnar, counted), count);
+    bench.expect_speedup(vector_sum, array_sum, 2.0,
+        "optional_array.h: skipping absent words sums sparse arrays faster "
+        "than a vector of optionals");
+    bench.expect_speedup(vector_count, array_count, 2.0,
+        "optional_array.h: counting present elements from the bitmap beats "
+        "testing each optional");
+}
+
+} /* namespace nonstd_bench::optional_array */
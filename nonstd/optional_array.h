@@ -0,0 +1,432 @@
+/** Optional Array
+ *  ==============
+ *  A fixed-length array of maybe-values, stored in columns. An
+ *  `std::vector<optional<T>>` interleaves a flag (plus padding) with every
+ *  payload; scanning it for present values touches every byte of both, and the
+ *  mix of flags and payloads defeats vectorization. An `optional_array<T>`
+ *  keeps the payloads packed in one allocation, and their presence in a
+ *  separate bitmap of 64-bit words;
+ *
+ *      nonstd::optional_array<velocity> velocities { entity_count };
+ *      velocities.emplace(id, 0.f, 1.f);
+ *      if (auto v = velocities[id]) { v->y -= gravity; }  // optional<T&>
+ *      for (auto [id, v] : velocities) { ... }            // present elements
+ *      u64 moving = velocities.count_present();
+ *
+ *  Elements are accessed as `optional<T&>`s. Iterating an `optional_array`
+ *  visits only its present elements, in index order, as `{ index, value }`
+ *  pairs; whole 64-element words of absent elements are skipped at once, and
+ *  present ones are found by counting trailing zeros. `for_each_present(fn)`
+ *  does the same with a plain loop, which optimizes somewhat better.
+ *
+ *  Payloads are constructed and destroyed as elements are set and reset, so
+ *  `T` need not be default constructible. `fill` and `reset` over a range
+ *  update the bitmap a word at a time, and if `T` is trivially destructible,
+ *  clearing a range never touches the payloads at all.
+ *
+ *  The raw columns are available -- `data()` and `words()` -- for scans that
+ *  want to vectorize over them directly. Absent payloads are uninitialized.
+ */
+
+#pragma once
+
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/math.h>
+#include <nonstd/optional.h>
+
+
+namespace nonstd {
+
+template <typename T>
+class optional_array {
+    static_assert(!std::is_reference_v<T>,
+        "optional_arrays can't hold references; use an optional_array<T*>.");
+
+public:
+    using value_type = T;
+    using word_type  = u64;
+    static constexpr u64 word_bits = 64;
+
+    /** A present element; its index, and a reference to its value. */
+    template <typename Value>
+    struct basic_item {
+        u64     index;
+        Value & value;
+    };
+    using item       = basic_item<T>;
+    using const_item = basic_item<T const>;
+
+private:
+    u64                          m_size;
+    std::unique_ptr<word_type[]> m_words;
+    T *                          m_data;
+
+public:
+    /** Construction and Assignment
+     *  ---------------------------
+     */
+    optional_array() noexcept
+        : m_size  ( 0 )
+        , m_words ( )
+        , m_data  ( nullptr )
+    { }
+
+    /** Construct `size` absent elements. */
+    explicit optional_array(u64 size)
+        : m_size  ( size )
+        , m_words ( new word_type[_word_count(size)]() )
+        , m_data  ( _allocate(size) )
+    { }
+
+    optional_array(optional_array const & other)
+        : optional_array ( other.m_size )
+    {
+        other.for_each_present([&](u64 i, T const & value) {
+            emplace(i, value);
+        });
+    }
+    optional_array(optional_array && other) noexcept
+        : m_size  ( std::exchange(other.m_size, 0) )
+        , m_words ( std::move(other.m_words) )
+        , m_data  ( std::exchange(other.m_data, nullptr) )
+    { }
+
+    optional_array& operator= (optional_array const & other) {
+        if (this != &other) { *this = optional_array { other }; }
+        return *this;
+    }
+    optional_array& operator= (optional_array && other) noexcept {
+        if (this != &other) {
+            _release();
+            m_size  = std::exchange(other.m_size, 0);
+            m_words = std::move(other.m_words);
+            m_data  = std::exchange(other.m_data, nullptr);
+        }
+        return *this;
+    }
+
+    ~optional_array() { _release(); }
+
+
+    /** Capacity
+     *  --------
+     */
+    u64  size()       const noexcept { return m_size; }
+    bool empty()      const noexcept { return m_size == 0; }
+    u64  word_count() const noexcept { return _word_count(m_size); }
+
+
+    /** Element Access
+     *  --------------
+     */
+    bool has_value(u64 index) const noexcept {
+        ASSERT(index < m_size);
+        return (m_words[index / word_bits] >> (index % word_bits)) & 1;
+    }
+
+    optional<T &> operator[] (u64 index) noexcept {
+        if (!has_value(index)) { return { }; }
+        return optional<T &> { m_data[index] };
+    }
+    optional<T const &> operator[] (u64 index) const noexcept {
+        if (!has_value(index)) { return { }; }
+        return optional<T const &> { m_data[index] };
+    }
+
+    /** The payload column, and the presence bitmap; bit `i % 64` of word
+     *  `i / 64` is set iff element `i` is present. Bits past `size()` are
+     *  always clear.
+     */
+    T         * data()        noexcept { return m_data; }
+    T const   * data()  const noexcept { return m_data; }
+    u64 const * words() const noexcept { return m_words.get(); }
+
+
+    /** Modifiers
+     *  ---------
+     */
+    /** Construct element `index` from `args`, replacing any existing value. */
+    template <typename ... Args>
+    T& emplace(u64 index, Args && ... args) {
+        reset(index);
+        ::new (static_cast<void *>(m_data + index))
+            T ( std::forward<Args>(args)... );
+        m_words[index / word_bits] |= _bit(index);
+        return m_data[index];
+    }
+
+    /** Make element `index` absent. */
+    void reset(u64 index) noexcept {
+        if (!has_value(index)) { return; }
+        std::destroy_at(m_data + index);
+        m_words[index / word_bits] &= ~_bit(index);
+    }
+
+    /** Make the elements in [first, last) absent. */
+    void reset(u64 first, u64 last) noexcept {
+        ASSERT(first <= last && last <= m_size);
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            _for_each_present(first, last, [&](u64 i) {
+                std::destroy_at(m_data + i);
+            });
+        }
+        _update_words(first, last, [](word_type & word, word_type mask) {
+            word &= ~mask;
+        });
+    }
+
+    /** Make every element absent. */
+    void reset() noexcept { reset(0, m_size); }
+
+    /** Set each element in [first, last) to a copy of `value`. */
+    void fill(u64 first, u64 last, T const & value) {
+        ASSERT(first <= last && last <= m_size);
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            std::uninitialized_fill(m_data + first, m_data + last, value);
+            _update_words(first, last, [](word_type & word, word_type mask) {
+                word |= mask;
+            });
+        } else {
+            for (u64 i = first; i < last; ++i) {
+                if (has_value(i)) { m_data[i] = value; }
+                else              { emplace(i, value); }
+            }
+        }
+    }
+
+
+    /** Queries and Iteration
+     *  ---------------------
+     */
+    /** The number of present elements. */
+    u64 count_present() const noexcept {
+        return _count_bits(m_words.get(), word_count());
+    }
+
+    /** Call `fn(index, value)` for each present element, in index order. */
+    template <typename Fn>
+    void for_each_present(Fn && fn) {
+        _for_each_present(0, m_size, [&](u64 i) { fn(i, m_data[i]); });
+    }
+    template <typename Fn>
+    void for_each_present(Fn && fn) const {
+        _for_each_present(0, m_size, [&](u64 i) {
+            fn(i, static_cast<T const &>(m_data[i]));
+        });
+    }
+
+    template <typename Array, typename Value>
+    class basic_iterator;
+    using iterator       = basic_iterator<optional_array, T>;
+    using const_iterator = basic_iterator<optional_array const, T const>;
+
+    iterator       begin()        noexcept { return { this, 0 }; }
+    const_iterator begin()  const noexcept { return { this, 0 }; }
+    iterator       end()          noexcept { return { this, word_count() }; }
+    const_iterator end()    const noexcept { return { this, word_count() }; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend()   const noexcept { return end(); }
+
+private:
+    static constexpr u64 _word_count(u64 size) noexcept {
+        return (size + word_bits - 1) / word_bits;
+    }
+    static constexpr word_type _bit(u64 index) noexcept {
+        return word_type{1} << (index % word_bits);
+    }
+
+    static T * _allocate(u64 size) {
+        if (size == 0) { return nullptr; }
+        return std::allocator<T> { }.allocate(size);
+    }
+
+    void _release() noexcept {
+        if (m_data == nullptr) { return; }
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            _for_each_present(0, m_size, [&](u64 i) {
+                std::destroy_at(m_data + i);
+            });
+        }
+        std::allocator<T> { }.deallocate(m_data, m_size);
+        m_data = nullptr;
+        m_words.reset();
+        m_size = 0;
+    }
+
+    /** Call `fn(word, mask)` for each word overlapping [first, last), with
+     *  `mask` selecting the bits in range.
+     */
+    template <typename Fn>
+    void _update_words(u64 first, u64 last, Fn && fn) noexcept {
+        if (first == last) { return; }
+        u64 const first_word = first / word_bits;
+        u64 const last_word  = (last - 1) / word_bits;
+        word_type const head = ~word_type{0} << (first % word_bits);
+        word_type const tail = ~word_type{0} >> (word_bits - 1
+                                                 - (last - 1) % word_bits);
+        if (first_word == last_word) {
+            fn(m_words[first_word], head & tail);
+            return;
+        }
+        fn(m_words[first_word], head);
+        for (u64 w = first_word + 1; w < last_word; ++w) {
+            fn(m_words[w], ~word_type{0});
+        }
+        fn(m_words[last_word], tail);
+    }
+
+    /** Call `fn(index)` for each present element in [first, last). */
+    template <typename Fn>
+    void _for_each_present(u64 first, u64 last, Fn && fn) const {
+        if (first == last) { return; }
+        u64 const last_word = (last - 1) / word_bits;
+        for (u64 w = first / word_bits; w <= last_word; ++w) {
+            word_type bits = m_words[w];
+            if (w == first / word_bits) {
+                bits &= ~word_type{0} << (first % word_bits);
+            }
+            if (w == last_word) {
+                bits &= ~word_type{0} >> (word_bits - 1
+                                          - (last - 1) % word_bits);
+            }
+            while (bits != 0) {
+                fn(w * word_bits + count_trailing_zeros(bits));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    /** Count the set bits of `count` words. Where there's a popcount
+     *  instruction, this sums it over four independent accumulators. Where
+     *  there isn't (e.g. baseline x86-64 builds, where the builtin is a
+     *  library call) this counts bits in parallel within each word, summing
+     *  per-byte counts across blocks of words -- which the compiler can
+     *  vectorize -- and only folding the bytes together once per block.
+     */
+    static u64 _count_bits(word_type const * words, u64 count) noexcept {
+        u64 i = 0;
+#if defined(__POPCNT__) || defined(NONSTD_COMPILER_MSVC)
+        u64 sums[4] = { 0, 0, 0, 0 };
+        for (; i + 4 <= count; i += 4) {
+            sums[0] += popcount(words[i + 0]);
+            sums[1] += popcount(words[i + 1]);
+            sums[2] += popcount(words[i + 2]);
+            sums[3] += popcount(words[i + 3]);
+        }
+        u64 total = sums[0] + sums[1] + sums[2] + sums[3];
+#else
+        constexpr u64 ones_01 = 0x0101010101010101ull;
+        constexpr u64 ones_16 = 0x0001000100010001ull;
+        auto byte_counts = [](u64 x) {
+            x = x - ((x >> 1) & (ones_01 * 0x55));
+            x = (x & (ones_01 * 0x33)) + ((x >> 2) & (ones_01 * 0x33));
+            return (x + (x >> 4)) & (ones_01 * 0x0f);
+        };
+        // Each byte counts at most 8 bits per word, so 16 words can be summed
+        // bytewise (to at most 128) before they'd overflow.
+        u64 total = 0;
+        for (; i + 16 <= count; i += 16) {
+            u64 bytes = 0;
+            for (u64 j = 0; j < 16; ++j) { bytes += byte_counts(words[i + j]); }
+            u64 const shorts = (bytes & (ones_16 * 0xff))
+                             + ((bytes >> 8) & (ones_16 * 0xff));
+            total += (shorts * ones_16) >> 48;
+        }
+#endif
+        for (; i < count; ++i) { total += popcount(words[i]); }
+        return total;
+    }
+};
+
+
+/** Present-Element Iterator
+ *  ------------------------
+ *  A forward iterator over the present elements of an `optional_array`. It
+ *  holds the unvisited bits of the current word; advancing clears the lowest
+ *  one, and moves to the next non-zero word once they're exhausted.
+ */
+template <typename T>
+template <typename Array, typename Value>
+class optional_array<T>::basic_iterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = basic_item<Value>;
+    using difference_type   = ptrdiff;
+    using pointer           = void;
+    using reference         = basic_item<Value>;
+
+private:
+    Array *   m_array;
+    u64       m_word;
+    word_type m_bits;
+
+public:
+    basic_iterator() noexcept
+        : m_array ( nullptr )
+        , m_word  ( 0 )
+        , m_bits  ( 0 )
+    { }
+    basic_iterator(Array * array, u64 word) noexcept
+        : m_array ( array )
+        , m_word  ( word )
+        , m_bits  ( word < array->word_count() ? array->words()[word] : 0 )
+    {
+        _skip_empty_words();
+    }
+
+    /** Convert a mutable iterator to a const one. */
+    template < typename OtherArray, typename OtherValue
+             , typename = std::enable_if_t<
+                   std::is_same_v<Value, T const>
+                && std::is_same_v<OtherValue, T> > >
+    basic_iterator(basic_iterator<OtherArray, OtherValue> const & other)
+    noexcept
+        : m_array ( other.m_array )
+        , m_word  ( other.m_word )
+        , m_bits  ( other.m_bits )
+    { }
+
+    reference operator* () const noexcept {
+        u64 const index = m_word * word_bits + count_trailing_zeros(m_bits);
+        return { index, m_array->data()[index] };
+    }
+
+    basic_iterator& operator++ () noexcept {
+        m_bits &= m_bits - 1;
+        _skip_empty_words();
+        return *this;
+    }
+    basic_iterator operator++ (int) noexcept {
+        auto const result = *this;
+        ++(*this);
+        return result;
+    }
+
+    friend bool operator== (basic_iterator const & lhs,
+                            basic_iterator const & rhs) noexcept {
+        return lhs.m_word == rhs.m_word && lhs.m_bits == rhs.m_bits;
+    }
+    friend bool operator!= (basic_iterator const & lhs,
+                            basic_iterator const & rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+private:
+    template <typename, typename> friend class basic_iterator;
+
+    void _skip_empty_words() noexcept {
+        u64 const word_count = m_array->word_count();
+        while (m_bits == 0 && m_word < word_count) {
+            m_word += 1;
+            m_bits = m_word < word_count ? m_array->words()[m_word] : 0;
+        }
+    }
+};
+
+} /* namespace nonstd */
@@ -0,0 +1,170 @@
+/** Optional Array Tests
+ *  ====================
+ *  GOAL: Validate that optional arrays track the presence of each element
+ *  across word boundaries, that they construct and destroy exactly the
+ *  elements that are present, and that iterating and counting them sees only
+ *  present elements.
+ */
+
+#include <nonstd/optional_array.h>
+#include <platform/testrunner/testrunner.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+
+
+namespace nonstd_test::optional_array {
+
+using nonstd::optional_array;
+
+/** The indices of present elements, found by testing each one. */
+template <typename T>
+std::vector<u64> present_indices(optional_array<T> const & array) {
+    std::vector<u64> result;
+    for (u64 i = 0; i < array.size(); ++i) {
+        if (array.has_value(i)) { result.push_back(i); }
+    }
+    return result;
+}
+
+/** Counts its live instances. */
+struct Tracked {
+    static inline i32 live = 0;
+    std::string name;
+
+    explicit Tracked(std::string n) : name ( std::move(n) ) { live += 1; }
+    Tracked(Tracked const & other) : name ( other.name ) { live += 1; }
+    Tracked& operator= (Tracked const &) = default;
+    ~Tracked() { live -= 1; }
+};
+
+
+TEST_CASE("Optional Arrays", "[nonstd][optional][optional_array]") {
+    SECTION("start with every element absent") {
+        optional_array<u32> array { 130 };
+        REQUIRE(array.size() == 130);
+        REQUIRE(array.word_count() == 3);
+        REQUIRE(array.count_present() == 0);
+        REQUIRE_FALSE(array[0].has_value());
+        REQUIRE_FALSE(array[129].has_value());
+        REQUIRE(array.begin() == array.end());
+    }
+
+    SECTION("access elements as optional references") {
+        optional_array<u32> array { 100 };
+        array.emplace(64, 7u);
+        REQUIRE(*array[64] == 7u);
+        REQUIRE(array.has_value(64));
+        REQUIRE_FALSE(array.has_value(63));
+
+        if (auto value = array[64]) { *value += 1; }
+        REQUIRE(array.data()[64] == 8u);
+        REQUIRE(array.words()[1] == 1u);
+
+        auto const & view = array;
+        REQUIRE(view[64].transform([](u32 x) { return x * 2; }) == 16u);
+        array.reset(64);
+        REQUIRE(array[64] == nonstd::nullopt);
+        REQUIRE(array.count_present() == 0);
+    }
+
+    SECTION("visit only present elements, in order") {
+        optional_array<i32> array { 300 };
+        std::vector<u64> const indices { 0, 1, 63, 64, 65, 190, 299 };
+        for (u64 i : indices) { array.emplace(i, i32(i) * 10); }
+
+        std::vector<u64> visited;
+        for (auto [index, value] : array) {
+            REQUIRE(value == i32(index) * 10);
+            visited.push_back(index);
+        }
+        REQUIRE(visited == indices);
+
+        visited.clear();
+        std::as_const(array).for_each_present([&](u64 i, i32 const & value) {
+            REQUIRE(value == i32(i) * 10);
+            visited.push_back(i);
+        });
+        REQUIRE(visited == indices);
+        REQUIRE(array.count_present() == indices.size());
+
+        for (auto item : array) { item.value = -1; }
+        REQUIRE(*array[190] == -1);
+    }
+
+    SECTION("fill and reset ranges across word boundaries") {
+        optional_array<u16> array { 1000 };
+        std::vector<bool> expected (1000, false);
+        auto apply = [&](u64 first, u64 last, bool set) {
+            if (set) { array.fill(first, last, u16(first)); }
+            else     { array.reset(first, last); }
+            for (u64 i = first; i < last; ++i) { expected[i] = set; }
+        };
+        apply(3, 900, true);
+        apply(64, 128, false);
+        apply(10, 12, false);
+        apply(130, 131, false);
+        apply(500, 500, false);
+        apply(960, 1000, true);
+        apply(200, 263, false);
+
+        u64 count = 0;
+        for (u64 i = 0; i < 1000; ++i) {
+            REQUIRE(array.has_value(i) == expected[i]);
+            count += expected[i];
+        }
+        REQUIRE(array.count_present() == count);
+        REQUIRE(array[2] == nonstd::nullopt);
+        REQUIRE(*array[3] == 3);
+        REQUIRE(*array[999] == 960);
+
+        array.reset();
+        REQUIRE(array.count_present() == 0);
+        REQUIRE(present_indices(array).empty());
+    }
+
+    SECTION("count present elements over many words") {
+        for (u64 size : { 1u, 64u, 1000u, 1024u, 1088u, 5000u }) {
+            optional_array<u8> array { size };
+            u64 count = 0;
+            for (u64 i = 0; i < size; i += 1 + i % 7) {
+                array.emplace(i, u8(1));
+                count += 1;
+            }
+            REQUIRE(array.count_present() == count);
+            REQUIRE(present_indices(array).size() == count);
+        }
+    }
+
+    SECTION("construct, copy, and destroy only present elements") {
+        {
+            optional_array<Tracked> array { 200 };
+            array.emplace(5, "five");
+            array.emplace(150, "one-fifty");
+            array.emplace(150, "replaced");
+            REQUIRE(Tracked::live == 2);
+
+            optional_array<Tracked> copy { array };
+            REQUIRE(Tracked::live == 4);
+            REQUIRE(copy[150]->name == "replaced");
+
+            array.fill(100, 103, Tracked { "filled" });
+            REQUIRE(Tracked::live == 7);
+            array.reset(0, 101);
+            REQUIRE(Tracked::live == 5);
+            REQUIRE(present_indices(array) == std::vector<u64> { 101, 102,
+                                                                  150 });
+
+            optional_array<Tracked> moved { std::move(copy) };
+            REQUIRE(moved[5]->name == "five");
+            copy = moved;
+            REQUIRE(Tracked::live == 7);
+        }
+        REQUIRE(Tracked::live == 0);
+    }
+}
+
+} /* namespace nonstd_test::optional_array */
@@ -0,0 +1,316 @@
+/** Parallel Loops over Ranges
+ *  ==========================
+ *  `parallel_for` and `parallel_reduce` split a `nonstd::range` into chunks of
+ *  contiguous indices and run those chunks as jobs on a `job_system`.
+ *
+ *      nonstd::parallel_for(nonstd::range(0, N, 4), [&](i32 i) { ... });
+ *      auto sum = nonstd::parallel_reduce(nonstd::range(N), u64{0},
+ *          [&](u64 acc, i32 i) { return acc + values[i]; },
+ *          [](u64 a, u64 b) { return a + b; });
+ *
+ *  Ranges are never walked with their iterators. The trip count is computed up
+ *  front, each chunk is a `[lo, hi)` run of indices, and the value at an index
+ *  is `begin + index * step`. (NB. For floating point ranges that can differ
+ *  from a serial walk -- which accumulates `step` -- in the last few bits.)
+ *
+ *  The way indices are handed out is controlled by a `partition`;
+ *   - `schedule::static_` gives each job one equal, contiguous block. Cheapest,
+ *     and best when every iteration costs about the same.
+ *   - `schedule::dynamic` has jobs repeatedly claim `grain` indices from a
+ *     shared atomic cursor. Balances uneven iterations at the cost of one
+ *     atomic per chunk.
+ *   - `schedule::guided` is dynamic, but claims chunks proportional to the
+ *     remaining work (never smaller than `grain`), so early chunks are large
+ *     and late chunks fill in the gaps.
+ *  A `grain` of 0 picks a size based on the trip count and worker count.
+ *
+ *  `parallel_for` also takes a `range2d`/`range3d` (see range_nd.h), and runs
+ *  its tiles as the chunks.
+ *
+ *  Loops run with fewer than two chunks' worth of work execute inline on the
+ *  calling thread. Called from inside a job, the caller's fiber is parked while
+ *  the loop runs, so parallel loops nest. Loop bodies must not throw.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/job_system.h>
+#include <nonstd/range_nd.h>
+
+
+namespace nonstd {
+
+enum class schedule {
+    static_,
+    dynamic,
+    guided,
+};
+
+struct partition {
+    nonstd::schedule schedule = nonstd::schedule::static_;
+    u64              grain    = 0;
+};
+
+
+/** Default Job System
+ *  ------------------
+ *  Used by the parallel algorithms when no `job_system` is given. Spun up on
+ *  first use, with the default configuration.
+ */
+inline job_system & default_job_system() {
+    static job_system instance { };
+    return instance;
+}
+
+
+namespace detail::parallel_ {
+
+/** Hands out `[lo, hi)` chunks of `[0, count)` according to a `schedule`. */
+class chunker {
+private:
+    u64              m_count;
+    u64              m_grain;
+    u64              m_jobs;
+    nonstd::schedule m_schedule;
+    ALIGNAS(cache_line_size) std::atomic<u64> m_cursor;
+
+public:
+    chunker(u64 count, u64 jobs, partition part) noexcept
+        : m_count    ( count )
+        , m_grain    ( n2max(part.grain, u64{1}) )
+        , m_jobs     ( jobs )
+        , m_schedule ( part.schedule )
+        , m_cursor   ( 0 )
+    { }
+
+    u64 count() const noexcept { return m_count; }
+
+    /** Claim the next chunk. `claimed_static` is per-job state; a job gets
+     *  exactly one chunk under `schedule::static_`.
+     */
+    bool next(u64 & lo, u64 & hi, bool & claimed_static) noexcept {
+        switch (m_schedule) {
+        case nonstd::schedule::static_: {
+            if (claimed_static) { return false; }
+            claimed_static = true;
+            u64 const job = m_cursor.fetch_add(1, std::memory_order_relaxed);
+            if (job >= m_jobs) { return false; }
+            lo = (m_count * job) / m_jobs;
+            hi = (m_count * (job + 1)) / m_jobs;
+            return lo < hi;
+        }
+        case nonstd::schedule::dynamic: {
+            lo = m_cursor.fetch_add(m_grain, std::memory_order_relaxed);
+            if (lo >= m_count) { return false; }
+            hi = n2min(lo + m_grain, m_count);
+            return true;
+        }
+        case nonstd::schedule::guided: {
+            u64 cursor = m_cursor.load(std::memory_order_relaxed);
+            while (cursor < m_count) {
+                u64 const remaining = m_count - cursor;
+                u64 const size = n2min(n2max(remaining / (2 * m_jobs), m_grain),
+                                       remaining);
+                if (m_cursor.compare_exchange_weak(cursor, cursor + size,
+                                                   std::memory_order_relaxed)) {
+                    lo = cursor;
+                    hi = cursor + size;
+                    return true;
+                }
+            }
+            return false;
+        }
+        }
+        return false;
+    }
+};
+
+/** Pick a grain and a job count for `count` iterations. */
+inline std::pair<partition, u64> plan(u64 count, u32 workers,
+                                      partition part) noexcept {
+    u64 const w = n2max(u64{workers}, u64{1});
+    if (part.grain == 0) {
+        switch (part.schedule) {
+        case schedule::static_: part.grain = (count + w - 1) / w; break;
+        case schedule::dynamic: part.grain = count / (w *  8);     break;
+        case schedule::guided:  part.grain = count / (w * 32);     break;
+        }
+        part.grain = n2max(part.grain, u64{1});
+    }
+    u64 const chunks = (count + part.grain - 1) / part.grain;
+    return { part, n2min(chunks, w) };
+}
+
+/** Run `body(lo, hi)` over every chunk of `[0, count)`. */
+template <typename Body>
+void run_chunked(job_system & jobs, u64 count, partition part, Body & body) {
+    if (count == 0) { return; }
+    auto const [planned, job_count] = plan(count, jobs.worker_count(), part);
+    if (job_count < 2) {
+        body(u64{0}, count, u64{0});
+        return;
+    }
+
+    struct context {
+        chunker          chunks;
+        Body &           body;
+        std::atomic<u64> next_slot;
+    } ctx { chunker { count, job_count, planned }, body, { 0 } };
+
+    auto entry = [](void * data) {
+        auto & ctx = *static_cast<context *>(data);
+        u64 const slot = ctx.next_slot.fetch_add(1, std::memory_order_relaxed);
+        bool claimed_static = false;
+        u64 lo = 0;
+        u64 hi = 0;
+        while (ctx.chunks.next(lo, hi, claimed_static)) {
+            ctx.body(lo, hi, slot);
+        }
+    };
+
+    job_counter counter;
+    job_decl const decl { entry, &ctx };
+    for (u64 i = 0; i < job_count; ++i) {
+        jobs.run_job(decl, &counter);
+    }
+    jobs.wait_for_counter(counter);
+}
+
+/** A reduction's accumulator over the contiguous indices `[lo, hi)`. */
+template <typename T>
+struct run {
+    u64 lo;
+    u64 hi;
+    T   value;
+};
+
+/** Padded per-job accumulators for reductions; one per run of contiguous
+ *  chunks the job claimed, in the order it claimed them.
+ */
+template <typename T>
+struct ALIGNAS(cache_line_size) partial {
+    std::vector<run<T>> runs;
+};
+
+} /* namespace detail::parallel_ */
+
+
+/** Parallel For
+ *  ------------
+ *  Call `fn(value)` for every value in `r`. Calls are unordered.
+ */
+template <typename T, typename Fn>
+void parallel_for(job_system & jobs, range_t<T> const & r, Fn && fn,
+                  partition part = partition { }) {
+    T const first = r.first();
+    T const step  = r.step();
+    auto body = [&fn, first, step](u64 lo, u64 hi, u64 /*slot*/) {
+        for (u64 i = lo; i < hi; ++i) {
+            fn(static_cast<T>(first + static_cast<T>(i) * step));
+        }
+    };
+    detail::parallel_::run_chunked(jobs, r.size(), part, body);
+}
+
+template <typename T, typename Fn>
+void parallel_for(range_t<T> const & r, Fn && fn,
+                  partition part = partition { }) {
+    parallel_for(default_job_system(), r, std::forward<Fn>(fn), part);
+}
+
+
+/** Parallel For over Tiles
+ *  -----------------------
+ *  Call `fn(x, y[, z])` for every value in `r`, running its tiles as jobs.
+ *  Within a tile values are visited in the range's traversal order; untiled
+ *  ranges are split into rows (2D) or planes (3D).
+ */
+template <typename T, size_t N, typename Fn>
+void parallel_for(job_system & jobs, range_nd_t<T, N> const & r, Fn && fn,
+                  partition part = partition { }) {
+    auto const tiles = r.tile_count() > 1 ? r : r.slices();
+    auto body = [&fn, &tiles](u64 lo, u64 hi, u64 /*slot*/) {
+        for (u64 i = lo; i < hi; ++i) { tiles.tile(i).for_each(fn); }
+    };
+    detail::parallel_::run_chunked(jobs, tiles.tile_count(), part, body);
+}
+
+template <typename T, size_t N, typename Fn>
+void parallel_for(range_nd_t<T, N> const & r, Fn && fn,
+                  partition part = partition { }) {
+    parallel_for(default_job_system(), r, std::forward<Fn>(fn), part);
+}
+
+
+/** Parallel Reduce
+ *  ---------------
+ *  Fold every value of `r` into a copy of `identity` with `accumulate(acc,
+ *  value) -> Acc`, then combine the partial accumulators with `combine(Acc,
+ *  Acc) -> Acc`. Each partial covers a contiguous run of indices, and they're
+ *  combined in index order, so `combine` must be associative but needn't be
+ *  commutative; `identity` must be its identity element.
+ *
+ *  A job accumulates each run of adjacent chunks it claims into one partial,
+ *  so `schedule::static_` makes one partial per job, and the dynamic schedules
+ *  at most one per chunk.
+ */
+template <typename T, typename Acc, typename AccumulateFn, typename CombineFn>
+Acc parallel_reduce(job_system & jobs, range_t<T> const & r, Acc identity,
+                    AccumulateFn && accumulate, CombineFn && combine,
+                    partition part = partition { }) {
+    u64 const count = r.size();
+    auto const job_count = detail::parallel_::plan(count, jobs.worker_count(),
+                                                   part).second;
+
+    using partial_t = detail::parallel_::partial<Acc>;
+    using run_t     = detail::parallel_::run<Acc>;
+    auto partials = std::make_unique<partial_t[]>(n2max(job_count, u64{1}));
+
+    T const first = r.first();
+    T const step  = r.step();
+    auto body = [&](u64 lo, u64 hi, u64 slot) {
+        auto & runs = partials[slot].runs;
+        if (runs.empty() || runs.back().hi != lo) {
+            runs.push_back(run_t { lo, lo, identity });
+        }
+        auto & current = runs.back();
+        for (u64 i = lo; i < hi; ++i) {
+            current.value = accumulate(std::move(current.value),
+                static_cast<T>(first + static_cast<T>(i) * step));
+        }
+        current.hi = hi;
+    };
+    detail::parallel_::run_chunked(jobs, count, part, body);
+
+    std::vector<run_t *> ordered;
+    for (u64 i = 0; i < n2max(job_count, u64{1}); ++i) {
+        for (auto & each : partials[i].runs) { ordered.push_back(&each); }
+    }
+    std::sort(ordered.begin(), ordered.end(),
+              [](run_t const * a, run_t const * b) { return a->lo < b->lo; });
+
+    Acc result = std::move(identity);
+    for (run_t * each : ordered) {
+        result = combine(std::move(result), std::move(each->value));
+    }
+    return result;
+}
+
+template <typename T, typename Acc, typename AccumulateFn, typename CombineFn>
+Acc parallel_reduce(range_t<T> const & r, Acc identity,
+                    AccumulateFn && accumulate, CombineFn && combine,
+                    partition part = partition { }) {
+    return parallel_reduce(default_job_system(), r, std::move(identity),
+                           std::forward<AccumulateFn>(accumulate),
+                           std::forward<CombineFn>(combine), part);
+}
+
+} /* namespace nonstd */
@@ -0,0 +1,138 @@
+/** Parallel Loop Tests
+ *  ===================
+ *  GOAL: Validate that every schedule visits every value of a range exactly
+ *  once, and that reductions match their serial equivalents.
+ */
+
+#include <nonstd/parallel.h>
+#include <platform/testrunner/testrunner.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+
+
+namespace nonstd_test::parallel {
+
+using nonstd::job_system;
+using nonstd::parallel_for;
+using nonstd::parallel_reduce;
+using nonstd::partition;
+using nonstd::range;
+using nonstd::schedule;
+
+
+TEST_CASE("Parallel Loops", "[nonstd][parallel]") {
+    job_system::config cfg;
+    cfg.worker_count = 4;
+    cfg.fiber_count  = 32;
+    job_system jobs { cfg };
+
+    auto const partitions = std::vector<partition> {
+        { schedule::static_, 0 },
+        { schedule::static_, 7 },
+        { schedule::dynamic, 0 },
+        { schedule::dynamic, 3 },
+        { schedule::guided,  0 },
+        { schedule::guided,  5 },
+    };
+
+    SECTION("visits every value exactly once") {
+        for (auto const & part : partitions) {
+            std::vector<std::atomic<i32>> hits (1000);
+            parallel_for(jobs, range(0, 1000), [&](i32 i) {
+                hits[i].fetch_add(1, std::memory_order_relaxed);
+            }, part);
+
+            i32 wrong = 0;
+            for (auto const & h : hits) { wrong += (h.load() != 1); }
+            REQUIRE(wrong == 0);
+        }
+    }
+
+    SECTION("honors the range's bounds and step") {
+        std::vector<std::atomic<i32>> hits (100);
+        parallel_for(jobs, range(3, 97, 5), [&](i32 i) {
+            hits[i].fetch_add(1, std::memory_order_relaxed);
+        }, partition { schedule::dynamic, 2 });
+
+        for (i32 i = 0; i < 100; ++i) {
+            bool const expected = (i >= 3 && i < 97 && (i - 3) % 5 == 0);
+            REQUIRE(hits[i].load() == (expected ? 1 : 0));
+        }
+    }
+
+    SECTION("does nothing for empty ranges") {
+        std::atomic<i32> calls { 0 };
+        parallel_for(jobs, range(10, 10), [&](i32) { calls.fetch_add(1); });
+        parallel_for(jobs, range(10, 5),  [&](i32) { calls.fetch_add(1); });
+        REQUIRE(calls.load() == 0);
+    }
+
+    SECTION("reduces to the serial result") {
+        u64 serial = 0;
+        for (auto i : range(0, 100000, 3)) { serial += u64(i) * u64(i); }
+
+        for (auto const & part : partitions) {
+            u64 const sum = parallel_reduce(jobs, range(0, 100000, 3), u64{0},
+                [](u64 acc, i32 i) { return acc + u64(i) * u64(i); },
+                [](u64 a, u64 b) { return a + b; },
+                part);
+            REQUIRE(sum == serial);
+        }
+    }
+
+    SECTION("combines partial results in index order") {
+        // Concatenation is associative but not commutative, so any partial
+        // combined out of order shows up in the result. Yielding now and then
+        // shuffles which jobs claim which chunks.
+        std::string serial;
+        for (auto i : range(0, 2000)) { serial += std::to_string(i) + ","; }
+
+        for (auto const & part : partitions) {
+            for (u32 attempt = 0; attempt < 20; ++attempt) {
+                auto const joined = parallel_reduce(jobs, range(0, 2000),
+                    std::string { },
+                    [](std::string acc, i32 i) {
+                        if (i % 64 == 0) { std::this_thread::yield(); }
+                        return std::move(acc) + std::to_string(i) + ",";
+                    },
+                    [](std::string a, std::string const & b) {
+                        return std::move(a) + b;
+                    },
+                    part);
+                REQUIRE(joined == serial);
+            }
+        }
+    }
+
+    SECTION("runs the tiles of multi-dimensional ranges") {
+        for (auto const & r : { nonstd::range2d(37, 23).tiled(8, 8),
+                                nonstd::range2d(37, 23).morton(),
+                                nonstd::range2d(37, 23) }) {
+            std::vector<std::atomic<i32>> hits (37 * 23);
+            parallel_for(jobs, r, [&](i32 x, i32 y) {
+                hits[y * 37 + x].fetch_add(1, std::memory_order_relaxed);
+            }, partition { schedule::dynamic, 1 });
+
+            i32 wrong = 0;
+            for (auto const & h : hits) { wrong += (h.load() != 1); }
+            REQUIRE(wrong == 0);
+        }
+    }
+
+    SECTION("nests inside of jobs") {
+        std::atomic<i32> total { 0 };
+        parallel_for(jobs, range(8), [&](i32) {
+            parallel_for(jobs, range(100), [&](i32) {
+                total.fetch_add(1, std::memory_order_relaxed);
+            }, partition { schedule::dynamic, 10 });
+        }, partition { schedule::dynamic, 1 });
+        REQUIRE(total.load() == 800);
+    }
+}
+
+} /* namespace nonstd_test::parallel */
@@ -0,0 +1,60 @@
+/** Profiling Zone Benchmarks
+ *  =========================
+ *  The cost of a zone while recording, while not recording, and of the two
+ *  `steady_clock` reads a hand-written timer would make. Checks profile.h's
+ *  claim that a zone costs next to nothing while nothing is recording.
+ */
+
+#include <nonstd/profile.h>
+#include <nonstd/benchmark.h>
+
+#include <chrono>
+#include <sstream>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/chrono.h>
+#include <nonstd/wallclock.h>
+
+
+namespace nonstd_bench::profile {
+
+using nonstd::profile::thread_buffer;
+using nonstd::profile::trace_flusher;
+using namespace nonstd::literals::chrono_literals;
+
+
+NONSTD_BENCHMARK("profile zones") {
+    auto const & idle = bench.run("not recording", [] {
+        PROFILE_SCOPE("idle");
+    });
+    auto const & timer = bench.run("steady_clock::now() x2", [] {
+        auto const begin = std::chrono::steady_clock::now();
+        nonstd::do_not_optimize(std::chrono::steady_clock::now() - begin);
+    });
+    bench.expect_speedup(timer, idle, 5.0,
+        "profile.h: while not recording, a zone is much cheaper than reading "
+        "the clock");
+
+    // Zones are timed at most a buffer's worth at a time, and the buffer is
+    // drained between -- outside of the timed part -- s.t. the flusher's
+    // formatting isn't counted, and no zones are dropped.
+    std::ostringstream out;
+    trace_flusher flusher { out, 1h };
+    bench.run_manual("recording", [&](u64 iterations) {
+        nonstd::chrono::nanoseconds elapsed { 0 };
+        while (iterations > 0) {
+            u64 const chunk = n2min(iterations,
+                                    u64(thread_buffer::capacity - 1));
+            auto const start = nonstd::wallclock::now_fast();
+            for (u64 i = 0; i < chunk; ++i) { PROFILE_SCOPE("busy"); }
+            elapsed += nonstd::wallclock::now_fast() - start;
+            flusher.flush();
+            out.str({ });
+            iterations -= chunk;
+        }
+        return elapsed;
+    });
+    fmt::print("  {} zones dropped\n", flusher.dropped());
+}
+
+} /* namespace nonstd_bench::profile */
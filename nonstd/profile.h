@@ -0,0 +1,433 @@
+/** Profiling Zones
+ *  ===============
+ *  Scoped timing zones, recorded into per-thread ring buffers and written out
+ *  in the background as a Chrome Trace Event JSON file -- which both
+ *  chrome://tracing and ui.perfetto.dev open directly;
+ *
+ *      void simulate(world & w) {
+ *          PROFILE_FUNCTION();
+ *          for (auto & body : w.bodies) {
+ *              PROFILE_SCOPE("integrate");
+ *              ...
+ *          }
+ *      }
+ *
+ *      std::ofstream file { "frame.trace.json" };
+ *      nonstd::profile::trace_flusher flusher { file };
+ *      run_the_game();
+ *      // The trace is complete once `flusher` is destroyed.
+ *
+ *  Zones are only recorded while a `trace_flusher` exists. Outside of that a
+ *  zone costs one relaxed atomic load. While recording, a zone reads the clock
+ *  twice (`wallclock::now_fast`, so the TSC where it's usable), and when it
+ *  closes, writes one `{ name, begin, end }` record into its thread's buffer.
+ *  Recording whole zones -- rather than separate begin and end events -- means
+ *  a full buffer can only ever drop whole zones, never leave one half-open.
+ *  Nothing blocks; each thread's buffer is a single-producer, single-consumer
+ *  ring, with the flusher as its consumer. When a ring is full, zones are
+ *  dropped and counted.
+ *
+ *  Zone names are stored by pointer, not copied, so they must outlive the
+ *  flusher. String literals and `__func__` both do.
+ *
+ *  Defining `NONSTD_PROFILE` as `0` removes every `PROFILE_*` macro from the
+ *  program; they expand to nothing. It defaults to `1`.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/chrono.h>
+#include <nonstd/json_string.h>
+#include <nonstd/wallclock.h>
+
+
+#if !defined(NONSTD_PROFILE)
+#  define NONSTD_PROFILE 1
+#endif
+
+#if NONSTD_PROFILE
+/** Record a zone from here to the end of the enclosing scope. */
+#  define PROFILE_SCOPE(NAME) \
+    ::nonstd::profile::zone CONCAT_SYMBOL(_nonstd_profile_zone_, __LINE__) { \
+        NAME }
+/** Record a zone named for the enclosing function. */
+#  define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+/** Name the calling thread in traces. */
+#  define PROFILE_THREAD(NAME) ::nonstd::profile::set_thread_name(NAME)
+#else
+#  define PROFILE_SCOPE(NAME)
+#  define PROFILE_FUNCTION()
+#  define PROFILE_THREAD(NAME)
+#endif
+
+
+namespace nonstd::profile {
+
+/** Zone Records and Thread Buffers
+ *  -------------------------------
+ */
+struct zone_record {
+    c_cstr name;
+    i64    begin_ns;
+    i64    end_ns;
+};
+
+/** A single-producer, single-consumer ring of `zone_record`s. The owning
+ *  thread pushes, and the flusher drains.
+ */
+class thread_buffer {
+public:
+    static constexpr u64 capacity = u64{1} << 14;
+
+private:
+    static constexpr u64 mask = capacity - 1;
+
+    ALIGNAS(cache_line_size) std::atomic<u64> m_head;
+    u64                                       m_cached_tail;
+    std::atomic<u64>                          m_dropped;
+    std::atomic<c_cstr>                       m_name;
+    ALIGNAS(cache_line_size) std::atomic<u64> m_tail;
+    std::atomic<bool>                         m_retired;
+    u32                                       m_thread_id;
+    std::unique_ptr<zone_record[]>            m_records;
+
+public:
+    explicit thread_buffer(u32 thread_id)
+        : m_head        ( 0 )
+        , m_cached_tail ( 0 )
+        , m_dropped     ( 0 )
+        , m_name        ( nullptr )
+        , m_tail        ( 0 )
+        , m_retired     ( false )
+        , m_thread_id   ( thread_id )
+        , m_records     ( new zone_record[capacity] )
+    { }
+
+    thread_buffer(thread_buffer const &) = delete;
+    thread_buffer& operator= (thread_buffer const &) = delete;
+
+    /** Append a record, or count it as dropped if the ring is full. Only the
+     *  owning thread may push.
+     */
+    bool push(zone_record const & record) noexcept {
+        u64 const head = m_head.load(std::memory_order_relaxed);
+        if (head - m_cached_tail == capacity) {
+            m_cached_tail = m_tail.load(std::memory_order_acquire);
+            if (head - m_cached_tail == capacity) {
+                m_dropped.store(m_dropped.load(std::memory_order_relaxed) + 1,
+                                std::memory_order_relaxed);
+                return false;
+            }
+        }
+        m_records[head & mask] = record;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Call `fn(record)` for every record pushed so far, and free their slots.
+     *  Only one thread may drain at a time.
+     */
+    template <typename Fn>
+    u64 drain(Fn && fn) {
+        u64 const tail = m_tail.load(std::memory_order_relaxed);
+        u64 const head = m_head.load(std::memory_order_acquire);
+        for (u64 i = tail; i != head; ++i) { fn(m_records[i & mask]); }
+        m_tail.store(head, std::memory_order_release);
+        return head - tail;
+    }
+
+    u32    thread_id() const noexcept { return m_thread_id; }
+    u64    dropped()   const noexcept {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+    c_cstr name()      const noexcept {
+        return m_name.load(std::memory_order_relaxed);
+    }
+    void   set_name(c_cstr name) noexcept {
+        m_name.store(name, std::memory_order_relaxed);
+    }
+
+    /** Whether the owning thread has exited. Its remaining records can still
+     *  be drained.
+     */
+    bool retired() const noexcept {
+        return m_retired.load(std::memory_order_acquire);
+    }
+    void retire() noexcept { m_retired.store(true, std::memory_order_release); }
+};
+
+
+namespace detail::profile_ {
+
+/** The set of every thread's buffer, and whether anyone's recording. */
+class registry {
+    std::mutex                                  m_mutex;
+    std::vector<std::shared_ptr<thread_buffer>> m_buffers;
+    u32                                         m_next_thread_id;
+
+public:
+    std::atomic<u32> recording;
+
+    registry()
+        : m_mutex          ( )
+        , m_buffers        ( )
+        , m_next_thread_id ( 1 )
+        , recording        ( 0 )
+    { }
+
+    static registry & instance() {
+        static registry the_registry;
+        return the_registry;
+    }
+
+    std::shared_ptr<thread_buffer> add_thread() {
+        std::lock_guard lock { m_mutex };
+        auto buffer = std::make_shared<thread_buffer>(m_next_thread_id++);
+        m_buffers.push_back(buffer);
+        return buffer;
+    }
+
+    /** Every buffer. */
+    std::vector<std::shared_ptr<thread_buffer>> buffers() {
+        std::lock_guard lock { m_mutex };
+        return m_buffers;
+    }
+
+    /** Every buffer, and forget those whose threads have exited. Retired
+     *  buffers are returned one last time, so they can be drained.
+     */
+    std::vector<std::shared_ptr<thread_buffer>> take_buffers() {
+        std::lock_guard lock { m_mutex };
+        auto buffers = m_buffers;
+        m_buffers.erase(std::remove_if(m_buffers.begin(), m_buffers.end(),
+                                       [](auto const & buffer) {
+                                           return buffer->retired();
+                                       }),
+                        m_buffers.end());
+        return buffers;
+    }
+};
+
+/** Owns the calling thread's buffer, and retires it when the thread exits. */
+struct local_buffer {
+    std::shared_ptr<thread_buffer> buffer;
+    ~local_buffer() { if (buffer) { buffer->retire(); } }
+};
+
+inline thread_buffer & this_thread_buffer() {
+    thread_local local_buffer local;
+    if (!local.buffer) { local.buffer = registry::instance().add_thread(); }
+    return *local.buffer;
+}
+
+} /* namespace detail::profile_ */
+
+
+/** Zones
+ *  -----
+ */
+/** Whether zones are currently being recorded. */
+inline bool recording() noexcept {
+    return detail::profile_::registry::instance()
+        .recording.load(std::memory_order_relaxed) != 0;
+}
+
+/** Name the calling thread in traces. `name` must outlive the flusher. */
+inline void set_thread_name(c_cstr name) {
+    detail::profile_::this_thread_buffer().set_name(name);
+}
+
+/** Times its own lifetime, and records it as a zone. */
+class zone {
+    c_cstr m_name;
+    i64    m_begin_ns;
+
+public:
+    explicit zone(c_cstr name) noexcept
+        : m_name     ( recording() ? name : nullptr )
+        , m_begin_ns ( m_name ? wallclock::now_fast().count() : 0 )
+    { }
+
+    zone(zone const &) = delete;
+    zone& operator= (zone const &) = delete;
+
+    ~zone() {
+        if (m_name == nullptr) { return; }
+        i64 const end_ns = wallclock::now_fast().count();
+        detail::profile_::this_thread_buffer().push({ m_name, m_begin_ns,
+                                                      end_ns });
+    }
+};
+
+
+/** Chrome Trace Flusher
+ *  --------------------
+ *  Enables recording for its lifetime, and drains every thread's buffer into
+ *  `out` every `interval` from a background thread. Zones are written as
+ *  complete ("X") events, with times in microseconds since the flusher was
+ *  created. The JSON is only well-formed once the flusher is destroyed.
+ *
+ *  Only one flusher may exist at a time. `out` is written from the background
+ *  thread, and must not be touched until the flusher is destroyed.
+ */
+class trace_flusher {
+    using thread_name = std::pair<u32, c_cstr>;
+
+    std::ostream &           m_out;
+    chrono::nanoseconds      m_interval;
+    i64                      m_origin_ns;
+    mutable std::mutex       m_drain_mutex;
+    bool                     m_first_event;
+    u64                      m_written;
+    std::vector<thread_name> m_thread_names;
+    std::mutex               m_wake_mutex;
+    std::condition_variable  m_wake;
+    bool                     m_stopping;
+    std::thread              m_thread;
+
+public:
+    explicit trace_flusher(
+        std::ostream & out,
+        chrono::nanoseconds interval = chrono::milliseconds { 50 })
+        : m_out          ( out )
+        , m_interval     ( interval )
+        , m_origin_ns    ( wallclock::now_fast().count() )
+        , m_drain_mutex  ( )
+        , m_first_event  ( true )
+        , m_written      ( 0 )
+        , m_thread_names ( )
+        , m_wake_mutex   ( )
+        , m_wake         ( )
+        , m_stopping     ( false )
+        , m_thread       ( )
+    {
+        auto & registry = detail::profile_::registry::instance();
+        u32 idle = 0;
+        BREAK_UNLESS(registry.recording.compare_exchange_strong(idle, 1),
+                     nonstd::error::pebcak,
+                     "Only one profile::trace_flusher may exist at a time.");
+        m_out << R"({"displayTimeUnit":"ns","traceEvents":[)";
+        m_thread = std::thread { [this] { _run(); } };
+    }
+
+    trace_flusher(trace_flusher const &) = delete;
+    trace_flusher& operator= (trace_flusher const &) = delete;
+
+    ~trace_flusher() {
+        detail::profile_::registry::instance().recording.fetch_sub(1);
+        {
+            std::lock_guard lock { m_wake_mutex };
+            m_stopping = true;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+        flush();
+        m_out << "\n]}\n";
+        m_out.flush();
+    }
+
+    /** Drain every thread's buffer now, rather than waiting for the next
+     *  interval.
+     */
+    void flush() {
+        std::lock_guard lock { m_drain_mutex };
+        std::string text;
+        auto buffers = detail::profile_::registry::instance().take_buffers();
+        for (auto const & buffer : buffers) {
+            _write_thread_name(text, *buffer);
+            buffer->drain([&](zone_record const & record) {
+                // Zones that began before this flusher (that were closed
+                // while no one was recording) are left out.
+                if (record.begin_ns < m_origin_ns) { return; }
+                _write_zone(text, buffer->thread_id(), record);
+                m_written += 1;
+            });
+        }
+        m_out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+
+    /** The number of zones written so far. */
+    u64 written() const {
+        std::lock_guard lock { m_drain_mutex };
+        return m_written;
+    }
+
+    /** The number of zones dropped because their thread's buffer was full,
+     *  across every thread that's still running.
+     */
+    u64 dropped() const {
+        u64 result = 0;
+        for (auto const & buffer :
+                 detail::profile_::registry::instance().buffers()) {
+            result += buffer->dropped();
+        }
+        return result;
+    }
+
+private:
+    void _run() {
+        std::unique_lock lock { m_wake_mutex };
+        while (!m_stopping) {
+            m_wake.wait_for(lock, m_interval);
+            lock.unlock();
+            flush();
+            lock.lock();
+        }
+    }
+
+    void _begin_event(std::string & text) {
+        text.append(m_first_event ? "\n" : ",\n");
+        m_first_event = false;
+    }
+
+    void _write_thread_name(std::string & text,
+                            thread_buffer const & buffer) {
+        c_cstr const name = buffer.name();
+        if (name == nullptr) { return; }
+        for (auto & [id, written] : m_thread_names) {
+            if (id != buffer.thread_id()) { continue; }
+            if (written == name) { return; }
+            written = name;
+            _write_thread_name_event(text, buffer.thread_id(), name);
+            return;
+        }
+        m_thread_names.emplace_back(buffer.thread_id(), name);
+        _write_thread_name_event(text, buffer.thread_id(), name);
+    }
+
+    void _write_thread_name_event(std::string & text, u32 thread_id,
+                                  c_cstr name) {
+        _begin_event(text);
+        text.append(fmt::format(
+            R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},)"
+            R"("args":{{"name":)", thread_id));
+        append_json_string(text, name);
+        text.append("}}");
+    }
+
+    void _write_zone(std::string & text, u32 thread_id,
+                     zone_record const & record) {
+        _begin_event(text);
+        text.append(R"({"name":)");
+        append_json_string(text, record.name);
+        text.append(fmt::format(R"(,"ph":"X","pid":1,"tid":{},)"
+                                R"("ts":{:.3f},"dur":{:.3f}}})",
+                                thread_id,
+                                f64(record.begin_ns - m_origin_ns) / 1000.0,
+                                f64(record.end_ns - record.begin_ns) / 1000.0));
+    }
+};
+
+} /* namespace nonstd::profile */
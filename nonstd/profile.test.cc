@@ -0,0 +1,168 @@
+/** Profiling Zone Tests
+ *  ====================
+ *  GOAL: Validate that zones are recorded only while a flusher exists, that
+ *  each thread's zones are written -- nested, named, and escaped -- as Chrome
+ *  Trace Event JSON, and that full buffers drop whole zones rather than
+ *  blocking.
+ */
+
+#include <nonstd/profile.h>
+#include <platform/testrunner/testrunner.h>
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+
+
+namespace nonstd_test::profile {
+
+using nonstd::profile::thread_buffer;
+using nonstd::profile::trace_flusher;
+using nonstd::profile::zone_record;
+using namespace nonstd::literals::chrono_literals;
+
+u64 count_of(std::string const & text, std::string const & pattern) {
+    u64 count = 0;
+    for (auto at = text.find(pattern); at != std::string::npos;
+         at = text.find(pattern, at + pattern.size())) {
+        count += 1;
+    }
+    return count;
+}
+
+/** The value of `"key":` in the first event named `name`. */
+f64 field_of(std::string const & text, std::string const & name,
+             std::string const & key) {
+    auto const event = text.find(R"({"name":")" + name + R"(")");
+    auto const field = text.find(R"(")" + key + R"(":)", event);
+    return std::stod(text.substr(field + key.size() + 3));
+}
+
+NOINLINE void profiled_function() { PROFILE_FUNCTION(); }
+
+
+TEST_CASE("Profiling Zones", "[nonstd][profile]") {
+    SECTION("record nested zones as Chrome trace events") {
+        std::ostringstream out;
+        {
+            trace_flusher flusher { out, 1h };
+            REQUIRE(nonstd::profile::recording());
+            PROFILE_THREAD("main");
+            {
+                PROFILE_SCOPE("outer");
+                std::this_thread::sleep_for(2ms);
+                {
+                    PROFILE_SCOPE("inner \"quoted\"");
+                    std::this_thread::sleep_for(1ms);
+                }
+                profiled_function();
+            }
+            flusher.flush();
+            REQUIRE(flusher.written() == 3);
+        }
+        REQUIRE_FALSE(nonstd::profile::recording());
+
+        auto const text = out.str();
+        REQUIRE(text.rfind(R"({"displayTimeUnit":"ns","traceEvents":[)", 0)
+                == 0);
+        REQUIRE(text.substr(text.size() - 4) == "\n]}\n");
+        REQUIRE(count_of(text, R"("ph":"X")") == 3);
+        REQUIRE(count_of(text, R"("name":"profiled_function")") == 1);
+        REQUIRE(count_of(text, R"("args":{"name":"main"})") == 1);
+        REQUIRE(count_of(text, R"("name":"inner \"quoted\"")") == 1);
+
+        f64 const outer_ts  = field_of(text, "outer", "ts");
+        f64 const outer_dur = field_of(text, "outer", "dur");
+        f64 const inner_ts  = field_of(text, R"(inner \"quoted\")", "ts");
+        f64 const inner_dur = field_of(text, R"(inner \"quoted\")", "dur");
+        REQUIRE(outer_dur >= 3000.0);
+        REQUIRE(inner_dur >= 1000.0);
+        REQUIRE(inner_ts >= outer_ts);
+        REQUIRE(inner_ts + inner_dur <= outer_ts + outer_dur);
+    }
+
+    SECTION("record nothing while no flusher exists") {
+        { PROFILE_SCOPE("unrecorded"); }
+        std::ostringstream out;
+        {
+            trace_flusher flusher { out, 1h };
+        }
+        REQUIRE(count_of(out.str(), "unrecorded") == 0);
+        REQUIRE(count_of(out.str(), R"("ph":"X")") == 0);
+    }
+
+    SECTION("collect zones from many threads, including exited ones") {
+        std::ostringstream out;
+        {
+            trace_flusher flusher { out, 1ms };
+            std::vector<std::thread> threads;
+            for (u32 t = 0; t < 4; ++t) {
+                threads.emplace_back([] {
+                    PROFILE_THREAD("worker");
+                    for (u32 i = 0; i < 1000; ++i) { PROFILE_SCOPE("work"); }
+                });
+            }
+            for (auto & thread : threads) { thread.join(); }
+        }
+        REQUIRE(count_of(out.str(), R"("name":"work")") == 4000);
+        REQUIRE(count_of(out.str(), R"("args":{"name":"worker"})") == 4);
+    }
+
+    SECTION("drop whole zones, and count them, when a buffer is full") {
+        std::ostringstream out;
+        u64 dropped = 0;
+        u64 written = 0;
+        {
+            trace_flusher flusher { out, 1h };
+            std::thread { [] {
+                for (u64 i = 0; i < thread_buffer::capacity + 10; ++i) {
+                    PROFILE_SCOPE("flood");
+                }
+            } }.join();
+            dropped = flusher.dropped();
+            flusher.flush();
+            written = flusher.written();
+        }
+        REQUIRE(dropped == 10);
+        REQUIRE(written == thread_buffer::capacity);
+        REQUIRE(count_of(out.str(), R"("name":"flood")")
+                == thread_buffer::capacity);
+    }
+
+    SECTION("allow only one flusher at a time") {
+        std::ostringstream out;
+        trace_flusher flusher { out, 1h };
+        REQUIRE_THROWS(trace_flusher { out, 1h });
+    }
+}
+
+TEST_CASE("Profiling Zone Buffers", "[nonstd][profile]") {
+    SECTION("wrap around, in order") {
+        thread_buffer buffer { 1 };
+        std::vector<i64> drained;
+        for (i64 round = 0; round < 3; ++round) {
+            u64 pushed = 0;
+            for (u64 i = 0; i < thread_buffer::capacity - 1; ++i) {
+                pushed += buffer.push({ "x", i64(i), round });
+            }
+            REQUIRE(pushed == thread_buffer::capacity - 1);
+
+            drained.clear();
+            bool in_order = true;
+            buffer.drain([&](zone_record const & record) {
+                in_order &= record.end_ns == round
+                         && record.begin_ns == i64(drained.size());
+                drained.push_back(record.begin_ns);
+            });
+            REQUIRE(in_order);
+            REQUIRE(drained.size() == thread_buffer::capacity - 1);
+        }
+        REQUIRE(buffer.dropped() == 0);
+    }
+}
+
+} /* namespace nonstd_test::profile */
@@ -0,0 +1,46 @@
+/** Multi-Dimensional Range Benchmarks
+ *  ==================================
+ *  Transposes a large matrix with a plain 2D range, a tiled one, and one in
+ *  Morton order. Reading down columns misses the cache on every element once
+ *  a row outgrows it; tiles and Morton order keep both sides' accesses close.
+ */
+
+#include <nonstd/range_nd.h>
+#include <nonstd/benchmark.h>
+
+#include <vector>
+
+#include <nonstd/nonstd.h>
+
+
+namespace nonstd_bench::range_nd {
+
+using nonstd::range;
+using nonstd::range2d;
+
+template <typename R>
+NOINLINE void transpose(R const & r, std::vector<f32> const & in,
+                        std::vector<f32> & out, i32 n) {
+    r.for_each([&](i32 x, i32 y) { out[x * n + y] = in[y * n + x]; });
+}
+
+
+NONSTD_BENCHMARK("range_nd transposes") {
+    i32 const n = 2048;
+    std::vector<f32> in (u64(n) * n);
+    std::vector<f32> out (u64(n) * n);
+    range(f32(in.size())).fill(in);
+
+    auto measure = [&](c_cstr name, auto const & r) {
+        bench.run(name, [&] {
+            transpose(r, in, out, n);
+            nonstd::clobber_memory();
+        }, in.size());
+    };
+    measure("row-major", range2d(n, n));
+    measure("tiled 32x32", range2d(n, n).tiled(32, 32));
+    measure("Morton", range2d(n, n).morton());
+    measure("tiled Morton", range2d(n, n).tiled(64, 64).morton());
+}
+
+} /* namespace nonstd_bench::range_nd */
@@ -0,0 +1,482 @@
+/** Multi-Dimensional Ranges
+ *  ========================
+ *  `range2d` and `range3d` yield the `(x, y[, z])` tuples of two or three
+ *  `nonstd::range`s, replacing nested loops over them.
+ *
+ *      for (auto [x, y] : nonstd::range2d(width, height)) { ... }
+ *      for (auto [x, y, z] : nonstd::range3d(range(0, 64, 2),
+ *                                            range(64),
+ *                                            range(8))) { ... }
+ *
+ *  Plain ranges are walked row-major; x fastest, then y, then z, exactly like
+ *  the nested loops they replace. Two things change that order, s.t. kernels
+ *  that touch memory along more than one axis (transposes, stencils) stay in
+ *  cache;
+ *   - `.tiled(w, h[, d])` cuts the range into tiles of (at most) that extent,
+ *     and walks the tiles row-major, finishing each tile before the next.
+ *   - `.morton()` walks the values inside each tile (or the whole range, if
+ *     it isn't tiled) in Morton, or Z-, order; interleaving the bits of the
+ *     indices, s.t. values that are close in the order are close on every
+ *     axis. Extents needn't be powers of two; indices outside the range are
+ *     skipped. Where extents differ by more than 2x, the high bits of the
+ *     longer axes are walked row-major above the interleaved low bits, so on
+ *     average no more than 2^N codes are decoded for each value yielded.
+ *
+ *  Tiles are the unit of parallel work. `tile_count()` and `tile(i)` split a
+ *  range into independent sub-ranges -- which keep the parent's traversal --
+ *  and `nonstd::parallel_for` (in parallel.h) runs them as jobs. Untiled
+ *  ranges are split into `slices()`; one row (2D) or plane (3D) each.
+ *
+ *  Iterators are forward iterators that yield tuples by value. `for_each(fn)`
+ *  calls `fn(x, y[, z])` for each value in the same order, with plain nested
+ *  loops for each row-major tile, and is the faster of the two for hot loops.
+ */
+
+#pragma once
+
+#include <array>
+#include <iterator>
+#include <tuple>
+#include <utility>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/math.h>
+
+
+namespace nonstd {
+
+/** The order values are visited in, inside each tile. */
+enum class traversal {
+    row_major,
+    morton,
+};
+
+template <typename T, size_t N> class range_nd_t;
+template <typename T> using range2d_t = range_nd_t<T, 2>;
+template <typename T> using range3d_t = range_nd_t<T, 3>;
+
+
+namespace detail::range_nd_ {
+
+template <typename T, size_t>
+using repeat = T;
+
+template <typename T, typename Indices> struct tuple_of;
+template <typename T, size_t ... I>
+struct tuple_of<T, std::index_sequence<I...>> {
+    using type = std::tuple<repeat<T, I>...>;
+};
+
+/** Gather every `N`th bit of `bits`, starting from bit 0. */
+template <size_t N>
+constexpr u64 compact_bits(u64 bits) noexcept {
+    if constexpr (N == 2) {
+        bits &= 0x5555555555555555;
+        bits = (bits | (bits >>  1)) & 0x3333333333333333;
+        bits = (bits | (bits >>  2)) & 0x0f0f0f0f0f0f0f0f;
+        bits = (bits | (bits >>  4)) & 0x00ff00ff00ff00ff;
+        bits = (bits | (bits >>  8)) & 0x0000ffff0000ffff;
+        bits = (bits | (bits >> 16)) & 0x00000000ffffffff;
+    } else {
+        static_assert(N == 3);
+        bits &= 0x1249249249249249;
+        bits = (bits | (bits >>  2)) & 0x10c30c30c30c30c3;
+        bits = (bits | (bits >>  4)) & 0x100f00f00f00f00f;
+        bits = (bits | (bits >>  8)) & 0x001f0000ff0000ff;
+        bits = (bits | (bits >> 16)) & 0x001f00000000ffff;
+        bits = (bits | (bits >> 32)) & 0x00000000001fffff;
+    }
+    return bits;
+}
+
+/** The number of bits needed to index `[0, n)`. */
+inline u32 index_bits(u64 n) noexcept {
+    return n <= 1 ? 0 : count_trailing_zeros(ceil_power_of_two(n));
+}
+
+/** Morton codes over a box whose extents needn't be equal powers of two.
+ *  The low `N * shared` bits of a code interleave the low `shared` bits of
+ *  every axis; the remaining bits of each axis are stacked above them, axis 0
+ *  lowest.
+ */
+template <size_t N>
+struct morton_layout {
+    std::array<u32, N> bits   = { };
+    u32                shared = 0;
+    u64                codes  = 1;
+
+    morton_layout() = default;
+    explicit morton_layout(std::array<u64, N> const & extents) {
+        u32 total = 0;
+        shared = 64;
+        for (size_t k = 0; k < N; ++k) {
+            bits[k] = index_bits(extents[k]);
+            shared  = n2min(shared, bits[k]);
+            total  += bits[k];
+        }
+        BREAK_IF(total > 63, nonstd::error::pebcak,
+                 "Morton traversal of {} index bits doesn't fit in a u64",
+                 total);
+        codes = u64{1} << total;
+    }
+
+    /** Step `index` from `code - 1`'s to `code`'s. Incrementing a code clears
+     *  its trailing ones and sets the bit above them; in index space that's
+     *  clearing the low bits of every axis and setting one bit of one.
+     */
+    void advance(u64 code, std::array<u64, N> & index) const noexcept {
+        u32 const flipped = count_trailing_zeros(code);
+        if (flipped >= N * shared) {
+            decode(code, index);
+            return;
+        }
+        u32 const level = flipped / N;
+        u32 const axis  = flipped % N;
+        for (size_t k = 0; k < N; ++k) {
+            u32 const cleared = level + (k < axis ? 1 : 0);
+            index[k] &= ~((u64{1} << cleared) - 1);
+        }
+        index[axis] |= u64{1} << level;
+    }
+
+    void decode(u64 code, std::array<u64, N> & index) const noexcept {
+        u64 const low_mask = (u64{1} << (N * shared)) - 1;
+        u64 const low  = code & low_mask;
+        u64       high = code >> (N * shared);
+        for (size_t k = 0; k < N; ++k) {
+            u64 const own = bits[k] - shared;
+            u64 const hi  = high & ((u64{1} << own) - 1);
+            high >>= own;
+            u64 const lo  = compact_bits<N>(low >> k)
+                          & ((u64{1} << shared) - 1);
+            index[k] = (hi << shared) | lo;
+        }
+    }
+};
+
+} /* namespace detail::range_nd_ */
+
+
+/** `nonstd::range2d` / `nonstd::range3d` Free Functions
+ *   ===================================================
+ */
+template <typename T>
+range2d_t<T> range2d(range_t<T> x, range_t<T> y) {
+    return range2d_t<T> { { x, y } };
+}
+template <typename T>
+range2d_t<T> range2d(T width, T height) {
+    return range2d(range(width), range(height));
+}
+
+template <typename T>
+range3d_t<T> range3d(range_t<T> x, range_t<T> y, range_t<T> z) {
+    return range3d_t<T> { { x, y, z } };
+}
+template <typename T>
+range3d_t<T> range3d(T width, T height, T depth) {
+    return range3d(range(width), range(height), range(depth));
+}
+
+
+template <typename T, size_t N>
+class range_nd_t {
+    static_assert(N == 2 || N == 3,
+        "nonstd::range_nd_t is only implemented for two and three dimensions.");
+
+public:
+    using value_type = typename detail::range_nd_::tuple_of<
+        T, std::make_index_sequence<N>>::type;
+    class iterator;
+
+private:
+    using indices = std::array<u64, N>;
+
+    std::array<range_t<T>, N> m_axes;
+    indices                   m_lo;
+    indices                   m_count;
+    indices                   m_tile;
+    traversal                 m_order;
+
+public:
+    explicit range_nd_t(std::array<range_t<T>, N> const & axes) noexcept
+        : m_axes  ( axes )
+        , m_lo    ( )
+        , m_count ( )
+        , m_tile  ( )
+        , m_order ( traversal::row_major )
+    {
+        for (size_t k = 0; k < N; ++k) {
+            m_count[k] = m_axes[k].size();
+            m_tile[k]  = n2max(m_count[k], u64{1});
+        }
+    }
+
+    iterator begin() const { return iterator { *this, 0 }; }
+    iterator end()   const { return iterator { *this, tile_count() }; }
+
+    u64 size() const noexcept {
+        u64 result = 1;
+        for (u64 count : m_count) { result *= count; }
+        return result;
+    }
+    bool empty() const noexcept { return size() == 0; }
+
+    /** The number of values along axis `k`. */
+    u64       extent(size_t k) const noexcept { return m_count[k]; }
+    traversal order()          const noexcept { return m_order; }
+
+
+    /** Traversal Control
+     *  -----------------
+     *  Each returns a copy of this range with a different traversal.
+     */
+    template <typename ... Sizes>
+    range_nd_t tiled(Sizes ... sizes) const noexcept {
+        static_assert(sizeof...(Sizes) == N,
+                      "Give one tile size per dimension.");
+        range_nd_t result { *this };
+        result.m_tile = indices { static_cast<u64>(sizes)... };
+        for (u64 & extent : result.m_tile) {
+            extent = n2max(extent, u64{1});
+        }
+        return result;
+    }
+
+    range_nd_t morton() const noexcept {
+        range_nd_t result { *this };
+        result.m_order = traversal::morton;
+        return result;
+    }
+
+    /** Tiles one row (2D) or plane (3D) thick, and as wide as the range. */
+    range_nd_t slices() const noexcept {
+        range_nd_t result { *this };
+        for (size_t k = 0; k < N; ++k) {
+            result.m_tile[k] = n2max(m_count[k], u64{1});
+        }
+        result.m_tile[N - 1] = 1;
+        return result;
+    }
+
+
+    /** Tiles
+     *  -----
+     *  Tiles are numbered row-major, in the order they're walked.
+     */
+    u64 tile_count() const noexcept {
+        u64 result = 1;
+        for (size_t k = 0; k < N; ++k) {
+            result *= (m_count[k] + m_tile[k] - 1) / m_tile[k];
+        }
+        return result;
+    }
+
+    /** Tile `i`, as a single-tile range with this range's traversal. */
+    range_nd_t tile(u64 i) const noexcept {
+        range_nd_t result { *this };
+        for (size_t k = 0; k < N; ++k) {
+            u64 const across = (m_count[k] + m_tile[k] - 1) / m_tile[k];
+            u64 const offset = (i % across) * m_tile[k];
+            i /= across;
+            result.m_lo[k]    = m_lo[k] + offset;
+            result.m_count[k] = n2min(m_tile[k], m_count[k] - offset);
+            result.m_tile[k]  = n2max(result.m_count[k], u64{1});
+        }
+        return result;
+    }
+
+
+    /** Callback Iteration
+     *  ------------------
+     *  Call `fn(x, y[, z])` for every value, in traversal order.
+     */
+    template <typename Fn>
+    void for_each(Fn && fn) const {
+        u64 const tiles = tile_count();
+        for (u64 i = 0; i < tiles; ++i) {
+            tile(i).for_each_in_tile(fn);
+        }
+    }
+
+private:
+    template <typename Fn>
+    void for_each_in_tile(Fn & fn) const {
+        auto const & lo    = m_lo;
+        auto const & count = m_count;
+        if (m_order == traversal::morton) {
+            detail::range_nd_::morton_layout<N> const layout { count };
+            indices index = { };
+            call(fn, index, std::make_index_sequence<N>());
+            for (u64 code = 1; code < layout.codes; ++code) {
+                layout.advance(code, index);
+                if (!in_bounds(index)) { continue; }
+                call(fn, index, std::make_index_sequence<N>());
+            }
+        } else if constexpr (N == 2) {
+            for (u64 j = lo[1]; j < lo[1] + count[1]; ++j) {
+                T const y = m_axes[1][j];
+                for (u64 i = lo[0]; i < lo[0] + count[0]; ++i) {
+                    fn(m_axes[0][i], y);
+                }
+            }
+        } else {
+            for (u64 k = lo[2]; k < lo[2] + count[2]; ++k) {
+                T const z = m_axes[2][k];
+                for (u64 j = lo[1]; j < lo[1] + count[1]; ++j) {
+                    T const y = m_axes[1][j];
+                    for (u64 i = lo[0]; i < lo[0] + count[0]; ++i) {
+                        fn(m_axes[0][i], y, z);
+                    }
+                }
+            }
+        }
+    }
+
+    /** Whether `index` (relative to this range's origin) is inside it. */
+    bool in_bounds(indices const & index) const noexcept {
+        for (size_t k = 0; k < N; ++k) {
+            if (index[k] >= m_count[k]) { return false; }
+        }
+        return true;
+    }
+
+    template <typename Fn, size_t ... I>
+    void call(Fn & fn, indices const & index,
+              std::index_sequence<I...>) const {
+        fn(m_axes[I][m_lo[I] + index[I]]...);
+    }
+
+    template <size_t ... I>
+    value_type value_at(indices const & index,
+                        std::index_sequence<I...>) const noexcept {
+        return value_type { m_axes[I][index[I]]... };
+    }
+
+public:
+    class iterator {
+    public:
+        /* Iterator type trait boilerplate. See,
+         * http://en.cppreference.com/w/cpp/iterator/iterator_traits
+         *
+         * NB. Values are computed, not stored, so `reference` is a value type.
+         */
+        using difference_type   = ptrdiff;
+        using value_type        = typename range_nd_t::value_type;
+        using pointer           = void;
+        using reference         = value_type;
+        using iterator_category = std::forward_iterator_tag;
+
+    private:
+        range_nd_t const *                  m_range;
+        u64                                 m_tiles;
+        u64                                 m_tile;
+        /* Position within the current tile; a Morton code, or the row-major
+         * index of `m_local`. */
+        u64                                 m_position;
+        u64                                 m_positions;
+        indices                             m_origin;
+        indices                             m_extent;
+        indices                             m_local;
+        detail::range_nd_::morton_layout<N> m_layout;
+
+    public:
+        iterator() noexcept
+            : m_range     ( nullptr )
+            , m_tiles     ( 0 )
+            , m_tile      ( 0 )
+            , m_position  ( 0 )
+            , m_positions ( 0 )
+            , m_origin    ( )
+            , m_extent    ( )
+            , m_local     ( )
+            , m_layout    ( )
+        { }
+
+        iterator(range_nd_t const & range, u64 tile)
+            : iterator ( )
+        {
+            m_range = &range;
+            m_tiles = range.tile_count();
+            enter_tile(tile);
+        }
+
+        reference operator*() const noexcept {
+            indices absolute;
+            for (size_t k = 0; k < N; ++k) {
+                absolute[k] = m_origin[k] + m_local[k];
+            }
+            return m_range->value_at(absolute, std::make_index_sequence<N>());
+        }
+
+        iterator& operator++() {
+            m_position += 1;
+            if (m_range->m_order == traversal::morton) {
+                while (m_position < m_positions) {
+                    m_layout.advance(m_position, m_local);
+                    if (in_tile()) { return *this; }
+                    m_position += 1;
+                }
+            } else if (m_position < m_positions) {
+                for (size_t k = 0; k < N; ++k) {
+                    if (++m_local[k] < m_extent[k]) { return *this; }
+                    m_local[k] = 0;
+                }
+            }
+            enter_tile(m_tile + 1);
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator tmp { *this };
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(iterator const & lhs,
+                               iterator const & rhs) noexcept {
+            return lhs.m_tile == rhs.m_tile
+                && lhs.m_position == rhs.m_position;
+        }
+        friend bool operator!=(iterator const & lhs,
+                               iterator const & rhs) noexcept {
+            return !(lhs == rhs);
+        }
+
+    private:
+        bool in_tile() const noexcept {
+            for (size_t k = 0; k < N; ++k) {
+                if (m_local[k] >= m_extent[k]) { return false; }
+            }
+            return true;
+        }
+
+        void enter_tile(u64 tile) {
+            m_tile     = tile;
+            m_position = 0;
+            m_local    = indices { };
+            if (tile >= m_tiles) {
+                m_tile = m_tiles;
+                return;
+            }
+            auto const & range = *m_range;
+            m_positions = 1;
+            for (size_t k = 0; k < N; ++k) {
+                u64 const across = (range.m_count[k] + range.m_tile[k] - 1)
+                                 / range.m_tile[k];
+                u64 const offset = (tile % across) * range.m_tile[k];
+                tile /= across;
+                m_origin[k] = range.m_lo[k] + offset;
+                m_extent[k] = n2min(range.m_tile[k],
+                                    range.m_count[k] - offset);
+                m_positions *= m_extent[k];
+            }
+            if (range.m_order == traversal::morton) {
+                // Code 0 is always in the tile, so no need to skip ahead.
+                m_layout    = detail::range_nd_::morton_layout<N> { m_extent };
+                m_positions = m_layout.codes;
+            }
+        }
+    };
+};
+
+} /* namespace nonstd */
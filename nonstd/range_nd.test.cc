@@ -0,0 +1,145 @@
+/** Multi-Dimensional Range Tests
+ *  =============================
+ *  GOAL: Validate that 2D and 3D ranges -- plain, tiled, and in Morton order
+ *  -- visit every value exactly once, in the documented order, and that their
+ *  tiles partition them.
+ */
+
+#include <nonstd/range_nd.h>
+#include <platform/testrunner/testrunner.h>
+
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+
+
+namespace nonstd_test::range_nd {
+
+using nonstd::range;
+using nonstd::range2d;
+using nonstd::range3d;
+
+using point2 = std::tuple<i32, i32>;
+using point3 = std::tuple<i32, i32, i32>;
+
+template <typename R>
+auto collect(R const & r) {
+    std::vector<typename R::value_type> result;
+    for (auto value : r) { result.push_back(value); }
+    return result;
+}
+
+template <typename R>
+auto collect_for_each(R const & r) {
+    std::vector<typename R::value_type> result;
+    r.for_each([&](auto ... values) { result.emplace_back(values...); });
+    return result;
+}
+
+/** Whether `values` holds each of `r`'s values exactly once. */
+template <typename R, typename Values>
+bool visits_each_once(R const & r, Values const & values) {
+    std::set<typename R::value_type> unique { values.begin(), values.end() };
+    return values.size() == r.size() && unique.size() == r.size();
+}
+
+
+TEST_CASE("Multi-Dimensional Ranges", "[nonstd][range][range_nd]") {
+    SECTION("walk row-major, like nested loops") {
+        auto const r = range2d(range(3), range(10, 4, -3));
+        REQUIRE(r.size() == 6);
+        REQUIRE(collect(r) == std::vector<point2> {
+            { 0, 10 }, { 1, 10 }, { 2, 10 },
+            { 0,  7 }, { 1,  7 }, { 2,  7 },
+        });
+        REQUIRE(collect_for_each(r) == collect(r));
+
+        std::vector<point3> nested;
+        for (i32 z = 0; z < 2; ++z) {
+            for (i32 y = 0; y < 3; ++y) {
+                for (i32 x = 0; x < 4; ++x) { nested.emplace_back(x, y, z); }
+            }
+        }
+        REQUIRE(collect(range3d(4, 3, 2)) == nested);
+    }
+
+    SECTION("bind structured bindings") {
+        i32 sum = 0;
+        for (auto [x, y] : range2d(4, 5)) { sum += x * y; }
+        REQUIRE(sum == 6 * 10);
+    }
+
+    SECTION("yield nothing if any axis is empty") {
+        auto const r = range2d(range(5), range(0));
+        REQUIRE(r.empty());
+        REQUIRE(r.begin() == r.end());
+        REQUIRE(collect_for_each(r.tiled(2, 2).morton()).empty());
+    }
+
+    SECTION("finish each tile before starting the next") {
+        auto const r = range2d(5, 3).tiled(2, 2);
+        REQUIRE(r.tile_count() == 6);
+        REQUIRE(collect(r) == std::vector<point2> {
+            { 0, 0 }, { 1, 0 }, { 0, 1 }, { 1, 1 },
+            { 2, 0 }, { 3, 0 }, { 2, 1 }, { 3, 1 },
+            { 4, 0 }, { 4, 1 },
+            { 0, 2 }, { 1, 2 },
+            { 2, 2 }, { 3, 2 },
+            { 4, 2 },
+        });
+        REQUIRE(collect_for_each(r) == collect(r));
+    }
+
+    SECTION("walk in Morton order") {
+        auto const square = collect(range2d(4, 4).morton());
+        REQUIRE(std::vector<point2> { square.begin(), square.begin() + 8 }
+                == std::vector<point2> {
+            { 0, 0 }, { 1, 0 }, { 0, 1 }, { 1, 1 },
+            { 2, 0 }, { 3, 0 }, { 2, 1 }, { 3, 1 },
+        });
+
+        // Uneven, non-power-of-two extents skip what's out of bounds.
+        for (auto const & r : { range2d(7, 3).morton(),
+                                range2d(2, 37).morton(),
+                                range2d(13, 9).tiled(4, 8).morton() }) {
+            auto const values = collect(r);
+            REQUIRE(visits_each_once(r, values));
+            REQUIRE(collect_for_each(r) == values);
+        }
+
+        auto const cube = range3d(range(2, 12, 2), range(6), range(3)).morton();
+        auto const values = collect(cube);
+        REQUIRE(visits_each_once(cube, values));
+        REQUIRE(values[1] == point3 { 4, 0, 0 });
+        REQUIRE(values[2] == point3 { 2, 1, 0 });
+        REQUIRE(values[4] == point3 { 2, 0, 1 });
+    }
+
+    SECTION("split into tiles that partition the range") {
+        auto const r = range3d(9, 5, 4).tiled(4, 4, 3);
+        REQUIRE(r.tile_count() == 3 * 2 * 2);
+
+        std::vector<point3> stitched;
+        for (u64 i = 0; i < r.tile_count(); ++i) {
+            auto const tile = r.tile(i);
+            REQUIRE(tile.tile_count() == 1);
+            for (auto value : tile) { stitched.push_back(value); }
+        }
+        REQUIRE(stitched == collect(r));
+        REQUIRE(r.tile(11).size() == 1 * 1 * 1);
+        REQUIRE(*r.tile(11).begin() == point3 { 8, 4, 3 });
+    }
+
+    SECTION("slice untiled ranges by rows or planes") {
+        auto const rows = range2d(6, 4).slices();
+        REQUIRE(rows.tile_count() == 4);
+        REQUIRE(collect(rows.tile(2))
+                == collect(range2d(range(6), range(2, 3))));
+        REQUIRE(range3d(2, 3, 5).slices().tile(4).size() == 6);
+    }
+}
+
+} /* namespace nonstd_test::range_nd */
@@ -0,0 +1,106 @@
+/** Rate Limiter Benchmarks
+ *  =======================
+ *  Contention; `try_acquire` from one to eight threads, on a limiter that
+ *  admits nearly everything and one that admits almost nothing, against the
+ *  obvious mutex-guarded token bucket. The threads are started before, and
+ *  joined after, the timed part.
+ */
+
+#include <nonstd/rate_limiter.h>
+#include <nonstd/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/chrono.h>
+#include <nonstd/wallclock.h>
+
+
+namespace nonstd_bench::rate_limiter {
+
+using nonstd::benchmark::time_threads;
+using nonstd::gcra;
+using nonstd::wallclock;
+using namespace nonstd::literals::chrono_literals;
+
+/** The obvious implementation, for comparison. */
+class mutex_token_bucket {
+public:
+    mutex_token_bucket(f64 rate_hz, f64 burst)
+        : m_rate   ( rate_hz / 1e9 )
+        , m_burst  ( burst )
+        , m_tokens ( burst )
+        , m_last   ( wallclock::now() )
+    { }
+
+    bool try_acquire() {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        auto const now = wallclock::now();
+        m_tokens = std::min(m_burst, m_tokens
+                                   + f64((now - m_last).count()) * m_rate);
+        m_last = now;
+        if (m_tokens < 1.0) { return false; }
+        m_tokens -= 1.0;
+        return true;
+    }
+
+private:
+    std::mutex               m_mutex;
+    f64                      m_rate;
+    f64                      m_burst;
+    f64                      m_tokens;
+    std::chrono::nanoseconds m_last;
+};
+
+/** Time `acquire()` from `threads` threads, each calling it an equal share
+ *  of `count` times per iteration, and report how many were admitted.
+ */
+template <typename Acquire>
+void contend(nonstd::benchmark::suite & bench, std::string const & name,
+             u32 threads, Acquire && acquire) {
+    u64 const count = 1 << 14;
+    u64 const per_thread = count / threads;
+    std::atomic<u64> admitted { 0 };
+    std::atomic<u64> attempted { 0 };
+    bench.run_manual(fmt::format("{}, {} threads", name, threads),
+        [&](u64 iterations) {
+            return time_threads(threads, [&](u32) {
+                u64 local = 0;
+                for (u64 i = 0; i < per_thread * iterations; ++i) {
+                    local += acquire();
+                }
+                admitted += local;
+                attempted += per_thread * iterations;
+            });
+        }, per_thread * threads);
+    fmt::print("  {:.1f}% admitted\n",
+               100.0 * f64(admitted.load()) / f64(attempted.load()));
+}
+
+
+NONSTD_BENCHMARK("rate_limiter contention") {
+    for (u32 threads : { 1u, 2u, 4u, 8u }) {
+        gcra open { 1_GHz, 1'000'000 };
+        contend(bench, "gcra, mostly admitting", threads, [&] {
+            return open.try_acquire();
+        });
+        gcra closed { 1_kHz, 10 };
+        contend(bench, "gcra, mostly rejecting", threads, [&] {
+            return closed.try_acquire();
+        });
+        mutex_token_bucket locked_open { 1e9, 1e6 };
+        contend(bench, "mutex, mostly admitting", threads, [&] {
+            return locked_open.try_acquire();
+        });
+        mutex_token_bucket locked_closed { 1e3, 10 };
+        contend(bench, "mutex, mostly rejecting", threads, [&] {
+            return locked_closed.try_acquire();
+        });
+    }
+}
+
+} /* namespace nonstd_bench::rate_limiter */
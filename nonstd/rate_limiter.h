@@ -0,0 +1,241 @@
+/** Rate Limiters
+ *  =============
+ *  Lock-free limits on how often something may happen; log lines, network
+ *  sends, expensive recomputations. Each limiter has a rate -- a
+ *  `chrono::frequency` -- and a burst; the number of events that may happen
+ *  back-to-back after a quiet spell;
+ *
+ *      nonstd::token_bucket limiter { 100_Hz, 20 };
+ *      if (limiter.try_acquire()) { log(...); }
+ *      else { retry_after(limiter.time_until_available()); }
+ *
+ *  `token_bucket` and `gcra` (the Generic Cell Rate Algorithm; the "virtual
+ *  scheduling" form of a leaky bucket) admit exactly the same events. A bucket
+ *  of `burst` tokens refilled at `rate` is a schedule on which each token
+ *  "arrives" one interval (`1 / rate`) after the last, and an event may take
+ *  tokens as long as that pushes the schedule no more than `burst` intervals
+ *  ahead of now. The two differ only in how they're phrased; `token_bucket`
+ *  reports `available()` tokens, and `gcra` its `theoretical_arrival()` time
+ *  and `tolerance()`.
+ *
+ *  Either way the whole state is one timestamp -- the theoretical arrival
+ *  time of the next token -- in a single atomic; `try_acquire` is a load, a
+ *  little arithmetic, and one compare-exchange, retried only if another thread
+ *  acquired in between. Rejections don't write at all, so a limiter that's
+ *  mostly saying "no" doesn't bounce its cache line between threads.
+ *
+ *  Times are kept in 1/64ths of a nanosecond, relative to the limiter's
+ *  construction, s.t. an interval like 1/3MHz (333.33ns) is rounded by at most
+ *  1/128th of a nanosecond -- a rate error of 16ppm, rather than the 0.1% of
+ *  rounding to whole nanoseconds -- and a limiter can still run for about 4.5
+ *  years. Every operation takes an optional `now` (on `wallclock::now()`'s
+ *  epoch), so callers that already have the time, and tests, can supply it.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <ratio>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/chrono.h>
+#include <nonstd/wallclock.h>
+
+
+namespace nonstd {
+
+namespace detail::rate_limiter_ {
+
+/** The shared virtual-scheduling state of `token_bucket` and `gcra`. */
+class schedule {
+public:
+    using fine_duration = chrono::duration<i64, std::ratio<1, 64'000'000'000>>;
+
+    template <typename Rep, typename Period>
+    schedule(chrono::frequency<Rep, Period> rate, u64 burst)
+        : m_origin   ( wallclock::now() )
+        , m_interval ( chrono::round<fine_duration>(
+                           chrono::duration<f64> { f64 { 1.0 } / rate }) )
+        , m_burst    ( burst )
+    {
+        BREAK_UNLESS(m_interval.count() > 0, nonstd::error::pebcak,
+                     "A rate limiter's rate must be positive, and below "
+                     "64GHz.");
+        BREAK_UNLESS(burst >= 1 && burst <= u64(INT64_MAX)
+                                            / u64(m_interval.count()),
+                     nonstd::error::pebcak,
+                     "A rate limiter's burst must be at least 1, and its "
+                     "tolerance must fit in 64 bits.");
+        m_tolerance = m_interval * i64(burst);
+    }
+
+    bool try_acquire(u64 n, chrono::nanoseconds now) noexcept {
+        if (n > m_burst) { return false; }
+        i64 const at   = _fine(now);
+        i64 const cost = m_interval.count() * i64(n);
+        i64 tat = m_tat.load(std::memory_order_relaxed);
+        while (true) {
+            i64 const next = n2max(tat, at) + cost;
+            if (next - at > m_tolerance.count()) { return false; }
+            if (m_tat.compare_exchange_weak(tat, next,
+                                            std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    chrono::nanoseconds time_until_available(u64 n, chrono::nanoseconds now)
+    const noexcept {
+        if (n > m_burst) { return chrono::nanoseconds::max(); }
+        i64 const at   = _fine(now);
+        i64 const tat  = n2max(m_tat.load(std::memory_order_relaxed), at);
+        i64 const wait = tat + m_interval.count() * i64(n)
+                       - m_tolerance.count() - at;
+        return chrono::ceil<chrono::nanoseconds>(
+                   fine_duration { n2max(wait, i64 { 0 }) });
+    }
+
+    /** How many intervals of slack the schedule has left at `now`. */
+    u64 available(chrono::nanoseconds now) const noexcept {
+        i64 const at    = _fine(now);
+        i64 const tat   = n2max(m_tat.load(std::memory_order_relaxed), at);
+        i64 const slack = m_tolerance.count() - (tat - at);
+        return u64(n2max(slack, i64 { 0 }) / m_interval.count());
+    }
+
+    chrono::nanoseconds theoretical_arrival(chrono::nanoseconds now)
+    const noexcept {
+        i64 const tat = n2max(m_tat.load(std::memory_order_relaxed),
+                              _fine(now));
+        return m_origin + chrono::ceil<chrono::nanoseconds>(
+                              fine_duration { tat });
+    }
+
+    void reset() noexcept { m_tat.store(s_idle, std::memory_order_relaxed); }
+
+    fine_duration interval()  const noexcept { return m_interval; }
+    fine_duration tolerance() const noexcept { return m_tolerance; }
+    u64           burst()     const noexcept { return m_burst; }
+
+private:
+    /** A theoretical arrival time far enough in the past that any `now` has
+     *  caught up with it, without overflowing when compared.
+     */
+    static constexpr i64 s_idle = INT64_MIN / 4;
+
+    i64 _fine(chrono::nanoseconds now) const noexcept {
+        return chrono::duration_cast<fine_duration>(now - m_origin).count();
+    }
+
+    ALIGNAS(nonstd::cache_line_size) std::atomic<i64> m_tat { s_idle };
+    chrono::nanoseconds m_origin;
+    fine_duration       m_interval;
+    fine_duration       m_tolerance;
+    u64                 m_burst;
+};
+
+} /* namespace detail::rate_limiter_ */
+
+
+/** Token Bucket
+ *  ------------
+ *  Holds up to `burst` tokens, refilled at `rate`; starts full.
+ */
+class token_bucket {
+public:
+    template <typename Rep, typename Period>
+    token_bucket(chrono::frequency<Rep, Period> rate, u64 burst)
+        : m_schedule ( rate, burst )
+    { }
+
+    /** Take `n` tokens if they're all available; otherwise take none. */
+    bool try_acquire(u64 n = 1,
+                     chrono::nanoseconds now = wallclock::now()) noexcept {
+        return m_schedule.try_acquire(n, now);
+    }
+
+    /** How long until `n` tokens will be available, if no one else takes
+     *  any; zero if they are now, and `nanoseconds::max()` if `n` is more
+     *  than the bucket holds.
+     */
+    chrono::nanoseconds time_until_available(
+        u64 n = 1, chrono::nanoseconds now = wallclock::now()) const noexcept
+    {
+        return m_schedule.time_until_available(n, now);
+    }
+
+    /** The number of whole tokens in the bucket. */
+    u64 available(chrono::nanoseconds now = wallclock::now()) const noexcept {
+        return m_schedule.available(now);
+    }
+
+    /** Refill the bucket. */
+    void reset() noexcept { m_schedule.reset(); }
+
+    u64 capacity() const noexcept { return m_schedule.burst(); }
+    /** The time it takes to refill one token. */
+    chrono::nanoseconds refill_interval() const noexcept {
+        return chrono::round<chrono::nanoseconds>(m_schedule.interval());
+    }
+
+private:
+    detail::rate_limiter_::schedule m_schedule;
+};
+
+
+/** Generic Cell Rate Algorithm
+ *  ---------------------------
+ *  Admits events spaced by `1 / rate`, with up to `burst` intervals of
+ *  tolerance for events that arrive early.
+ */
+class gcra {
+public:
+    template <typename Rep, typename Period>
+    gcra(chrono::frequency<Rep, Period> rate, u64 burst)
+        : m_schedule ( rate, burst )
+    { }
+
+    /** Admit `n` events at once, if the schedule has room for all of them. */
+    bool try_acquire(u64 n = 1,
+                     chrono::nanoseconds now = wallclock::now()) noexcept {
+        return m_schedule.try_acquire(n, now);
+    }
+
+    /** How long until `n` events would be admitted, if no others are; zero
+     *  if they would be now, and `nanoseconds::max()` if `n` is more than
+     *  the burst allows.
+     */
+    chrono::nanoseconds time_until_available(
+        u64 n = 1, chrono::nanoseconds now = wallclock::now()) const noexcept
+    {
+        return m_schedule.time_until_available(n, now);
+    }
+
+    /** When the next event is due, on the ideal schedule; `now` if the
+     *  schedule has caught up.
+     */
+    chrono::nanoseconds theoretical_arrival(
+        chrono::nanoseconds now = wallclock::now()) const noexcept
+    {
+        return m_schedule.theoretical_arrival(now);
+    }
+
+    /** Forget all past events. */
+    void reset() noexcept { m_schedule.reset(); }
+
+    /** The ideal spacing of events; `1 / rate`. */
+    chrono::nanoseconds emission_interval() const noexcept {
+        return chrono::round<chrono::nanoseconds>(m_schedule.interval());
+    }
+    /** How far ahead of the ideal schedule events may run; `burst`
+     *  intervals.
+     */
+    chrono::nanoseconds tolerance() const noexcept {
+        return chrono::round<chrono::nanoseconds>(m_schedule.tolerance());
+    }
+
+private:
+    detail::rate_limiter_::schedule m_schedule;
+};
+
+} /* namespace nonstd */
@@ -0,0 +1,129 @@
+/** Rate Limiter Tests
+ *  ==================
+ *  GOAL: Validate that limiters admit an initial burst, then events at their
+ *  rate -- to within a few ppm, even when the interval isn't a whole number of
+ *  nanoseconds -- that they report correctly when the next events will be
+ *  admitted, and that concurrent acquisitions never admit more than the limit.
+ *
+ *  Most of these tests supply their own `now`, s.t. they're exact and don't
+ *  depend on the scheduler.
+ */
+
+#include <nonstd/rate_limiter.h>
+#include <platform/testrunner/testrunner.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/chrono.h>
+#include <nonstd/wallclock.h>
+
+
+namespace nonstd_test::rate_limiter {
+
+using nonstd::gcra;
+using nonstd::token_bucket;
+using nonstd::wallclock;
+using namespace nonstd::literals::chrono_literals;
+
+
+TEST_CASE("Rate Limiters", "[nonstd][time][rate_limiter]") {
+    SECTION("admit a burst, then one event per interval") {
+        auto const t0 = wallclock::now();
+        token_bucket bucket { 10_Hz, 3 };
+        REQUIRE(bucket.refill_interval() == 100ms);
+        REQUIRE(bucket.capacity() == 3);
+        REQUIRE(bucket.available(t0) == 3);
+
+        REQUIRE(bucket.try_acquire(1, t0));
+        REQUIRE(bucket.try_acquire(2, t0));
+        REQUIRE(bucket.available(t0) == 0);
+        REQUIRE_FALSE(bucket.try_acquire(1, t0));
+        REQUIRE(bucket.time_until_available(1, t0) == 100ms);
+        REQUIRE(bucket.time_until_available(2, t0) == 200ms);
+
+        REQUIRE_FALSE(bucket.try_acquire(1, t0 + 99ms));
+        REQUIRE(bucket.try_acquire(1, t0 + 100ms));
+        REQUIRE_FALSE(bucket.try_acquire(1, t0 + 150ms));
+        REQUIRE(bucket.time_until_available(1, t0 + 150ms) == 50ms);
+
+        // A quiet spell refills the bucket, but no further than its capacity.
+        REQUIRE(bucket.available(t0 + 10s) == 3);
+        REQUIRE(bucket.time_until_available(3, t0 + 10s) == 0ns);
+        REQUIRE(bucket.try_acquire(3, t0 + 10s));
+        REQUIRE_FALSE(bucket.try_acquire(1, t0 + 10s));
+
+        bucket.reset();
+        REQUIRE(bucket.available(t0 + 10s) == 3);
+    }
+
+    SECTION("never admit more than the burst at once") {
+        token_bucket bucket { 1_kHz, 5 };
+        REQUIRE_FALSE(bucket.try_acquire(6));
+        REQUIRE(bucket.time_until_available(6)
+                == std::chrono::nanoseconds::max());
+        REQUIRE(bucket.available() == 5);
+        REQUIRE(bucket.try_acquire(0));
+
+        REQUIRE_THROWS(token_bucket { 0_Hz, 5 });
+        REQUIRE_THROWS(token_bucket { 1_kHz, 0 });
+    }
+
+    SECTION("track fractional intervals without drifting much") {
+        auto const t0 = wallclock::now();
+        gcra limiter { 3_MHz, 2 };
+        REQUIRE(limiter.emission_interval() == 333ns);
+
+        // Acquire as soon as possible, for one simulated second; rounding the
+        // interval to 333ns would admit 3003 extra events, but rounding it to
+        // 1/64ns admits fewer than 50. (The burst of 2
+        // absorbs the simulated clock landing up to 1ns late, as it's rounded
+        // up to whole nanoseconds.)
+        u64 admitted = 0;
+        auto now = t0;
+        while (now < t0 + 1s) {
+            if (limiter.try_acquire(1, now)) { admitted += 1; }
+            else { now += limiter.time_until_available(1, now); }
+        }
+        REQUIRE(admitted >= 3'000'000);
+        REQUIRE(admitted <= 3'000'050);
+    }
+
+    SECTION("report the theoretical arrival time") {
+        auto const t0 = wallclock::now();
+        gcra limiter { 100_Hz, 4 };
+        REQUIRE(limiter.tolerance() == 40ms);
+        REQUIRE(limiter.theoretical_arrival(t0) - t0 < 1ns);
+        REQUIRE(limiter.try_acquire(4, t0));
+        REQUIRE(limiter.theoretical_arrival(t0) - t0 == 40ms);
+        REQUIRE_FALSE(limiter.try_acquire(1, t0 + 5ms));
+        REQUIRE(limiter.try_acquire(1, t0 + 10ms));
+        REQUIRE(limiter.theoretical_arrival(t0 + 10ms) - t0 == 50ms);
+    }
+
+    SECTION("admit exactly the limit across threads") {
+        auto const t0 = wallclock::now();
+        gcra limiter { 1_kHz, 100 };
+        std::atomic<u64> admitted { 0 };
+        std::vector<std::thread> threads;
+        for (u32 t = 0; t < 4; ++t) {
+            threads.emplace_back([&] {
+                // Everyone hammers the same simulated 50ms.
+                for (u32 i = 0; i < 20'000; ++i) {
+                    auto const now = t0 + 2500ns * i;
+                    admitted += limiter.try_acquire(1, now);
+                }
+            });
+        }
+        for (auto & thread : threads) { thread.join(); }
+        // The burst, plus one per millisecond of the time that the last
+        // acquisition might have seen.
+        REQUIRE(admitted >= 100);
+        REQUIRE(admitted <= 100 + 50 + 1);
+    }
+}
+
+} /* namespace nonstd_test::rate_limiter */
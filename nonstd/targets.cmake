@@ -1,5 +1,7 @@
 # Targets listing for nonstd
 # ==========================
+include(${CMAKE_CURRENT_LIST_DIR}/benchmark.cmake)
+
 pm_autotarget(
     NAME nonstd
     HEADERS nonstd.h
@@ -13,6 +15,13 @@ if(PM_OS_LINUX)
     target_link_libraries(nonstd.nonstd INTERFACE pthread)
 endif()
 
+pm_autotarget(
+    NAME adaptors
+    HEADERS adaptors.h
+    DEPENDS
+        nonstd::nonstd
+)
+
 pm_autotarget(
     NAME angle
     HEADERS angle.h
@@ -21,6 +30,37 @@ pm_autotarget(
         nonstd::cx_math
 )
 
+pm_autotarget(
+    NAME benchmark
+    HEADERS benchmark.h
+    DEPENDS
+        nonstd::nonstd
+        nonstd::chrono
+        nonstd::json_string
+        nonstd::tsc_clock
+        nonstd::wallclock
+)
+
+pm_autotarget(
+    NAME cancellation
+    HEADERS cancellation.h
+    DEPENDS
+        nonstd::nonstd
+        nonstd::chrono
+        nonstd::wallclock
+)
+
+pm_autotarget(
+    NAME channel
+    HEADERS channel.h
+    DEPENDS
+        nonstd::nonstd
+        nonstd::future
+        nonstd::futex
+        nonstd::mpmc_queue
+        nonstd::optional
+)
+
 pm_autotarget(
     NAME chrono
     HEADERS chrono.h
@@ -28,6 +68,15 @@ pm_autotarget(
         nonstd::nonstd
 )
 
+pm_autotarget(
+    NAME coarse_clock
+    HEADERS coarse_clock.h
+    DEPENDS
+        nonstd::nonstd
+        nonstd::chrono
+        nonstd::wallclock
+)
+
 pm_autotarget(
     NAME color
     HEADERS color.h
@@ -36,6 +85,24 @@ pm_autotarget(
         nonstd::angle
 )
 
+pm_autotarget(
+    NAME compact_optional
+    HEADERS compact_optional.h
+    DEPENDS
+        nonstd::nonstd
+        nonstd::optional
+        nonstd::utility_ext
+)
+
+pm_autotarget(
+    NAME concurrent_lazy
+    HEADERS concurrent_lazy.h
+    DEPENDS
+        nonstd::nonstd
+        nonstd::futex
+        nonstd::optional_storage
+)
+
 pm_autotarget(
     NAME cx_math
     HEADERS cx_math.h
@@ -48,6 +115,22 @@ pm_autotarget(
         nonstd::nonstd
 )
 
+pm_autotarget(
+    NAME expected
+    HEADERS expected.h
+    DEPENDS
+        nonstd::nonstd
+        nonstd::utility_ext
+)
+
+pm_autotarget(
+    NAME fiber
+    HEADERS fiber.h
+    DEPENDS
+        nonstd::nonstd
+        nonstd::windows
+)
+
 pm_autotarget(
     NAME four_char_code
     HEADERS four_char_code.h
@@ -55,11 +138,30 @@ pm_autotarget(
         nonstd::nonstd
 )
 
+pm_autotarget(
+    NAME frame_pacer
+    HEADERS frame_pacer.h
+    DEPENDS
+        nonstd::nonstd
+        nonstd::chrono
+        nonstd::wallclock
+)
+
+pm_autotarget(
+    NAME futex
+    HEADERS futex.h
+    DEPENDS
+        nonstd::nonstd
+        nonstd::chrono
+        nonstd::windows
+)
+
 pm_autotarget(
     NAME future
     HEADERS future.h
     DEPENDS
         nonstd::nonstd
+        nonstd::cancellation
         nonstd::chrono
         nonstd::optional
 )
@@ -71,6 +173,34 @@ pm_autotarget(
         nonstd::nonstd
 )
 
+pm_autotarget(
+    NAME incremental
+    HEADERS incremental.h
+    DEPENDS
+        nonstd::nonstd
+        nonstd::optional_storage
+        nonstd::scope_guard
+)
+
+pm_autotarget(
+    NAME job_system
+    HEADERS job_system.h
+    DEPENDS
+        nonstd::nonstd
+        nonstd::cancellation
+        nonstd::chrono
+        nonstd::fiber
+        nonstd::mpmc_queue
+        nonstd::wallclock
+)
+
+pm_autotarget(
+    NAME json_string
+    HEADERS json_string.h
+    DEPENDS
+        nonstd::nonstd
+)
+
 pm_autotarget(
     NAME keyboard
     HEADERS keyboard.h
@@ -78,6 +208,16 @@ pm_autotarget(
         nonstd::nonstd
 )
 
+pm_autotarget(
+    NAME latency_histogram
+    HEADERS latency_histogram.h
+    DEPENDS
+        nonstd::nonstd
+        nonstd::chrono
+        nonstd::four_char_code
+        nonstd::math
+)
+
 pm_autotarget(
     NAME lazy
     HEADERS lazy.h
@@ -93,6 +233,25 @@ pm_autotarget(
         nonstd::nonstd
 )
 
+pm_autotarget(
+    NAME memoize
+    HEADERS memoize.h
+    DEPENDS
+        nonstd::nonstd
+        nonstd::hash
+        nonstd::optional_storage
+)
+
+pm_autotarget(
+    NAME mpmc_queue
+    HEADERS mpmc_queue.h
+    DEPENDS
+        nonstd::nonstd
+        nonstd::math
+        nonstd::optional
+        nonstd::optional_storage
+)
+
 pm_autotarget(
     NAME optional
     HEADERS optional.h
@@ -105,6 +264,15 @@ pm_autotarget(
         nonstd::valid_expression_tester
 )
 
+pm_autotarget(
+    NAME optional_array
+    HEADERS optional_array.h
+    DEPENDS
+        nonstd::nonstd
+        nonstd::math
+        nonstd::optional
+)
+
 pm_autotarget(
     NAME optional_storage
     HEADERS optional_storage.h
@@ -112,6 +280,16 @@ pm_autotarget(
         nonstd::utility_ext
 )
 
+pm_autotarget(
+    NAME parallel
+    HEADERS parallel.h
+    DEPENDS
+        nonstd::nonstd
+        nonstd::job_system
+        nonstd::optional_storage
+        nonstd::range_nd
+)
+
 pm_autotarget(
     NAME predicate
     HEADERS predicate.h
@@ -120,6 +298,33 @@ pm_autotarget(
         nonstd::utility_ext
 )
 
+pm_autotarget(
+    NAME profile
+    HEADERS profile.h
+    DEPENDS
+        nonstd::nonstd
+        nonstd::chrono
+        nonstd::json_string
+        nonstd::wallclock
+)
+
+pm_autotarget(
+    NAME range_nd
+    HEADERS range_nd.h
+    DEPENDS
+        nonstd::nonstd
+        nonstd::math
+)
+
+pm_autotarget(
+    NAME rate_limiter
+    HEADERS rate_limiter.h
+    DEPENDS
+        nonstd::nonstd
+        nonstd::chrono
+        nonstd::wallclock
+)
+
 pm_autotarget(
     NAME scope_guard
     HEADERS scope_guard.h
@@ -130,6 +335,36 @@ pm_autotarget(
     HEADERS special_member_filters.h
 )
 
+pm_autotarget(
+    NAME task_graph
+    HEADERS task_graph.h
+    DEPENDS
+        nonstd::nonstd
+        nonstd::chrono
+        nonstd::job_system
+        nonstd::wallclock
+)
+
+pm_autotarget(
+    NAME timer_wheel
+    HEADERS timer_wheel.h
+    DEPENDS
+        nonstd::nonstd
+        nonstd::cancellation
+        nonstd::chrono
+        nonstd::math
+        nonstd::optional_storage
+        nonstd::wallclock
+)
+
+pm_autotarget(
+    NAME tsc_clock
+    HEADERS tsc_clock.h
+    DEPENDS
+        nonstd::nonstd
+        nonstd::chrono
+)
+
 pm_autotarget(
     NAME type_name
     HEADERS type_name.h
@@ -166,6 +401,7 @@ pm_autotarget(
     DEPENDS
         nonstd::nonstd
         nonstd::chrono
+        nonstd::tsc_clock
 )
 
 pm_autotarget(
@@ -178,6 +414,14 @@ pm_autotarget(
 
 # Tests for nonstd
 # ================
+n2_platform_test(
+    NAME adaptors.test
+    SOURCES adaptors.test.cc
+    DEPENDS
+        nonstd::adaptors
+        platform::testrunner
+)
+
 n2_platform_test(
     NAME angle.test
     SOURCES angle.test.cc
@@ -186,6 +430,43 @@ n2_platform_test(
         platform::testrunner
 )
 
+n2_platform_test(
+    NAME benchmark.test
+    SOURCES benchmark.test.cc
+    DEPENDS
+        nonstd::benchmark
+        nonstd::chrono
+        platform::testrunner
+)
+
+n2_platform_test(
+    NAME cancellation.test
+    SOURCES cancellation.test.cc
+    DEPENDS
+        nonstd::cancellation
+        nonstd::future
+        nonstd::job_system
+        nonstd::timer_wheel
+        platform::testrunner
+)
+
+n2_platform_test(
+    NAME channel.test
+    SOURCES channel.test.cc
+    DEPENDS
+        nonstd::channel
+        nonstd::wallclock
+        platform::testrunner
+)
+
+n2_platform_test(
+    NAME coarse_clock.test
+    SOURCES coarse_clock.test.cc
+    DEPENDS
+        nonstd::coarse_clock
+        platform::testrunner
+)
+
 n2_platform_test(
     NAME color.test
     SOURCES color.test.cc
@@ -194,6 +475,25 @@ n2_platform_test(
         platform::testrunner
 )
 
+n2_platform_test(
+    NAME compact_optional.test
+    SOURCES compact_optional.test.cc
+    DEPENDS
+        nonstd::compact_optional
+        nonstd::wallclock
+        platform::testrunner
+)
+
+n2_platform_test(
+    NAME concurrent_lazy.test
+    SOURCES concurrent_lazy.test.cc
+    DEPENDS
+        nonstd::concurrent_lazy
+        nonstd::lazy
+        nonstd::wallclock
+        platform::testrunner
+)
+
 n2_platform_test(
     NAME cx_math.test
     SOURCES cx_math.test.cc
@@ -209,6 +509,56 @@ n2_platform_test(
         platform::testrunner
 )
 
+n2_platform_test(
+    NAME expected.test
+    SOURCES expected.test.cc
+    DEPENDS
+        nonstd::expected
+        nonstd::wallclock
+        platform::testrunner
+)
+
+n2_platform_test(
+    NAME frame_pacer.test
+    SOURCES frame_pacer.test.cc
+    DEPENDS
+        nonstd::frame_pacer
+        platform::testrunner
+)
+
+n2_platform_test(
+    NAME incremental.test
+    SOURCES incremental.test.cc
+    DEPENDS
+        nonstd::incremental
+        platform::testrunner
+)
+
+n2_platform_test(
+    NAME job_system.test
+    SOURCES job_system.test.cc
+    DEPENDS
+        nonstd::job_system
+        platform::testrunner
+)
+
+n2_platform_test(
+    NAME json_string.test
+    SOURCES json_string.test.cc
+    DEPENDS
+        nonstd::json_string
+        platform::testrunner
+)
+
+n2_platform_test(
+    NAME latency_histogram.test
+    SOURCES latency_histogram.test.cc
+    DEPENDS
+        nonstd::latency_histogram
+        nonstd::wallclock
+        platform::testrunner
+)
+
 n2_platform_test(
     NAME lazy.test
     SOURCES lazy.test.cc
@@ -225,6 +575,32 @@ n2_platform_test(
         platform::testrunner
 )
 
+n2_platform_test(
+    NAME memoize.test
+    SOURCES memoize.test.cc
+    DEPENDS
+        nonstd::memoize
+        platform::testrunner
+)
+
+n2_platform_test(
+    NAME mpmc_queue.test
+    SOURCES mpmc_queue.test.cc
+    DEPENDS
+        nonstd::mpmc_queue
+        platform::testrunner
+)
+
+n2_platform_test(
+    NAME optional_array.test
+    SOURCES optional_array.test.cc
+    DEPENDS
+        nonstd::optional_array
+        nonstd::optional
+        nonstd::wallclock
+        platform::testrunner
+)
+
 n2_platform_test(
     NAME optional_storage.test
     SOURCES optional_storage.test.cc
@@ -243,6 +619,14 @@ n2_platform_test(
         platform::testrunner
 )
 
+n2_platform_test(
+    NAME parallel.test
+    SOURCES parallel.test.cc
+    DEPENDS
+        nonstd::parallel
+        platform::testrunner
+)
+
 n2_platform_test(
     NAME predicate.test
     SOURCES predicate.test.cc
@@ -251,6 +635,31 @@ n2_platform_test(
         platform::testrunner
 )
 
+n2_platform_test(
+    NAME profile.test
+    SOURCES profile.test.cc
+    DEPENDS
+        nonstd::profile
+        platform::testrunner
+)
+
+n2_platform_test(
+    NAME range_nd.test
+    SOURCES range_nd.test.cc
+    DEPENDS
+        nonstd::range_nd
+        nonstd::wallclock
+        platform::testrunner
+)
+
+n2_platform_test(
+    NAME rate_limiter.test
+    SOURCES rate_limiter.test.cc
+    DEPENDS
+        nonstd::rate_limiter
+        platform::testrunner
+)
+
 n2_platform_test(
     NAME scope_guard.test
     SOURCES scope_guard.test.cc
@@ -267,6 +676,32 @@ n2_platform_test(
         platform::testrunner
 )
 
+n2_platform_test(
+    NAME task_graph.test
+    SOURCES task_graph.test.cc
+    DEPENDS
+        nonstd::task_graph
+        platform::testrunner
+)
+
+n2_platform_test(
+    NAME timer_wheel.test
+    SOURCES timer_wheel.test.cc
+    DEPENDS
+        nonstd::timer_wheel
+        platform::testrunner
+)
+
+n2_platform_test(
+    NAME tsc_clock.test
+    SOURCES tsc_clock.test.cc
+    DEPENDS
+        nonstd::tsc_clock
+        nonstd::chrono
+        nonstd::wallclock
+        platform::testrunner
+)
+
 n2_platform_test(
     NAME valid_expression_tester.test
     SOURCES valid_expression_tester.test.cc
@@ -282,3 +717,113 @@ n2_platform_test(
         nonstd::wallclock
         platform::testrunner
 )
+
+
+# Benchmarks for nonstd
+# =====================
+n2_platform_benchmark(
+    NAME angle.bench
+    SOURCES angle.bench.cc
+    DEPENDS
+        nonstd::angle
+)
+
+n2_platform_benchmark(
+    NAME channel.bench
+    SOURCES channel.bench.cc
+    DEPENDS
+        nonstd::channel
+)
+
+n2_platform_benchmark(
+    NAME coarse_clock.bench
+    SOURCES coarse_clock.bench.cc
+    DEPENDS
+        nonstd::coarse_clock
+)
+
+n2_platform_benchmark(
+    NAME compact_optional.bench
+    SOURCES compact_optional.bench.cc
+    DEPENDS
+        nonstd::compact_optional
+)
+
+n2_platform_benchmark(
+    NAME concurrent_lazy.bench
+    SOURCES concurrent_lazy.bench.cc
+    DEPENDS
+        nonstd::concurrent_lazy
+        nonstd::lazy
+)
+
+n2_platform_benchmark(
+    NAME expected.bench
+    SOURCES expected.bench.cc
+    DEPENDS
+        nonstd::expected
+)
+
+n2_platform_benchmark(
+    NAME frame_pacer.bench
+    SOURCES frame_pacer.bench.cc
+    DEPENDS
+        nonstd::frame_pacer
+)
+
+n2_platform_benchmark(
+    NAME latency_histogram.bench
+    SOURCES latency_histogram.bench.cc
+    DEPENDS
+        nonstd::latency_histogram
+)
+
+n2_platform_benchmark(
+    NAME optional.bench
+    SOURCES optional.bench.cc
+    DEPENDS
+        nonstd::optional
+)
+
+n2_platform_benchmark(
+    NAME optional_array.bench
+    SOURCES optional_array.bench.cc
+    DEPENDS
+        nonstd::optional_array
+)
+
+n2_platform_benchmark(
+    NAME profile.bench
+    SOURCES profile.bench.cc
+    DEPENDS
+        nonstd::profile
+)
+
+n2_platform_benchmark(
+    NAME range.bench
+    SOURCES core/range.bench.cc
+    DEPENDS
+        nonstd::core::range
+)
+
+n2_platform_benchmark(
+    NAME range_nd.bench
+    SOURCES range_nd.bench.cc
+    DEPENDS
+        nonstd::range_nd
+)
+
+n2_platform_benchmark(
+    NAME rate_limiter.bench
+    SOURCES rate_limiter.bench.cc
+    DEPENDS
+        nonstd::rate_limiter
+)
+
+n2_platform_benchmark(
+    NAME tsc_clock.bench
+    SOURCES tsc_clock.bench.cc
+    DEPENDS
+        nonstd::tsc_clock
+        nonstd::wallclock
+)
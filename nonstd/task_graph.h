@@ -0,0 +1,286 @@
+/** Task Graphs
+ *  ===========
+ *  A fixed DAG of tasks that's built once, compiled, and then run as often as
+ *  needed -- e.g. once per frame -- on a `job_system`, with every task starting
+ *  as soon as all of its predecessors have finished.
+ *
+ *      nonstd::task_graph_builder builder;
+ *      auto input   = builder.add("input",   [&] { poll_input(); });
+ *      auto physics = builder.add("physics", [&] { step_physics(); }, {input});
+ *      auto ai      = builder.add("ai",      [&] { think(); },        {input});
+ *      builder.add("render", [&] { render(); }, {physics, ai});
+ *      nonstd::task_graph frame = std::move(builder).compile();
+ *
+ *      while (running) { frame.run(jobs); }
+ *
+ *  Compiling checks the graph for cycles, and flattens it into arrays; each
+ *  node's successors are a contiguous run of indices, and each node has an
+ *  atomic count of unfinished predecessors. Running the graph resets those
+ *  counts, queues the roots, and lets every finishing task decrement its
+ *  successors' counts, queueing any that reach zero. Nothing is allocated
+ *  after `compile`.
+ *
+ *  Every run records the start time (relative to the start of the run) and
+ *  duration of each node, measured with `wallclock`.
+ *
+ *  Task bodies must not throw. A graph must not be run concurrently with
+ *  itself, but may be run from inside a job.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/chrono.h>
+#include <nonstd/job_system.h>
+#include <nonstd/wallclock.h>
+
+
+namespace nonstd {
+
+class task_graph;
+
+
+/** Task Graph Builder
+ *  ------------------
+ */
+class task_graph_builder {
+public:
+    using node_id = u32;
+
+private:
+    struct node {
+        std::string           name;
+        std::function<void()> work;
+        std::vector<node_id>  predecessors;
+    };
+
+    std::vector<node> m_nodes;
+
+    friend class task_graph;
+
+public:
+    /** Add a task that runs `work()` after every one of `predecessors`. */
+    template <typename Fn>
+    node_id add(std::string name, Fn && work,
+                std::initializer_list<node_id> predecessors = { }) {
+        auto const id = static_cast<node_id>(m_nodes.size());
+        m_nodes.push_back(node { std::move(name),
+                                 std::forward<Fn>(work),
+                                 { } });
+        for (auto p : predecessors) { depends_on(id, p); }
+        return id;
+    }
+
+    /** Declare that `successor` must run after `predecessor`. */
+    void depends_on(node_id successor, node_id predecessor) {
+        BREAK_IF(successor >= m_nodes.size() || predecessor >= m_nodes.size(),
+                 nonstd::error::pebcak,
+                 "Task graph edge {} -> {} refers to a node that doesn't exist "
+                 "({} nodes)", predecessor, successor, m_nodes.size());
+        m_nodes[successor].predecessors.push_back(predecessor);
+    }
+
+    u32 size() const noexcept { return static_cast<u32>(m_nodes.size()); }
+
+    inline task_graph compile() &&;
+};
+
+
+/** Task Graph
+ *  ----------
+ */
+class task_graph {
+public:
+    using node_id = task_graph_builder::node_id;
+
+    struct node_timing {
+        chrono::nanoseconds start;
+        chrono::nanoseconds duration;
+    };
+
+private:
+    struct ALIGNAS(cache_line_size) pending_count {
+        std::atomic<u32> value { 0 };
+    };
+
+    /** What each node's job is given; where to find the graph, and which node
+     *  it's running. Re-pointed at the graph on every run, s.t. compiled graphs
+     *  can be moved.
+     */
+    struct job_arg {
+        task_graph * graph;
+        node_id      index;
+    };
+
+    struct run_state {
+        job_system *        jobs = nullptr;
+        chrono::nanoseconds start { 0 };
+        job_counter         counter;
+    };
+
+    std::vector<std::string>           m_names;
+    std::vector<std::function<void()>> m_work;
+    std::vector<u32>                   m_in_degree;
+    std::vector<u32>                   m_successor_offsets;
+    std::vector<node_id>               m_successors;
+    std::vector<node_id>               m_roots;
+    std::vector<node_id>               m_order;
+    std::vector<job_arg>               m_args;
+    std::vector<node_timing>           m_timings;
+    std::unique_ptr<pending_count[]>   m_pending;
+    std::unique_ptr<run_state>         m_run;
+    chrono::nanoseconds                m_last_run_duration { 0 };
+
+    friend class task_graph_builder;
+    task_graph() = default;
+
+    static void run_node(void * data) {
+        auto const & arg = *static_cast<job_arg *>(data);
+        task_graph & self = *arg.graph;
+        run_state & run = *self.m_run;
+
+        auto const start = wallclock::now();
+        self.m_work[arg.index]();
+        auto const end = wallclock::now();
+        self.m_timings[arg.index] = node_timing { start - run.start,
+                                                  end - start };
+
+        u32 const first = self.m_successor_offsets[arg.index];
+        u32 const last  = self.m_successor_offsets[arg.index + 1];
+        for (u32 i = first; i < last; ++i) {
+            node_id const next = self.m_successors[i];
+            if (self.m_pending[next].value.fetch_sub(
+                    1, std::memory_order_acq_rel) == 1) {
+                run.jobs->run_job(job_decl { &run_node, &self.m_args[next] },
+                                  &run.counter);
+            }
+        }
+    }
+
+public:
+    task_graph(task_graph &&) = default;
+    task_graph& operator= (task_graph &&) = default;
+    task_graph(task_graph const &) = delete;
+    task_graph& operator= (task_graph const &) = delete;
+
+    u32 size() const noexcept { return static_cast<u32>(m_names.size()); }
+
+    std::string const & name(node_id node) const { return m_names[node]; }
+
+    /** A valid serial execution order for the graph. */
+    std::vector<node_id> const & topological_order() const noexcept {
+        return m_order;
+    }
+
+    /** Timings of `node` during the most recent run. */
+    node_timing timing(node_id node) const { return m_timings[node]; }
+
+    /** Wall time of the most recent run, start to finish. */
+    chrono::nanoseconds last_run_duration() const noexcept {
+        return m_last_run_duration;
+    }
+
+    /** Run every task on `jobs`, and wait for them all to finish. */
+    void run(job_system & jobs) {
+        if (size() == 0) { return; }
+        m_run->jobs  = &jobs;
+        m_run->start = wallclock::now();
+        for (node_id i = 0; i < size(); ++i) {
+            m_pending[i].value.store(m_in_degree[i], std::memory_order_relaxed);
+            m_args[i].graph = this;
+        }
+        for (auto root : m_roots) {
+            jobs.run_job(job_decl { &run_node, &m_args[root] },
+                         &m_run->counter);
+        }
+        jobs.wait_for_counter(m_run->counter);
+        m_last_run_duration = wallclock::now() - m_run->start;
+    }
+
+    /** Run every task on the calling thread, in topological order. */
+    void run_serial() {
+        m_run->start = wallclock::now();
+        for (auto index : m_order) {
+            auto const start = wallclock::now();
+            m_work[index]();
+            m_timings[index] = node_timing { start - m_run->start,
+                                             wallclock::now() - start };
+        }
+        m_last_run_duration = wallclock::now() - m_run->start;
+    }
+};
+
+
+/** Compile the builder's graph. Breaks if the graph contains a cycle. */
+inline task_graph task_graph_builder::compile() && {
+    task_graph graph;
+    u32 const count = size();
+
+    graph.m_names.reserve(count);
+    graph.m_work.reserve(count);
+    graph.m_in_degree.assign(count, 0);
+    graph.m_successor_offsets.assign(count + 1, 0);
+    for (auto & n : m_nodes) {
+        graph.m_names.push_back(std::move(n.name));
+        graph.m_work.push_back(std::move(n.work));
+    }
+
+    // Count each node's successors, prefix-sum them into offsets, then fill.
+    for (node_id i = 0; i < count; ++i) {
+        graph.m_in_degree[i] = static_cast<u32>(m_nodes[i].predecessors.size());
+        for (auto p : m_nodes[i].predecessors) {
+            graph.m_successor_offsets[p + 1] += 1;
+        }
+    }
+    for (node_id i = 0; i < count; ++i) {
+        graph.m_successor_offsets[i + 1] += graph.m_successor_offsets[i];
+    }
+    graph.m_successors.resize(graph.m_successor_offsets[count]);
+    std::vector<u32> cursor (graph.m_successor_offsets.begin(),
+                             graph.m_successor_offsets.end() - 1);
+    for (node_id i = 0; i < count; ++i) {
+        for (auto p : m_nodes[i].predecessors) {
+            graph.m_successors[cursor[p]++] = i;
+        }
+    }
+
+    // Kahn's algorithm; finds the roots, a serial order, and any cycles.
+    std::vector<u32> remaining = graph.m_in_degree;
+    graph.m_order.reserve(count);
+    for (node_id i = 0; i < count; ++i) {
+        if (remaining[i] == 0) {
+            graph.m_roots.push_back(i);
+            graph.m_order.push_back(i);
+        }
+    }
+    for (u32 head = 0; head < graph.m_order.size(); ++head) {
+        node_id const n = graph.m_order[head];
+        for (u32 i = graph.m_successor_offsets[n];
+             i < graph.m_successor_offsets[n + 1]; ++i) {
+            node_id const next = graph.m_successors[i];
+            if (--remaining[next] == 0) { graph.m_order.push_back(next); }
+        }
+    }
+    BREAK_IF(graph.m_order.size() != count, nonstd::error::pebcak,
+             "Task graph contains a cycle ({} of {} nodes are reachable "
+             "without one)", graph.m_order.size(), count);
+
+    graph.m_args.resize(count, task_graph::job_arg { nullptr, 0 });
+    for (node_id i = 0; i < count; ++i) { graph.m_args[i].index = i; }
+    graph.m_timings.assign(count, task_graph::node_timing { });
+    graph.m_pending = std::make_unique<task_graph::pending_count[]>(count);
+    graph.m_run     = std::make_unique<task_graph::run_state>();
+
+    m_nodes.clear();
+    return graph;
+}
+
+} /* namespace nonstd */
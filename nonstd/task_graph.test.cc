@@ -0,0 +1,112 @@
+/** Task Graph Tests
+ *  ================
+ *  GOAL: Validate that every task runs exactly once per run, never before any
+ *  of its predecessors has finished, and that compiled graphs can be re-run.
+ */
+
+#include <nonstd/task_graph.h>
+#include <platform/testrunner/testrunner.h>
+
+#include <atomic>
+#include <system_error>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+
+
+namespace nonstd_test::task_graph {
+
+using nonstd::job_system;
+using nonstd::task_graph;
+using nonstd::task_graph_builder;
+
+
+TEST_CASE("Task Graphs", "[nonstd][task_graph]") {
+    job_system::config cfg;
+    cfg.worker_count = 3;
+    cfg.fiber_count  = 32;
+    job_system jobs { cfg };
+
+    SECTION("run tasks after all of their predecessors") {
+        // A layered graph; every node in a layer depends on every node in the
+        // layer before it. Each node records the step at which it finished.
+        u32 const layers = 5;
+        u32 const width  = 6;
+        std::atomic<u32> step { 0 };
+        std::vector<std::atomic<u32>> finished (layers * width);
+        std::vector<std::atomic<u32>> runs (layers * width);
+
+        task_graph_builder builder;
+        for (u32 l = 0; l < layers; ++l) {
+            for (u32 w = 0; w < width; ++w) {
+                u32 const id = l * width + w;
+                auto node = builder.add("node", [&, id] {
+                    runs[id].fetch_add(1);
+                    finished[id].store(step.fetch_add(1) + 1);
+                });
+                REQUIRE(node == id);
+                if (l > 0) {
+                    for (u32 p = 0; p < width; ++p) {
+                        builder.depends_on(id, (l - 1) * width + p);
+                    }
+                }
+            }
+        }
+        task_graph graph = std::move(builder).compile();
+        REQUIRE(graph.size() == layers * width);
+
+        for (u32 run = 1; run <= 3; ++run) {
+            graph.run(jobs);
+            // Every finish step in a layer is later than every finish step
+            // in the layer before it.
+            for (u32 l = 1; l < layers; ++l) {
+                u32 latest_before = 0;
+                u32 earliest      = ~u32{0};
+                for (u32 w = 0; w < width; ++w) {
+                    latest_before = n2max(latest_before,
+                                          finished[(l - 1) * width + w].load());
+                    earliest = n2min(earliest, finished[l * width + w].load());
+                }
+                REQUIRE(earliest > latest_before);
+            }
+            for (auto const & r : runs) { REQUIRE(r.load() == run); }
+        }
+    }
+
+    SECTION("record per-node timings") {
+        task_graph_builder builder;
+        auto a = builder.add("a", [] { nonstd::wallclock::delay(
+                                           std::chrono::milliseconds(2)); });
+        builder.add("b", [] { }, { a });
+        auto graph = std::move(builder).compile();
+        graph.run(jobs);
+
+        REQUIRE(graph.name(0) == "a");
+        REQUIRE(graph.timing(0).duration >= std::chrono::milliseconds(2));
+        REQUIRE(graph.timing(1).start >= graph.timing(0).duration);
+        REQUIRE(graph.last_run_duration() >= graph.timing(0).duration);
+    }
+
+    SECTION("provide a serial order") {
+        std::vector<u32> order;
+        task_graph_builder builder;
+        auto c = builder.add("c", [&] { order.push_back(2); });
+        auto b = builder.add("b", [&] { order.push_back(1); });
+        auto a = builder.add("a", [&] { order.push_back(0); });
+        builder.depends_on(b, a);
+        builder.depends_on(c, b);
+        auto graph = std::move(builder).compile();
+        graph.run_serial();
+        REQUIRE(order == std::vector<u32> { 0, 1, 2 });
+    }
+
+    SECTION("reject cycles") {
+        task_graph_builder builder;
+        auto a = builder.add("a", [] { });
+        auto b = builder.add("b", [] { }, { a });
+        builder.depends_on(a, b);
+        REQUIRE_THROWS_AS(std::move(builder).compile(), std::system_error);
+    }
+}
+
+} /* namespace nonstd_test::task_graph */
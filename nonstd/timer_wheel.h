@@ -0,0 +1,397 @@
+/** Hierarchical Timer Wheel
+ *  ========================
+ *  A store of pending timeouts with O(1) schedule and cancel, and expiry that
+ *  costs O(1) per tick plus O(1) per expired timer. Built for very large
+ *  numbers of short-lived timers -- retries, cooldowns, request timeouts --
+ *  that are usually cancelled long before they fire.
+ *
+ *  Time is measured in ticks of a fixed duration, given as a frequency;
+ *
+ *      nonstd::timer_wheel<request_id> timeouts { 1000_Hz };
+ *      auto handle = timeouts.schedule_after(250ms, id);
+ *      ...
+ *      timeouts.cancel(handle);
+ *      ...
+ *      timeouts.poll([](request_id id) { fail_request(id); });
+ *
+ *  There are four levels of 256 slots. Level 0 holds timers due within 256
+ *  ticks of the wheel's current tick, one slot per tick. Each level above it
+ *  covers 256 times the span of the level below, at 256 times the coarseness.
+ *  Whenever the low bits of the current tick wrap, the matching slot of the
+ *  next level up is "cascaded" -- its timers are re-filed into lower levels.
+ *  Timers further out than 2^32 ticks are parked in the top level and re-filed
+ *  until they come into range.
+ *
+ *  Timers are stored in a slab of nodes, linked into their slot by index, and
+ *  identified by a `{ index, generation }` handle s.t. cancelling a timer that
+ *  has already fired -- or been cancelled -- is a checked no-op.
+ *
+ *  Expiry never fires a timer early. A timer scheduled `d` from now fires on
+ *  the first tick at least `d` after the tick currently being waited on, so it
+ *  may fire up to one tick late (plus however late the wheel is polled).
+ *
+ *  The wheel is not thread safe. Expiry callbacks may schedule and cancel
+ *  timers, but may not advance the wheel.
+ */
+
+#pragma once
+
+#include <array>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/cancellation.h>
+#include <nonstd/chrono.h>
+#include <nonstd/math.h>
+#include <nonstd/optional_storage.h>
+#include <nonstd/wallclock.h>
+
+
+namespace nonstd {
+
+template <typename T>
+class timer_wheel {
+public:
+    static constexpr u32 level_count = 4;
+    static constexpr u32 slot_bits   = 8;
+    static constexpr u32 slot_count  = 1u << slot_bits;
+    static constexpr u64 max_span    = u64{1} << (slot_bits * level_count);
+
+    /** Identifies a scheduled timer. Default constructed handles are invalid,
+     *  and can be safely cancelled.
+     */
+    struct handle {
+        u32 index      = ~u32{0};
+        u32 generation = 0;
+
+        constexpr bool valid() const noexcept { return index != ~u32{0}; }
+    };
+
+private:
+    static constexpr u32 nil          = ~u32{0};
+    static constexpr u16 free_list    = 0xFFFF;
+    static constexpr u16 expiring     = level_count * slot_count;
+    static constexpr u32 list_count   = level_count * slot_count + 1;
+    static constexpr u64 slot_mask    = slot_count - 1;
+
+    struct node {
+        u64                 expiry;
+        u32                 prev;
+        u32                 next;
+        u32                 generation;
+        u16                 list;
+        optional_storage<T> value;
+    };
+
+    chrono::nanoseconds         m_tick;
+    chrono::nanoseconds         m_origin;
+    u64                         m_next_tick;
+    u64                         m_size;
+    u32                         m_free_head;
+    bool                        m_advancing;
+    std::vector<node>           m_nodes;
+    std::array<u32, list_count> m_heads;
+    std::array<u64, slot_count / 64> m_occupied;
+
+public:
+    /** Construct a wheel that ticks at `tick_rate`. Tick zero is `origin`. */
+    template <typename Rep, typename Period>
+    explicit timer_wheel(chrono::frequency<Rep, Period> tick_rate,
+                         chrono::nanoseconds origin = wallclock::now(),
+                         size_t reserve = 0)
+        : m_tick      ( chrono::duration_of<chrono::nanoseconds>(tick_rate) )
+        , m_origin    ( origin )
+        , m_next_tick ( 0 )
+        , m_size      ( 0 )
+        , m_free_head ( nil )
+        , m_advancing ( false )
+        , m_nodes     ( )
+        , m_heads     ( )
+        , m_occupied  ( )
+    {
+        BREAK_IF(m_tick <= chrono::nanoseconds::zero(), nonstd::error::pebcak,
+                 "Timer wheel tick rates must be positive, and no faster than "
+                 "1GHz (got a {}ns tick)", m_tick.count());
+        m_heads.fill(nil);
+        m_nodes.reserve(reserve);
+    }
+
+    timer_wheel(timer_wheel const &) = delete;
+    timer_wheel& operator= (timer_wheel const &) = delete;
+    timer_wheel(timer_wheel &&) = default;
+    timer_wheel& operator= (timer_wheel &&) = default;
+
+    /** Number of pending timers. */
+    u64  size()  const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+
+    chrono::nanoseconds tick_duration() const noexcept { return m_tick; }
+
+    /** The next tick that will be processed. */
+    u64 current_tick() const noexcept { return m_next_tick; }
+
+    /** The `wallclock` time at which the next tick is due. */
+    chrono::nanoseconds next_tick_time() const noexcept {
+        return m_origin + m_tick * static_cast<i64>(m_next_tick);
+    }
+
+
+    /** Schedule
+     *  --------
+     *  Schedule `value` to be handed to the expiry callback after `delay`, or
+     *  at `wallclock` time `when`.
+     */
+    template <typename Rep, typename Period, typename ... Args>
+    handle schedule_after(chrono::duration<Rep, Period> const & delay,
+                          Args && ... args) {
+        auto const ns = chrono::ceil<chrono::nanoseconds>(delay);
+        u64 ticks = 0;
+        if (ns > chrono::nanoseconds::zero()) {
+            ticks = static_cast<u64>((ns.count() + m_tick.count() - 1)
+                                     / m_tick.count());
+        }
+        return schedule_tick(m_next_tick + ticks,
+                             std::forward<Args>(args)...);
+    }
+
+    template <typename ... Args>
+    handle schedule_at(chrono::nanoseconds when, Args && ... args) {
+        auto const since_origin = when - m_origin;
+        u64 tick = 0;
+        if (since_origin > chrono::nanoseconds::zero()) {
+            tick = static_cast<u64>((since_origin.count() + m_tick.count() - 1)
+                                    / m_tick.count());
+        }
+        return schedule_tick(tick, std::forward<Args>(args)...);
+    }
+
+    /** Deadlines of `never` aren't scheduled, and yield an invalid handle. */
+    template <typename ... Args>
+    handle schedule_at(nonstd::deadline const & d, Args && ... args) {
+        if (d.is_never()) { return handle { }; }
+        return schedule_at(d.when(), std::forward<Args>(args)...);
+    }
+
+    /** Schedule `value` to expire when tick `tick` is processed. Ticks that
+     *  have already passed are treated as the next tick.
+     */
+    template <typename ... Args>
+    handle schedule_tick(u64 tick, Args && ... args) {
+        u32 const index = allocate_node();
+        node & n = m_nodes[index];
+        n.value.construct_value(std::forward<Args>(args)...);
+        n.expiry = n2max(tick, m_next_tick);
+        file(index);
+        m_size += 1;
+        return handle { index, n.generation };
+    }
+
+
+    /** Cancel
+     *  ------
+     *  Drop a pending timer without firing it. Returns false if the handle
+     *  doesn't refer to a pending timer.
+     */
+    bool cancel(handle h) noexcept {
+        if (!pending(h)) { return false; }
+        unlink(h.index);
+        m_nodes[h.index].value.remove_value();
+        release_node(h.index);
+        m_size -= 1;
+        return true;
+    }
+
+    /** Is `h` a timer that has not yet fired or been cancelled? */
+    bool pending(handle h) const noexcept {
+        return h.index < m_nodes.size()
+            && m_nodes[h.index].generation == h.generation
+            && m_nodes[h.index].list != free_list;
+    }
+
+
+    /** Advance
+     *  -------
+     *  Process the next `ticks` ticks, calling `on_expire(T&&)` for every timer
+     *  that comes due. Timers due on the same tick fire in no particular
+     *  order. Returns the number of timers fired.
+     *
+     *  Runs of empty slots are skipped without visiting them, and an empty
+     *  wheel skips straight to the target tick.
+     */
+    template <typename Fn>
+    u64 advance(u64 ticks, Fn && on_expire) {
+        ASSERT_M(!m_advancing, "Timer wheels can't be advanced from within "
+                               "their own expiry callbacks.");
+        m_advancing = true;
+        u64 fired = 0;
+        u64 const target = m_next_tick + ticks;
+
+        while (m_next_tick < target) {
+            if (m_size == 0) {
+                m_next_tick = target;
+                break;
+            }
+
+            u64 const tick = m_next_tick;
+            u32 const slot = static_cast<u32>(tick & slot_mask);
+            if (slot == 0) { cascade(tick); }
+
+            if (m_heads[slot] == nil) {
+                u64 const skip = next_occupied_slot(slot) - slot;
+                m_next_tick = n2min(tick + skip, target);
+                continue;
+            }
+
+            // Pull the slot's timers out before firing any of them, s.t.
+            // timers scheduled by the callbacks land in a later tick, and
+            // timers cancelled by the callbacks are cleanly unlinked.
+            move_list(slot, expiring);
+            m_next_tick = tick + 1;
+            while (m_heads[expiring] != nil) {
+                u32 const index = m_heads[expiring];
+                unlink(index);
+                T value = std::move(m_nodes[index].value.get_value());
+                m_nodes[index].value.remove_value();
+                release_node(index);
+                m_size -= 1;
+                fired += 1;
+                on_expire(std::move(value));
+            }
+        }
+
+        m_advancing = false;
+        return fired;
+    }
+
+    /** Process every tick that's come due by `wallclock` time `now`. */
+    template <typename Fn>
+    u64 advance_to(chrono::nanoseconds now, Fn && on_expire) {
+        if (now < next_tick_time()) { return 0; }
+        u64 const due_tick = static_cast<u64>((now - m_origin).count()
+                                              / m_tick.count());
+        return advance(due_tick + 1 - m_next_tick,
+                       std::forward<Fn>(on_expire));
+    }
+
+    /** Process every tick that's come due, per `wallclock::now()`. */
+    template <typename Fn>
+    u64 poll(Fn && on_expire) {
+        return advance_to(wallclock::now(), std::forward<Fn>(on_expire));
+    }
+
+    /** Sleep until the next tick is due, then `poll`. Suitable as the body of
+     *  a dedicated timer thread's loop.
+     */
+    template <typename Fn>
+    u64 wait_and_poll(Fn && on_expire) {
+        auto const wait = next_tick_time() - wallclock::now();
+        if (wait > chrono::nanoseconds::zero()) { wallclock::delay(wait); }
+        return poll(std::forward<Fn>(on_expire));
+    }
+
+
+private:
+    u32 allocate_node() {
+        if (m_free_head != nil) {
+            u32 const index = m_free_head;
+            m_free_head = m_nodes[index].next;
+            return index;
+        }
+        BREAK_IF(m_nodes.size() >= nil, nonstd::error::insufficient_memory,
+                 "Timer wheel is out of timer handles");
+        m_nodes.push_back(node { 0, nil, nil, 0, free_list, { } });
+        return static_cast<u32>(m_nodes.size() - 1);
+    }
+
+    void release_node(u32 index) noexcept {
+        node & n = m_nodes[index];
+        n.generation += 1;
+        n.list = free_list;
+        n.prev = nil;
+        n.next = m_free_head;
+        m_free_head = index;
+    }
+
+    /** File a node into the slot its expiry maps to from the current tick. */
+    void file(u32 index) noexcept {
+        node & n = m_nodes[index];
+        u64 const delta  = n2min(n.expiry - m_next_tick, max_span - 1);
+        u64 const expiry = m_next_tick + delta;
+        u32 level = 0;
+        while (level + 1 < level_count
+               && delta >= (u64{1} << (slot_bits * (level + 1)))) {
+            level += 1;
+        }
+        u32 const slot = static_cast<u32>((expiry >> (slot_bits * level))
+                                          & slot_mask);
+        link(index, static_cast<u16>(level * slot_count + slot));
+    }
+
+    /** Re-file every timer in the slots of upper levels that line up with
+     *  `tick`. Called when the low bits of the current tick wrap to zero.
+     */
+    void cascade(u64 tick) noexcept {
+        for (u32 level = 1; level < level_count; ++level) {
+            u32 const slot = static_cast<u32>((tick >> (slot_bits * level))
+                                              & slot_mask);
+            u16 const list = static_cast<u16>(level * slot_count + slot);
+            u32 index = m_heads[list];
+            m_heads[list] = nil;
+            while (index != nil) {
+                u32 const next = m_nodes[index].next;
+                file(index);
+                index = next;
+            }
+            if (slot != 0) { break; }
+        }
+    }
+
+    void link(u32 index, u16 list) noexcept {
+        node & n = m_nodes[index];
+        n.list = list;
+        n.prev = nil;
+        n.next = m_heads[list];
+        if (n.next != nil) { m_nodes[n.next].prev = index; }
+        m_heads[list] = index;
+        if (list < slot_count) {
+            m_occupied[list / 64] |= u64{1} << (list % 64);
+        }
+    }
+
+    void unlink(u32 index) noexcept {
+        node & n = m_nodes[index];
+        if (n.prev != nil) { m_nodes[n.prev].next = n.next; }
+        else               { m_heads[n.list] = n.next; }
+        if (n.next != nil) { m_nodes[n.next].prev = n.prev; }
+        if (n.list < slot_count && m_heads[n.list] == nil) {
+            m_occupied[n.list / 64] &= ~(u64{1} << (n.list % 64));
+        }
+    }
+
+    void move_list(u16 from, u16 to) noexcept {
+        ASSERT(m_heads[to] == nil);
+        m_heads[to] = m_heads[from];
+        m_heads[from] = nil;
+        if (from < slot_count) {
+            m_occupied[from / 64] &= ~(u64{1} << (from % 64));
+        }
+        for (u32 i = m_heads[to]; i != nil; i = m_nodes[i].next) {
+            m_nodes[i].list = to;
+        }
+    }
+
+    /** The first occupied level 0 slot at or after `slot`, or `slot_count`. */
+    u32 next_occupied_slot(u32 slot) const noexcept {
+        u32 word = slot / 64;
+        u64 bits = m_occupied[word] & (~u64{0} << (slot % 64));
+        while (bits == 0) {
+            if (++word == m_occupied.size()) { return slot_count; }
+            bits = m_occupied[word];
+        }
+        return word * 64 + count_trailing_zeros(bits);
+    }
+};
+
+} /* namespace nonstd */
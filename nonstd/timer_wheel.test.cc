@@ -0,0 +1,125 @@
+/** Hierarchical Timer Wheel Tests
+ *  ==============================
+ *  GOAL: Validate that timers fire on the tick they're due -- never early, and
+ *  no later than one tick late -- across every level of the wheel, and that
+ *  cancelled timers never fire.
+ */
+
+#include <nonstd/timer_wheel.h>
+#include <platform/testrunner/testrunner.h>
+
+#include <vector>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/chrono.h>
+
+
+namespace nonstd_test::timer_wheel {
+
+using nonstd::timer_wheel;
+using namespace nonstd::literals::chrono_literals;
+
+using wheel_t = nonstd::timer_wheel<u64>;
+
+
+TEST_CASE("Hierarchical Timer Wheel", "[nonstd][timer_wheel]") {
+    wheel_t wheel { 1000_Hz, nonstd::chrono::nanoseconds::zero() };
+
+    SECTION("derives its tick from a frequency") {
+        REQUIRE(wheel.tick_duration() == 1ms);
+        REQUIRE(wheel.empty());
+    }
+
+    SECTION("fires timers on the tick they're due, at every level") {
+        // Expiries straddle each level boundary, and one is past the top.
+        auto const expiries = std::vector<u64> {
+            0, 1, 255, 256, 257, 1000, 65535, 65536, 65537, 100000,
+            (u64{1} << 24) + 3, (u64{1} << 32) + 7,
+        };
+        for (auto e : expiries) { wheel.schedule_tick(e, e); }
+        REQUIRE(wheel.size() == expiries.size());
+
+        std::vector<u64> fired;
+        u64 count = 0;
+        while (!wheel.empty()) {
+            u64 const tick = wheel.current_tick();
+            // Jump straight to the next expiry, then step one tick at a time
+            // through it, checking nothing fires early or late.
+            u64 next = ~u64{0};
+            for (auto e : expiries) {
+                if (e >= tick) { next = n2min(next, e); }
+            }
+            count += wheel.advance(next - tick, [&](u64 e) {
+                fired.push_back(e);
+            });
+            REQUIRE(fired.size() == count);
+            count += wheel.advance(1, [&](u64 e) {
+                REQUIRE(e == next);
+                fired.push_back(e);
+            });
+        }
+        REQUIRE(fired == expiries);
+    }
+
+    SECTION("never fires cancelled timers") {
+        std::vector<wheel_t::handle> handles;
+        for (u64 i = 0; i < 1000; ++i) {
+            handles.push_back(wheel.schedule_tick(i * 7, i));
+        }
+        for (u64 i = 0; i < 1000; i += 2) {
+            REQUIRE(wheel.cancel(handles[i]));
+        }
+        REQUIRE_FALSE(wheel.cancel(handles[0]));
+        REQUIRE_FALSE(wheel.cancel(wheel_t::handle { }));
+        REQUIRE(wheel.size() == 500);
+
+        u64 odd = 0;
+        wheel.advance(7000, [&](u64 i) { odd += (i % 2); });
+        REQUIRE(odd == 500);
+        REQUIRE(wheel.empty());
+        REQUIRE_FALSE(wheel.pending(handles[1]));
+    }
+
+    SECTION("doesn't reuse the handles of fired timers") {
+        auto first = wheel.schedule_tick(5, u64{1});
+        wheel.advance(10, [](u64) { });
+        auto second = wheel.schedule_tick(15, u64{2});
+        REQUIRE(first.index == second.index);
+        REQUIRE_FALSE(wheel.cancel(first));
+        REQUIRE(wheel.pending(second));
+    }
+
+    SECTION("lets expiry callbacks schedule and cancel timers") {
+        auto victim = wheel.schedule_tick(10, u64{99});
+        wheel.schedule_tick(10, u64{0});
+        std::vector<u64> fired;
+        wheel.advance(20, [&](u64 v) {
+            fired.push_back(v);
+            if (v == 0) {
+                wheel.cancel(victim);
+                wheel.schedule_after(0ms, u64{1});
+            }
+        });
+        // The victim may have fired before the canceller (same tick), but the
+        // rescheduled timer must land on a later tick.
+        REQUIRE(fired.back() == 1);
+    }
+
+    SECTION("converts durations and wallclock times to ticks, rounding up") {
+        wheel.schedule_after(1500us, u64{2});
+        wheel.schedule_at(nonstd::chrono::nanoseconds { 3'000'001 }, u64{4});
+
+        std::vector<u64> fired;
+        auto record = [&](u64 v) { fired.push_back(v); };
+        wheel.advance_to(nonstd::chrono::nanoseconds { 1'999'999 }, record);
+        REQUIRE(fired.empty());
+        wheel.advance_to(nonstd::chrono::nanoseconds { 2'000'000 }, record);
+        REQUIRE(fired == std::vector<u64> { 2 });
+        wheel.advance_to(nonstd::chrono::nanoseconds { 3'999'999 }, record);
+        REQUIRE(fired == std::vector<u64> { 2 });
+        wheel.advance_to(nonstd::chrono::nanoseconds { 4'000'000 }, record);
+        REQUIRE(fired == std::vector<u64> { 2, 4 });
+    }
+}
+
+} /* namespace nonstd_test::timer_wheel */
@@ -0,0 +1,42 @@
+/** Time Stamp Counter Clock Benchmarks
+ *  ===================================
+ *  The cost of a read; `steady_clock`, `wallclock::now_fast`, and the raw
+ *  counter, with and without ordering. (Under some hypervisors the counter
+ *  traps, and costs more than `steady_clock`.)
+ */
+
+#include <nonstd/tsc_clock.h>
+#include <nonstd/benchmark.h>
+
+#include <chrono>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/wallclock.h>
+
+
+namespace nonstd_bench::tsc_clock {
+
+using nonstd::do_not_optimize;
+using nonstd::tsc_clock;
+
+
+NONSTD_BENCHMARK("tsc_clock reads") {
+    auto const & calibration = tsc_clock::calibration();
+    fmt::print("invariant: {}, usable: {}, {:.4f} ticks/ns, self-check "
+               "error {}ns\n", calibration.invariant, calibration.usable,
+               calibration.ticks_per_ns, calibration.check_error.count());
+
+    bench.run("steady_clock::now", [] {
+        do_not_optimize(std::chrono::steady_clock::now());
+    });
+    bench.run("wallclock::now_fast", [] {
+        do_not_optimize(nonstd::wallclock::now_fast());
+    });
+    bench.run("tsc_clock::now", [] { do_not_optimize(tsc_clock::now()); });
+    bench.run("tsc_clock::ticks", [] { do_not_optimize(tsc_clock::ticks()); });
+    bench.run("tsc_clock::ticks_ordered", [] {
+        do_not_optimize(tsc_clock::ticks_ordered());
+    });
+}
+
+} /* namespace nonstd_bench::tsc_clock */
@@ -0,0 +1,239 @@
+/** Time Stamp Counter Clock
+ *  ========================
+ *  A clock that reads the CPU's cycle counter directly -- `rdtsc` on x86,
+ *  `cntvct_el0` on ARM64 -- rather than asking the OS. `steady_clock::now()`
+ *  costs 20ns or more even when it's serviced by the vDSO; reading the counter
+ *  costs a handful of cycles, which matters when timestamping every event or
+ *  profiler zone.
+ *
+ *  Raw counter values are in ticks of an unspecified frequency. On first use,
+ *  the counter is calibrated against `steady_clock`; the tick rate is measured
+ *  over a short window (10ms, spent sleeping), and converted times share
+ *  `steady_clock`'s epoch, so `tsc_clock::now()` is directly comparable to
+ *  `wallclock::now()`;
+ *
+ *      u64  start   = nonstd::tsc_clock::ticks();
+ *      ...
+ *      auto elapsed = nonstd::tsc_clock::to_nanoseconds(
+ *                         nonstd::tsc_clock::ticks() - start);
+ *
+ *  The counter is only a clock if it ticks at a constant rate, regardless of
+ *  frequency scaling and sleep states. x86 CPUs advertise that as an
+ *  "invariant TSC" (CPUID 0x80000007, EDX bit 8), which `invariant()` checks.
+ *  ARM64's generic timer is always constant-rate. Calibration finishes with a
+ *  self-check -- it predicts a later `steady_clock` reading from the counter,
+ *  and compares -- and the clock is `usable()` only if the counter is
+ *  invariant and the prediction was close. `drift()` repeats that comparison
+ *  on demand, for long-running processes that want to keep an eye on it.
+ *
+ *  Where the clock isn't usable, everything still works; on other
+ *  architectures `ticks()` is `steady_clock` nanoseconds, and on CPUs without
+ *  an invariant TSC the conversions are merely untrustworthy.
+ *  `wallclock::now_fast()` is the opt-in way to use this clock; it reads the
+ *  counter when it's usable, and falls back to `wallclock::now()` when not.
+ *
+ *  `ticks()` is not ordered with respect to surrounding instructions; the CPU
+ *  may execute it early or late. `ticks_ordered()` (`rdtscp`) waits for all
+ *  prior instructions to complete first, at the cost of a few more cycles.
+ */
+
+#pragma once
+
+#include <thread>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/chrono.h>
+
+#if defined(NONSTD_COMPILER_MSVC)
+#  include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#  include <cpuid.h>
+#  include <x86intrin.h>
+#endif
+
+
+namespace nonstd {
+
+struct tsc_clock {
+    /** Counter-to-`steady_clock` conversion parameters, measured once. A
+     *  counter reading converts to `origin + (ticks - origin_ticks) * mult /
+     *  2^32` nanoseconds.
+     */
+    struct calibration_t {
+        u64                 origin_ticks;
+        chrono::nanoseconds origin;
+        u64                 mult;
+        /** The measured counter rate, in ticks per nanosecond. */
+        f64                 ticks_per_ns;
+        /** How far the self-check's prediction was from `steady_clock`. */
+        chrono::nanoseconds check_error;
+        bool                invariant;
+        bool                usable;
+
+        chrono::nanoseconds to_nanoseconds(u64 ticks) const noexcept {
+            return origin + tsc_clock::_scale(i64(ticks - origin_ticks), mult);
+        }
+    };
+
+    /** Read the counter. */
+    FORCEINLINE static u64 ticks() noexcept {
+#if defined(NONSTD_COMPILER_MSVC) || defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        u64 value;
+        __asm__ __volatile__ ("mrs %0, cntvct_el0" : "=r" (value));
+        return value;
+#else
+        return u64(chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    /** Read the counter once all prior instructions have completed. */
+    FORCEINLINE static u64 ticks_ordered() noexcept {
+#if defined(NONSTD_COMPILER_MSVC) || defined(__x86_64__) || defined(__i386__)
+        unsigned int aux;
+        return __rdtscp(&aux);
+#elif defined(__aarch64__)
+        u64 value;
+        __asm__ __volatile__ ("isb; mrs %0, cntvct_el0" : "=r" (value)
+                                                        : : "memory");
+        return value;
+#else
+        return ticks();
+#endif
+    }
+
+    /** Whether the counter ticks at a constant rate. */
+    static bool invariant() noexcept {
+#if defined(NONSTD_COMPILER_MSVC)
+        int regs[4] = { };
+        __cpuid(regs, 0x80000000);
+        if (u32(regs[0]) < 0x80000007u) { return false; }
+        __cpuid(regs, 0x80000007);
+        return (regs[3] >> 8) & 1;
+#elif defined(__x86_64__) || defined(__i386__)
+        unsigned int eax, ebx, ecx, edx;
+        if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) { return false; }
+        return (edx >> 8) & 1;
+#elif defined(__aarch64__)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /** Measure the counter's rate over `window`, and self-check the result
+     *  over a further quarter of it. Blocks the calling thread for both.
+     */
+    static calibration_t calibrate(
+        chrono::nanoseconds window = chrono::milliseconds { 10 })
+    {
+        calibration_t result { };
+        result.invariant = invariant();
+
+        auto const start = _sample();
+        std::this_thread::sleep_for(window);
+        auto const end = _sample();
+
+        auto const elapsed = end.time - start.time;
+        if (end.ticks <= start.ticks || elapsed.count() <= 0) { return result; }
+        result.ticks_per_ns = f64(end.ticks - start.ticks)
+                            / f64(elapsed.count());
+        result.mult         = u64(f64(u64{1} << 32) / result.ticks_per_ns);
+        result.origin_ticks = end.ticks;
+        result.origin       = end.time;
+
+        std::this_thread::sleep_for(window / 4);
+        auto const check = _sample();
+        result.check_error  = result.to_nanoseconds(check.ticks) - check.time;
+        result.usable       = result.invariant
+                           && _abs(result.check_error)
+                              <= _tolerance(check.time - start.time);
+        return result;
+    }
+
+    /** The calibration in use; measured by the first call. */
+    static calibration_t const & calibration() {
+        static calibration_t const calibrated = calibrate();
+        return calibrated;
+    }
+
+    /** Whether the counter is invariant, and passed its self-check. */
+    static bool usable() { return calibration().usable; }
+
+    /** Convert a difference of counter readings to nanoseconds. */
+    static chrono::nanoseconds to_nanoseconds(i64 ticks) {
+        return _scale(ticks, calibration().mult);
+    }
+
+    /** The current time, on `steady_clock`'s epoch. */
+    static chrono::nanoseconds now() {
+        return calibration().to_nanoseconds(ticks());
+    }
+
+    /** How far `now()` has drifted from `steady_clock`. Compare this against
+     *  a few microseconds, not zero; each comparison is itself only accurate
+     *  to within about the cost of a `steady_clock` read.
+     */
+    static chrono::nanoseconds drift() {
+        auto const sample = _sample();
+        return calibration().to_nanoseconds(sample.ticks) - sample.time;
+    }
+
+private:
+    struct sample_t {
+        u64                 ticks;
+        chrono::nanoseconds time;
+    };
+
+    /** Read `steady_clock` between two counter readings, keeping the tightest
+     *  of several brackets, and pair it with the bracket's midpoint.
+     */
+    static sample_t _sample() noexcept {
+        sample_t best { };
+        u64 best_width = ~u64{0};
+        for (u32 i = 0; i < 8; ++i) {
+            u64  const before = ticks_ordered();
+            auto const time   = chrono::steady_clock::now().time_since_epoch();
+            u64  const after  = ticks_ordered();
+            if (after >= before && after - before < best_width) {
+                best_width = after - before;
+                best       = { before + (after - before) / 2,
+                               chrono::duration_cast<chrono::nanoseconds>(
+                                   time) };
+            }
+        }
+        return best;
+    }
+
+    /** `ticks * mult / 2^32`, without overflowing. */
+    static chrono::nanoseconds _scale(i64 ticks, u64 mult) noexcept {
+        u64 const magnitude = ticks < 0 ? u64(0) - u64(ticks) : u64(ticks);
+#if defined(NONSTD_COMPILER_MSVC) && defined(_M_X64)
+        u64 high;
+        u64 const low = _umul128(magnitude, mult, &high);
+        i64 const ns  = i64(__shiftright128(low, high, 32));
+#elif defined(__SIZEOF_INT128__)
+        i64 const ns  = i64((unsigned __int128)(magnitude) * mult >> 32);
+#else
+        // Without a 128-bit product (e.g. 32-bit targets), from 32-bit
+        // halves; the low partial product is the only one with bits below 32.
+        u64 const a_lo = magnitude & 0xFFFFFFFFu, a_hi = magnitude >> 32;
+        u64 const b_lo = mult      & 0xFFFFFFFFu, b_hi = mult      >> 32;
+        i64 const ns   = i64((a_hi * b_hi << 32) + a_hi * b_lo + a_lo * b_hi
+                             + (a_lo * b_lo >> 32));
+#endif
+        return chrono::nanoseconds { ticks < 0 ? -ns : ns };
+    }
+
+    static chrono::nanoseconds _abs(chrono::nanoseconds value) noexcept {
+        return value < chrono::nanoseconds::zero() ? -value : value;
+    }
+
+    /** The self-check's allowable error over `span`; 20us, plus 500ppm. */
+    static chrono::nanoseconds _tolerance(chrono::nanoseconds span) noexcept {
+        return chrono::microseconds { 20 } + span / 2000;
+    }
+};
+
+} /* namespace nonstd */
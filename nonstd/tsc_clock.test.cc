@@ -0,0 +1,78 @@
+/** Time Stamp Counter Clock Tests
+ *  ==============================
+ *  GOAL: Validate that the counter advances, that its calibration is sane,
+ *  and -- where the counter is usable as a clock -- that its converted times
+ *  track `steady_clock` closely over sleeps.
+ *
+ *  Test machines (VMs, especially) may not have an invariant TSC, so checks
+ *  of accuracy only run where the calibration's self-check passed.
+ */
+
+#include <nonstd/tsc_clock.h>
+#include <platform/testrunner/testrunner.h>
+
+#include <chrono>
+#include <thread>
+
+#include <nonstd/nonstd.h>
+#include <nonstd/chrono.h>
+#include <nonstd/wallclock.h>
+
+
+namespace nonstd_test::tsc_clock {
+
+using nonstd::tsc_clock;
+using namespace nonstd::literals::chrono_literals;
+
+std::chrono::nanoseconds abs(std::chrono::nanoseconds value) {
+    return value < 0ns ? -value : value;
+}
+
+
+TEST_CASE("TSC Clock", "[nonstd][time][tsc_clock]") {
+    SECTION("advance the counter") {
+        u64 const a = tsc_clock::ticks();
+        std::this_thread::sleep_for(1ms);
+        u64 const b = tsc_clock::ticks_ordered();
+        REQUIRE(b > a);
+    }
+
+    SECTION("calibrate to a plausible rate") {
+        auto const & calibration = tsc_clock::calibration();
+        // Anything from 1MHz to 10GHz.
+        REQUIRE(calibration.ticks_per_ns > 0.001);
+        REQUIRE(calibration.ticks_per_ns < 10.0);
+        REQUIRE(calibration.invariant == tsc_clock::invariant());
+        if (!calibration.invariant) { REQUIRE_FALSE(tsc_clock::usable()); }
+    }
+
+    SECTION("convert tick differences linearly, in either direction") {
+        i64 const ticks = 1'000'000;
+        auto const forward  = tsc_clock::to_nanoseconds(ticks);
+        auto const backward = tsc_clock::to_nanoseconds(-ticks);
+        REQUIRE(forward > 0ns);
+        REQUIRE(backward == -forward);
+        REQUIRE(abs(tsc_clock::to_nanoseconds(2 * ticks) - 2 * forward) <= 1ns);
+    }
+
+    SECTION("track steady_clock, when usable") {
+        if (!tsc_clock::usable()) { return; }
+        auto const wall_start = nonstd::wallclock::now();
+        auto const tsc_start  = tsc_clock::now();
+        REQUIRE(abs(tsc_start - wall_start) < 100us);
+
+        std::this_thread::sleep_for(50ms);
+        auto const wall_elapsed = nonstd::wallclock::now() - wall_start;
+        auto const tsc_elapsed  = tsc_clock::now() - tsc_start;
+        REQUIRE(abs(tsc_elapsed - wall_elapsed) < 100us);
+        REQUIRE(abs(tsc_clock::drift()) < 100us);
+    }
+
+    SECTION("back wallclock::now_fast, or fall back to wallclock::now") {
+        auto const fast = nonstd::wallclock::now_fast();
+        auto const slow = nonstd::wallclock::now();
+        REQUIRE(abs(slow - fast) < 1ms);
+    }
+}
+
+} /* namespace nonstd_test::tsc_clock */
@@ -1,13 +1,23 @@
 /** A Clock on the Wall
  *  ===================
  *  Uses nonstd::chrono for all of its timing durations, and std::thread for sleep.
+ *
+ *  `delay` is a plain `sleep_for`, which wakes whenever the scheduler gets
+ *  around to it -- typically 50us to 1ms late on Linux, and up to a timer tick
+ *  (~15ms) on Windows. `delay_until` and `delay_precise` trade some CPU for
+ *  accuracy; they sleep until a margin before the deadline, then spin on
+ *  `cpu_relax()` for the rest. The margin tracks how late recent sleeps woke;
+ *  it rises quickly when the scheduler gets sloppier, and decays slowly when
+ *  it recovers, so the sleep rarely runs past the deadline.
  */
 #pragma once
 
+#include <atomic>
 #include <thread>
 
 #include <nonstd/nonstd.h>
 #include <nonstd/chrono.h>
+#include <nonstd/tsc_clock.h>
 
 
 namespace nonstd {
@@ -27,11 +37,96 @@ struct wallclock {
         return nonstd::chrono::round<nonstd::chrono::seconds>(now());
     }
 
+    /** Query the CPU's time stamp counter, where it's usable as a clock;
+     *  otherwise fall back to `now()`. Readings share `now()`'s epoch, and
+     *  cost a few nanoseconds rather than a few tens of them. The first call
+     *  blocks for ~12ms to calibrate the counter. See tsc_clock.h.
+     */
+    inline static nonstd::chrono::nanoseconds now_fast() {
+        auto const & tsc = nonstd::tsc_clock::calibration();
+        if (tsc.usable) { return tsc.to_nanoseconds(tsc_clock::ticks()); }
+        return now();
+    }
+
     /** Sleep the calling thread for the provided number of milliseconds */
     template <typename Rep, typename Period = std::ratio<1>>
     static void delay(nonstd::chrono::duration<Rep, Period> const & duration) {
         std::this_thread::sleep_for(duration);
     }
+
+    /** Block the calling thread until `now() >= deadline`; sleep for most of
+     *  the wait, and spin for the last `sleep_margin()` of it. Returns
+     *  immediately if the deadline has passed.
+     */
+    static void delay_until(nonstd::chrono::nanoseconds deadline) {
+        auto remaining = deadline - now();
+        auto const margin = sleep_margin();
+        if (remaining > margin) {
+            auto const request = remaining - margin;
+            auto const start   = now();
+            std::this_thread::sleep_for(request);
+            _observe_oversleep((now() - start) - request);
+        }
+        while (now() < deadline) { cpu_relax(); }
+    }
+
+    /** Block the calling thread for `duration`, precisely. See delay_until. */
+    template <typename Rep, typename Period = std::ratio<1>>
+    static void delay_precise(
+        nonstd::chrono::duration<Rep, Period> const & duration)
+    {
+        delay_until(now() + nonstd::chrono::ceil<nonstd::chrono::nanoseconds>(
+                                duration));
+    }
+
+    /** How long before a deadline `delay_until` stops sleeping and spins.
+     *  Calibrated by the first call, which sleeps a few times (~1ms total).
+     */
+    static nonstd::chrono::nanoseconds sleep_margin() {
+        return nonstd::chrono::nanoseconds {
+            _margin().load(std::memory_order_relaxed)
+        };
+    }
+
+private:
+    /** The spin margin, in nanoseconds. Updates are relaxed load/stores; a
+     *  lost update between racing threads only costs one observation.
+     */
+    static std::atomic<i64>& _margin() {
+        static std::atomic<i64> margin { _calibrate_margin() };
+        return margin;
+    }
+
+    static i64 _calibrate_margin() {
+        nonstd::chrono::nanoseconds worst { 0 };
+        for (u32 i = 0; i < 8; ++i) {
+            auto const request = nonstd::chrono::microseconds { 100 };
+            auto const start   = now();
+            std::this_thread::sleep_for(request);
+            worst = n2max(worst, (now() - start) - request);
+        }
+        return _clamp_margin(worst.count() + worst.count() / 4);
+    }
+
+    /** Rise halfway to a later wake-up; decay 1/32nd of the way to an
+     *  earlier one.
+     */
+    static void _observe_oversleep(nonstd::chrono::nanoseconds oversleep) {
+        auto & margin = _margin();
+        i64 const current = margin.load(std::memory_order_relaxed);
+        i64 const target  = oversleep.count() + oversleep.count() / 4;
+        i64 const next    = target > current
+                          ? current + (target - current) / 2
+                          : current - (current - target) / 32;
+        margin.store(_clamp_margin(next), std::memory_order_relaxed);
+    }
+
+    /** Between 10us and 20ms; a single long preemption shouldn't turn every
+     *  following delay into a spin.
+     */
+    static i64 _clamp_margin(i64 ns) {
+        return n2min(n2max(ns, i64 { 10'000 }), i64 { 20'000'000 });
+    }
 };
 
 } /* namespace nonstd */
@@ -36,6 +36,18 @@ TEST_CASE("System timer", "[time][standalone]") {
         auto point_b = wallclock::now();
         REQUIRE(point_a != point_b);
     }
+    SECTION("delays precisely, and never returns early") {
+        REQUIRE(wallclock::sleep_margin() >= 10us);
+        for (auto duration : { 0us, 50us, 500us, 2000us, 4167us }) {
+            auto const start = wallclock::now();
+            wallclock::delay_precise(duration);
+            REQUIRE(wallclock::now() - start >= duration);
+        }
+        auto const deadline = wallclock::now() + 3ms;
+        wallclock::delay_until(deadline);
+        REQUIRE(wallclock::now() >= deadline);
+        wallclock::delay_until(deadline - 1s);
+    }
 }
 
 } /* namespace wallclock */